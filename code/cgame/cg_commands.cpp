@@ -1490,12 +1490,22 @@ void ClientGameCommandManager::SetBaseAndAmplitude(Event *ev, Vector& base, Vect
 //=============
 ClientGameCommandManager::ClientGameCommandManager()
 {
-    m_seed = 0;
+    m_seed                = 0;
+    m_iNumTempModelBlocks = 0;
 
     InitializeTempModels();
     InitializeEmitters();
 }
 
+//=============
+// ~ClientGameCommandManager
+//=============
+ClientGameCommandManager::~ClientGameCommandManager()
+{
+    // Added in OPM
+    ReleaseTempModelBlocks(0);
+}
+
 void ClientGameCommandManager::Print(Event *ev)
 {
     if (current_entity) {
@@ -4291,6 +4301,7 @@ void ClientGameCommandManager::AliasCache(Event *ev)
     char parmbuffer[2048]; // this holds the parameters to be passed into the
                            // alias command
     const char *psMapsBuffer;
+    str         sMapsBuffer;
     bool        bAlwaysLoaded = false;
 
     if (ev->NumArgs() < 2) {
@@ -4309,7 +4320,10 @@ void ClientGameCommandManager::AliasCache(Event *ev)
 
         if (!s.icmp("maps")) {
             i++;
-            psMapsBuffer = (char *)ev->GetToken(i).c_str();
+            // Fixed in OPM
+            //  keep the token alive while it's parsed
+            sMapsBuffer  = ev->GetToken(i);
+            psMapsBuffer = (char *)sMapsBuffer.c_str();
             continue;
         }
 
@@ -4345,6 +4359,7 @@ void ClientGameCommandManager::Alias(Event *ev)
                            // alias command
     qboolean    subtitle;
     const char *psMapsBuffer;
+    str         sMapsBuffer;
     bool        bAlwaysLoaded = false;
 
     if (ev->NumArgs() < 2) {
@@ -4364,7 +4379,10 @@ void ClientGameCommandManager::Alias(Event *ev)
 
         if (!s.icmp("maps")) {
             i++;
-            psMapsBuffer = (char *)ev->GetToken(i).c_str();
+            // Fixed in OPM
+            //  keep the token alive while it's parsed
+            sMapsBuffer  = ev->GetToken(i);
+            psMapsBuffer = (char *)sMapsBuffer.c_str();
             continue;
         }
 
@@ -4506,8 +4524,8 @@ void ClientGameCommandManager::BodyFallSound(Event *ev)
 void ClientGameCommandManager::Client(Event *ev)
 {
     Event      *event;
-    const char *eventname;
-    int         i;
+    str eventname;
+    int i;
 
     // see if it was a dummy command
     if (ev->NumArgs() < 1) {
@@ -5922,7 +5940,7 @@ void ClientGameCommandManager::EventViewKick(Event *ev)
 
 int ClientGameCommandManager::IdForTempModel(const ctempmodel_t *model)
 {
-    int index;
+    int i;
 
     if (model == &m_active_tempmodels) {
         return -1;
@@ -5932,16 +5950,15 @@ int ClientGameCommandManager::IdForTempModel(const ctempmodel_t *model)
         return -2;
     }
 
-    index = model - m_tempmodels;
-    if (index >= MAX_TEMPMODELS) {
-        return -2;
-    }
+    for (i = 0; i < m_iNumTempModelBlocks; i++) {
+        const ctempmodel_t *block = m_tempmodelBlocks[i];
 
-    if (model != &m_tempmodels[index]) {
-        return -2;
+        if (model >= block && model < block + TEMPMODEL_BLOCK_SIZE) {
+            return i * TEMPMODEL_BLOCK_SIZE + (model - block);
+        }
     }
 
-    return model - m_tempmodels;
+    return -2;
 }
 
 ctempmodel_t *ClientGameCommandManager::TempModelForId(int id)
@@ -5954,7 +5971,7 @@ ctempmodel_t *ClientGameCommandManager::TempModelForId(int id)
         return NULL;
     }
 
-    return &m_tempmodels[id];
+    return &m_tempmodelBlocks[id / TEMPMODEL_BLOCK_SIZE][id % TEMPMODEL_BLOCK_SIZE];
 }
 
 int ClientGameCommandManager::IdForSpawnThing(const spawnthing_t *sp)
@@ -6086,12 +6103,32 @@ void ClientGameCommandManager::ArchiveToMemory(MemArchiver& archiver)
         }
     }
 
+    // Added in OPM
+    //  the archive holds the MAX_TEMPMODELS tempmodels of the original layout,
+    //  so exactly these blocks must exist. When reading, all the tempmodels
+    //  are replaced so the others are just released.
+    if (archiver.IsReading()) {
+        ReleaseTempModelBlocks(ARCHIVE_TEMPMODEL_BLOCKS);
+    } else {
+        TrimTempModelBlocks(ARCHIVE_TEMPMODEL_BLOCKS);
+    }
+    AllocateTempModelBlocks(ARCHIVE_TEMPMODEL_BLOCKS);
+
     ArchiveTempModelPointerToMemory(archiver, &m_active_tempmodels.prev);
     ArchiveTempModelPointerToMemory(archiver, &m_active_tempmodels.next);
     ArchiveTempModelPointerToMemory(archiver, &m_free_tempmodels);
 
     for (i = 0; i < MAX_TEMPMODELS; i++) {
-        m_tempmodels[i].ArchiveToMemory(archiver);
+        TempModelForId(i)->ArchiveToMemory(archiver);
+    }
+
+    if (archiver.IsReading()) {
+        ctempmodel_t *model;
+
+        m_iNumActiveTempModels = 0;
+        for (model = m_active_tempmodels.next; model != &m_active_tempmodels; model = model->next) {
+            m_iNumActiveTempModels++;
+        }
     }
 
     if (archiver.IsReading()) {
@@ -252,6 +252,9 @@ public:
     qboolean      addedOnce;
     qboolean      lastEntValid;
     spawnthing_t *m_spawnthing;
+    // Added in OPM
+    //  set when the physics of this frame were run by the physics batch
+    qboolean      physicsBatched;
 
     void (*touchfcn)(ctempmodel_t *ct, trace_t *trace);
 
@@ -271,6 +274,7 @@ inline ctempmodel_t::ctempmodel_t()
     aliveTime             = 0;
     addedOnce             = qfalse;
     lastEntValid          = qfalse;
+    physicsBatched        = qfalse;
 }
 
 enum class vsstypes_t : unsigned char {
@@ -738,13 +742,24 @@ public:
 #define MAX_TEMPMODELS 2048
 #define MAX_BEAMS      4096
 
+// Added in OPM
+//  tempmodels are allocated by blocks, when needed, and cg_max_tempmodels
+//  can go past MAX_TEMPMODELS. Archives keep the MAX_TEMPMODELS records
+//  of the original layout, the tempmodels past them are freed.
+#define MAX_TEMPMODELS_LIMIT     16384
+#define TEMPMODEL_BLOCK_SIZE     256
+#define MAX_TEMPMODEL_BLOCKS     (MAX_TEMPMODELS_LIMIT / TEMPMODEL_BLOCK_SIZE)
+#define ARCHIVE_TEMPMODEL_BLOCKS (MAX_TEMPMODELS / TEMPMODEL_BLOCK_SIZE)
+
 class ClientGameCommandManager : public Listener
 {
 private:
     spawnthing_t              m_localemitter; // local emitter used by animation commands
     ctempmodel_t              m_active_tempmodels;
     ctempmodel_t             *m_free_tempmodels;
-    ctempmodel_t              m_tempmodels[MAX_TEMPMODELS];
+    ctempmodel_t             *m_tempmodelBlocks[MAX_TEMPMODEL_BLOCKS]; // Added in OPM
+    int                       m_iNumTempModelBlocks;                  // Added in OPM
+    int                       m_iNumActiveTempModels;                 // Added in OPM
     cvssource_t               m_active_vsssources;
     cvssource_t              *m_free_vsssources;
     cvssource_t              *m_vsssources;
@@ -887,6 +902,10 @@ private:
     void          SetClampVel(Event *ev);
     void          SetClampVelAxis(Event *ev);
     ctempmodel_t *AllocateTempModel(void);
+    void          AllocateTempModelBlocks(int numBlocks); // Added in OPM
+    void          TrimTempModelBlocks(int numBlocks);     // Added in OPM
+    void          ReleaseTempModelBlocks(int numBlocks);  // Added in OPM
+    void          RunTempModelPhysicsBatch(float scale);  // Added in OPM
     qboolean      TempModelPhysics(ctempmodel_t *p, float ftime, float scale);
     qboolean      TempModelRealtimeEffects(ctempmodel_t *p, float ftime, float scale);
     qboolean      LerpTempModel(refEntity_t *newEnt, ctempmodel_t *p, float frac);
@@ -930,6 +949,7 @@ public:
     CLASS_PROTOTYPE(ClientGameCommandManager);
 
     ClientGameCommandManager();
+    ~ClientGameCommandManager();
     void AddTempModels(void);
     void UpdateEmitter(dtiki_t *tiki, vec3_t axis[3], int entity_number, int parent_number, Vector entity_origin);
     void UpdateBeam(dtiki_t *tiki, int entity_number, spawnthing_t *beamthing);
@@ -947,6 +967,7 @@ public:
     void          SpawnEffect(int count, spawnthing_t *sp);
     void          FreeAllTempModels(void);
     void          FreeSomeTempModels(void);
+    int           NumActiveTempModels(void) const; // Added in OPM
     void          RestartAllEmitters(void);
 
     void InitializeTempModels(void);
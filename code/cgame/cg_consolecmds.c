@@ -510,6 +510,7 @@ static consoleCommand_t commands[] = {
     {"dumpemitter",            &CG_DumpEmitter_f           },
     {"loademitter",            &CG_LoadEmitter_f           },
     {"resetvss",               &CG_ResetVSSSources         },
+    {"tempmodelbench",         &CG_TempModelBench_f        },
     {"getchshader",            &CG_GetCHShader             },
     {"editchshader",           &CG_EditCHShader            },
     {"messagemode",            &CG_MessageMode_f           },
@@ -571,6 +571,7 @@ extern "C" {
 
     void CG_AddTempModels(void);
     void CG_ResetTempModels(void);
+    void CG_TempModelBench_f(void);
 
     void CG_Splash(centity_t *cent);
 
@@ -27,6 +27,14 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "cg_commands.h"
 #include "tiki.h"
 
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#    include <xmmintrin.h>
+#    define TEMPMODEL_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#    include <arm_neon.h>
+#    define TEMPMODEL_NEON
+#endif
+
 cvar_t *cg_showtempmodels;
 cvar_t *cg_max_tempmodels;
 cvar_t *cg_reserve_tempmodels;
@@ -53,11 +61,19 @@ ctempmodel_t *ClientGameCommandManager::AllocateTempModel(void)
 
     p = m_free_tempmodels;
     if (!p) {
-        // no free entities
-        return NULL;
+        if (m_iNumTempModelBlocks >= MAX_TEMPMODEL_BLOCKS) {
+            // no free entities
+            return NULL;
+        }
+
+        // Added in OPM
+        AllocateTempModelBlocks(m_iNumTempModelBlocks + 1);
+        p = m_free_tempmodels;
     }
 
     m_free_tempmodels = m_free_tempmodels->next;
+    m_iNumActiveTempModels++;
+    p->physicsBatched = qfalse;
 
     // link into the active list
     p->next                        = m_active_tempmodels.next;
@@ -91,6 +107,7 @@ void ClientGameCommandManager::FreeTempModel(ctempmodel_t *p)
     // the free list is only singly linked
     p->next           = m_free_tempmodels;
     m_free_tempmodels = p;
+    m_iNumActiveTempModels--;
 
     if (p->m_spawnthing) {
         p->m_spawnthing->numtempmodels--;
@@ -131,18 +148,15 @@ void ClientGameCommandManager::FreeAllTempModels(void)
 //===============
 void ClientGameCommandManager::FreeSomeTempModels(void)
 {
-    ctempmodel_t *model;
-    int           count = 0;
-    unsigned int  i;
-    unsigned int  numToFree;
+    int          count;
+    unsigned int i;
+    unsigned int numToFree;
 
-    if (!m_free_tempmodels) {
+    if (m_iNumActiveTempModels >= MAX_TEMPMODELS_LIMIT) {
         return;
     }
 
-    for (model = m_active_tempmodels.prev; model != &m_active_tempmodels; model = model->prev) {
-        count++;
-    }
+    count = m_iNumActiveTempModels;
 
     if (cg_reserve_tempmodels->integer <= (cg_max_tempmodels->integer - count)) {
         // nothing to free
@@ -207,23 +221,138 @@ void CG_ResetTempModels(void)
     lastTempModelFrameTime = cg.time;
 }
 
+//===============
+// NumActiveTempModels
+//===============
+int ClientGameCommandManager::NumActiveTempModels(void) const
+{
+    return m_iNumActiveTempModels;
+}
+
 //=============
 // InitializeTempModels
 //=============
 void ClientGameCommandManager::InitializeTempModels(void)
 {
-    int i;
-    int numtempmodels = MAX_TEMPMODELS;
+    int i, j;
 
     m_active_tempmodels.next = &m_active_tempmodels;
     m_active_tempmodels.prev = &m_active_tempmodels;
 
-    m_free_tempmodels = &m_tempmodels[0];
+    m_free_tempmodels      = NULL;
+    m_iNumActiveTempModels = 0;
+
+    // Added in OPM
+    //  Keep the blocks that were already allocated,
+    //  the others are allocated when needed
+    for (i = m_iNumTempModelBlocks - 1; i >= 0; i--) {
+        ctempmodel_t *block = m_tempmodelBlocks[i];
+
+        for (j = TEMPMODEL_BLOCK_SIZE - 1; j >= 0; j--) {
+            block[j].next     = m_free_tempmodels;
+            m_free_tempmodels = &block[j];
+        }
+    }
+}
+
+//=============
+// AllocateTempModelBlocks
+//=============
+void ClientGameCommandManager::AllocateTempModelBlocks(int numBlocks)
+{
+    ctempmodel_t *block;
+    int           i;
+
+    if (numBlocks > MAX_TEMPMODEL_BLOCKS) {
+        numBlocks = MAX_TEMPMODEL_BLOCKS;
+    }
+
+    while (m_iNumTempModelBlocks < numBlocks) {
+        // like the static array it replaces, the memory is cleared
+        // before constructing the tempmodels
+        block = static_cast<ctempmodel_t *>(::operator new(sizeof(ctempmodel_t) * TEMPMODEL_BLOCK_SIZE));
+        memset(static_cast<void *>(block), 0, sizeof(ctempmodel_t) * TEMPMODEL_BLOCK_SIZE);
+
+        for (i = 0; i < TEMPMODEL_BLOCK_SIZE; i++) {
+            new (&block[i]) ctempmodel_t();
+        }
+
+        // push the new tempmodels on the free list
+        for (i = 0; i < TEMPMODEL_BLOCK_SIZE - 1; i++) {
+            block[i].next = &block[i + 1];
+        }
+        block[TEMPMODEL_BLOCK_SIZE - 1].next = m_free_tempmodels;
+        m_free_tempmodels                    = &block[0];
+
+        m_tempmodelBlocks[m_iNumTempModelBlocks++] = block;
+    }
+}
+
+//=============
+// TrimTempModelBlocks
+//
+// Free the tempmodels past the first blocks and release those blocks
+//=============
+void ClientGameCommandManager::TrimTempModelBlocks(int numBlocks)
+{
+    ctempmodel_t *p, *next;
+    ctempmodel_t *freeList;
+    int           maxId;
+
+    if (m_iNumTempModelBlocks <= numBlocks) {
+        return;
+    }
+
+    maxId = numBlocks * TEMPMODEL_BLOCK_SIZE;
+
+    for (p = m_active_tempmodels.next; p != &m_active_tempmodels; p = next) {
+        next = p->next;
+
+        if (IdForTempModel(p) >= maxId) {
+            FreeTempModel(p);
+        }
+    }
+
+    // keep the free tempmodels of the remaining blocks,
+    // none of them must point into the released ones
+    freeList = NULL;
+    for (p = m_free_tempmodels; p; p = next) {
+        next = p->next;
 
-    for (i = 0; i < numtempmodels - 1; i++) {
-        m_tempmodels[i].next = &m_tempmodels[i + 1];
+        if (IdForTempModel(p) < maxId) {
+            p->prev  = NULL;
+            p->next  = freeList;
+            freeList = p;
+        }
+    }
+    m_free_tempmodels = freeList;
+
+    ReleaseTempModelBlocks(numBlocks);
+}
+
+//=============
+// ReleaseTempModelBlocks
+//
+// Delete the blocks past the first ones, nothing must use their tempmodels anymore
+//=============
+void ClientGameCommandManager::ReleaseTempModelBlocks(int numBlocks)
+{
+    int i, j;
+
+    if (m_iNumTempModelBlocks <= numBlocks) {
+        return;
+    }
+
+    for (i = numBlocks; i < m_iNumTempModelBlocks; i++) {
+        for (j = 0; j < TEMPMODEL_BLOCK_SIZE; j++) {
+            m_tempmodelBlocks[i][j].~ctempmodel_t();
+        }
+
+        ::operator delete(m_tempmodelBlocks[i]);
+        m_tempmodelBlocks[i] = NULL;
     }
-    m_tempmodels[numtempmodels - 1].next = NULL;
+
+    m_iNumTempModelBlocks = numBlocks;
 }
 
 void ClientGameCommandManager::InitializeTempModelCvars(void)
@@ -236,14 +365,14 @@ void ClientGameCommandManager::InitializeTempModelCvars(void)
 
     cg_effect_physicsrate = cgi.Cvar_Get("cg_effect_physicsrate", "10", CVAR_ARCHIVE);
     cg_max_tempmodels     = cgi.Cvar_Get("cg_max_tempmodels", "1100", CVAR_ARCHIVE);
-    cgi.Cvar_CheckRange(cg_max_tempmodels, 200, MAX_TEMPMODELS, qtrue);
+    cgi.Cvar_CheckRange(cg_max_tempmodels, 200, MAX_TEMPMODELS_LIMIT, qtrue);
 
     cg_reserve_tempmodels = cgi.Cvar_Get("cg_reserve_tempmodels", "200", CVAR_ARCHIVE);
 
-    if (cg_max_tempmodels->integer > MAX_TEMPMODELS) {
+    if (cg_max_tempmodels->integer > MAX_TEMPMODELS_LIMIT) {
         // 2.40 sets the integer value directly rather than calling Cvar_Set()
         //cg_max_tempmodels->integer = MAX_TEMPMODELS
-        cgi.Cvar_Set("cg_max_tempmodels", va("%i", MAX_TEMPMODELS));
+        cgi.Cvar_Set("cg_max_tempmodels", va("%i", MAX_TEMPMODELS_LIMIT));
     }
 
     if (cg_reserve_tempmodels->integer * 5 > cg_max_tempmodels->integer) {
@@ -863,6 +992,257 @@ qboolean ClientGameCommandManager::LerpTempModel(refEntity_t *newEnt, ctempmodel
     return true;
 }
 
+/*
+====================
+Tempmodel physics batch
+
+Added in OPM
+
+Most tempmodels (smoke, sparks, debris without collision...) only integrate
+their velocity and acceleration. The physics-only fields of those are gathered
+into a structure of arrays and integrated 4 at a time, the other tempmodels
+still go through TempModelPhysics.
+====================
+*/
+
+#define TEMPMODEL_PHYSICS_BATCH 256
+
+struct tempModelPhysicsBatch_t {
+    ctempmodel_t *models[TEMPMODEL_PHYSICS_BATCH];
+    alignas(16) float origin[3][TEMPMODEL_PHYSICS_BATCH];
+    alignas(16) float velocity[3][TEMPMODEL_PHYSICS_BATCH];
+    alignas(16) float accel[3][TEMPMODEL_PHYSICS_BATCH];
+    alignas(16) float moveTime[TEMPMODEL_PHYSICS_BATCH];  // ftime if the tempmodel moves, 0 otherwise
+    alignas(16) float accelTime[TEMPMODEL_PHYSICS_BATCH]; // ftime if the tempmodel accelerates, 0 otherwise
+    alignas(16) float friction[TEMPMODEL_PHYSICS_BATCH];  // velocity multiplier
+    int count;
+};
+
+static tempModelPhysicsBatch_t tempModelBatch;
+
+// physics steps of the last AddTempModels call, for tempmodelbench
+static int numBatchedPhysics;
+static int numScalarPhysics;
+
+// set by tempmodelbench so nothing is added to the scene
+static qboolean tempModelBenchRunning = qfalse;
+
+//===============
+// CG_TempModelPhysicsBatchable
+//
+// Returns true if the physics of the tempmodel are a plain
+// integration (see TempModelPhysics)
+//===============
+static qboolean CG_TempModelPhysicsBatchable(const ctempmodel_t *p)
+{
+    if (!p->lastEntValid) {
+        return qfalse;
+    }
+
+    if (p->cgd.flags & (T_SWARM | T_PARENTLINK | T_HARDLINK | T_ALIGN | T_RANDOMROLL | T_ANGLES | T_COLLISION)) {
+        return qfalse;
+    }
+
+    if (p->cgd.flags2 & (T2_WATERONLY | T2_AMOVE | T2_CLAMP_VEL | T2_CLAMP_VEL_AXIS | T2_WIND_AFFECT)) {
+        return qfalse;
+    }
+
+    return qtrue;
+}
+
+//===============
+// CG_IntegrateTempModelBatch
+//===============
+static void CG_IntegrateTempModelBatch(tempModelPhysicsBatch_t& batch, float scale)
+{
+    int i, j;
+    int count;
+
+    // pad to a multiple of 4 with values that don't move
+    count = (batch.count + 3) & ~3;
+    for (i = batch.count; i < count; i++) {
+        for (j = 0; j < 3; j++) {
+            batch.origin[j][i]   = 0;
+            batch.velocity[j][i] = 0;
+            batch.accel[j][i]    = 0;
+        }
+
+        batch.moveTime[i]  = 0;
+        batch.accelTime[i] = 0;
+        batch.friction[i]  = 1;
+    }
+
+    // same operations, in the same order as TempModelPhysics:
+    //  origin += (velocity * ftime) * scale
+    //  velocity = (velocity + accel * ftime) * friction
+#if defined(TEMPMODEL_SSE)
+    const __m128 vScale = _mm_set1_ps(scale);
+
+    for (i = 0; i < count; i += 4) {
+        const __m128 moveTime  = _mm_load_ps(&batch.moveTime[i]);
+        const __m128 accelTime = _mm_load_ps(&batch.accelTime[i]);
+        const __m128 friction  = _mm_load_ps(&batch.friction[i]);
+
+        for (j = 0; j < 3; j++) {
+            __m128 origin   = _mm_load_ps(&batch.origin[j][i]);
+            __m128 velocity = _mm_load_ps(&batch.velocity[j][i]);
+            __m128 accel    = _mm_load_ps(&batch.accel[j][i]);
+
+            origin   = _mm_add_ps(origin, _mm_mul_ps(_mm_mul_ps(velocity, moveTime), vScale));
+            velocity = _mm_mul_ps(_mm_add_ps(velocity, _mm_mul_ps(accel, accelTime)), friction);
+
+            _mm_store_ps(&batch.origin[j][i], origin);
+            _mm_store_ps(&batch.velocity[j][i], velocity);
+        }
+    }
+#elif defined(TEMPMODEL_NEON)
+    const float32x4_t vScale = vdupq_n_f32(scale);
+
+    for (i = 0; i < count; i += 4) {
+        const float32x4_t moveTime  = vld1q_f32(&batch.moveTime[i]);
+        const float32x4_t accelTime = vld1q_f32(&batch.accelTime[i]);
+        const float32x4_t friction  = vld1q_f32(&batch.friction[i]);
+
+        for (j = 0; j < 3; j++) {
+            float32x4_t origin   = vld1q_f32(&batch.origin[j][i]);
+            float32x4_t velocity = vld1q_f32(&batch.velocity[j][i]);
+            float32x4_t accel    = vld1q_f32(&batch.accel[j][i]);
+
+            origin   = vaddq_f32(origin, vmulq_f32(vmulq_f32(velocity, moveTime), vScale));
+            velocity = vmulq_f32(vaddq_f32(velocity, vmulq_f32(accel, accelTime)), friction);
+
+            vst1q_f32(&batch.origin[j][i], origin);
+            vst1q_f32(&batch.velocity[j][i], velocity);
+        }
+    }
+#else
+    for (j = 0; j < 3; j++) {
+        for (i = 0; i < count; i++) {
+            batch.origin[j][i] += batch.velocity[j][i] * batch.moveTime[i] * scale;
+            batch.velocity[j][i] = (batch.velocity[j][i] + batch.accel[j][i] * batch.accelTime[i]) * batch.friction[i];
+        }
+    }
+#endif
+}
+
+//===============
+// CG_FlushTempModelBatch
+//===============
+static void CG_FlushTempModelBatch(tempModelPhysicsBatch_t& batch, float scale)
+{
+    ctempmodel_t *p;
+    int           i;
+
+    if (!batch.count) {
+        return;
+    }
+
+    CG_IntegrateTempModelBatch(batch, scale);
+
+    for (i = 0; i < batch.count; i++) {
+        p = batch.models[i];
+
+        VectorCopy(p->ent.origin, p->lastEnt.origin);
+        AxisCopy(p->ent.axis, p->lastEnt.axis);
+
+        p->cgd.oldorigin = p->cgd.origin;
+        p->cgd.origin    = Vector(batch.origin[0][i], batch.origin[1][i], batch.origin[2][i]);
+        p->cgd.velocity  = Vector(batch.velocity[0][i], batch.velocity[1][i], batch.velocity[2][i]);
+
+        p->cgd.angles[0] = AngleMod(p->cgd.angles[0]);
+        p->cgd.angles[1] = AngleMod(p->cgd.angles[1]);
+        p->cgd.angles[2] = AngleMod(p->cgd.angles[2]);
+
+        VectorCopy(p->cgd.origin, p->ent.origin);
+
+        p->lastPhysicsTime = cg.time;
+        p->physicsBatched  = qtrue;
+    }
+
+    numBatchedPhysics += batch.count;
+    batch.count = 0;
+}
+
+//===============
+// RunTempModelPhysicsBatch
+//
+// Runs the physics of the batchable tempmodels whose physics are due
+// this frame, AddTempModels then skips them
+//===============
+void ClientGameCommandManager::RunTempModelPhysicsBatch(float scale)
+{
+    tempModelPhysicsBatch_t& batch = tempModelBatch;
+    ctempmodel_t            *p;
+    int                      mstime;
+    int                      physics_rate;
+    float                    ftime;
+    int                      i;
+
+    batch.count = 0;
+
+    for (p = m_active_tempmodels.prev; p != &m_active_tempmodels; p = p->prev) {
+        if (!p->lastPhysicsTime || !CG_TempModelPhysicsBatchable(p)) {
+            continue;
+        }
+
+        if ((p->cgd.flags & T_DETAIL) && !cg_detail->integer) {
+            // will be freed
+            continue;
+        }
+
+        // same timing as AddTempModels
+        mstime       = cg.time - p->lastPhysicsTime;
+        physics_rate = 1000 / p->cgd.physicsRate;
+
+        if (mstime > physics_rate * 2) {
+            mstime = physics_rate;
+        }
+
+        if ((mstime < physics_rate) && !(p->cgd.flags2 & T2_PHYSICS_EVERYFRAME)) {
+            continue;
+        }
+
+        ftime = mstime / 1000.0f;
+        i     = batch.count;
+
+        batch.models[i]      = p;
+        batch.origin[0][i]   = p->cgd.origin[0];
+        batch.origin[1][i]   = p->cgd.origin[1];
+        batch.origin[2][i]   = p->cgd.origin[2];
+        batch.velocity[0][i] = p->cgd.velocity[0];
+        batch.velocity[1][i] = p->cgd.velocity[1];
+        batch.velocity[2][i] = p->cgd.velocity[2];
+
+        if (p->cgd.flags2 & T2_ACCEL) {
+            batch.accel[0][i]  = p->cgd.accel[0];
+            batch.accel[1][i]  = p->cgd.accel[1];
+            batch.accel[2][i]  = p->cgd.accel[2];
+            batch.accelTime[i] = ftime;
+        } else {
+            batch.accel[0][i]  = 0;
+            batch.accel[1][i]  = 0;
+            batch.accel[2][i]  = 0;
+            batch.accelTime[i] = 0;
+        }
+
+        batch.moveTime[i] = (p->cgd.flags2 & (T2_MOVE | T2_ACCEL)) ? ftime : 0;
+
+        if (p->cgd.flags2 & T2_FRICTION) {
+            const float fFriction = 1.0f - ftime * p->cgd.friction;
+            batch.friction[i]     = fFriction > 0.0f ? fFriction : 0.0f;
+        } else {
+            batch.friction[i] = 1.0f;
+        }
+
+        batch.count++;
+        if (batch.count == TEMPMODEL_PHYSICS_BATCH) {
+            CG_FlushTempModelBatch(batch, scale);
+        }
+    }
+
+    CG_FlushTempModelBatch(batch, scale);
+}
+
 //===============
 // CG_AddTempModels
 //===============
@@ -929,6 +1309,13 @@ void ClientGameCommandManager::AddTempModels(void)
         scale = current_entity->scale;
     }
 
+    numBatchedPhysics = 0;
+    numScalarPhysics  = 0;
+
+    // Added in OPM
+    //  Run the simple physics of this frame all at once
+    RunTempModelPhysicsBatch(scale);
+
     // Go through all the temp models and run the physics if necessary,
     // then add them to the ref
     old_ent  = current_entity;
@@ -963,9 +1350,14 @@ void ClientGameCommandManager::AddTempModels(void)
                 mstime = physics_rate;
             }
 
-            if ((mstime >= physics_rate) || (p->cgd.flags2 & T2_PHYSICS_EVERYFRAME)) {
+            if (p->physicsBatched) {
+                // Added in OPM
+                //  already done by RunTempModelPhysicsBatch
+                p->physicsBatched = qfalse;
+            } else if ((mstime >= physics_rate) || (p->cgd.flags2 & T2_PHYSICS_EVERYFRAME)) {
                 ftime = mstime / 1000.0f;
                 ret   = TempModelPhysics(p, ftime, scale);
+                numScalarPhysics++;
 
                 if (!ret) {
                     FreeTempModel(p);
@@ -1002,6 +1394,7 @@ void ClientGameCommandManager::AddTempModels(void)
             t = physics_rate / 1000.0f;
 
             ret = TempModelPhysics(p, t, scale);
+            numScalarPhysics++;
             if (!ret) {
                 FreeTempModel(p);
                 continue;
@@ -1062,7 +1455,10 @@ void ClientGameCommandManager::AddTempModels(void)
         newEnt.radius = 4.0;
 
         // Add to the ref
-        if (p->cgd.flags & T_DLIGHT) {
+        if (tempModelBenchRunning) {
+            // Added in OPM
+            //  tempmodelbench only measures the update
+        } else if (p->cgd.flags & T_DLIGHT) {
             // Tempmodel is a Dynamic Light
             cgi.R_AddLightToScene(
                 p->cgd.origin,
@@ -1599,3 +1995,123 @@ void ClientGameCommandManager::SpawnTempModel(int mcount)
         }
     }
 }
+
+//===============
+// CG_TempModelBench_f
+//
+// Added in OPM
+// Spawns the effects of a TIKI from several emitters in front of the view
+// and measures the update of the tempmodels, without rendering them
+//===============
+void CG_TempModelBench_f(void)
+{
+    dtiki_t    *tiki;
+    refEntity_t ent;
+    int         numEmitters;
+    int         numFrames;
+    int         anim;
+    int         oldTime;
+    int         frame;
+    int         i;
+    int         peakCount;
+    int         totalCount;
+    int         totalBatched;
+    int         totalScalar;
+    double      totalMsec;
+    double      worstMsec;
+
+    if (cgi.Argc() < 2) {
+        cgi.Printf("Usage: tempmodelbench <tiki> [emitters] [frames]\n");
+        cgi.Printf("Spawns the effect from [emitters] (default 32) origins every 10 frames and\n");
+        cgi.Printf("times [frames] (default 300) tempmodel updates of 16 ms. All tempmodels are freed.\n");
+        return;
+    }
+
+    tiki = cgi.R_Model_GetHandle(cgi.R_RegisterModel(cgi.Argv(1)));
+    if (!tiki) {
+        cgi.Printf("Couldn't load '%s'\n", cgi.Argv(1));
+        return;
+    }
+
+    numEmitters = cgi.Argc() > 2 ? atoi(cgi.Argv(2)) : 32;
+    numFrames   = cgi.Argc() > 3 ? atoi(cgi.Argv(3)) : 300;
+    numEmitters = Q_max(numEmitters, 1);
+    numFrames   = Q_max(numFrames, 1);
+
+    anim = cgi.Anim_NumForName(tiki, "idle");
+    if (anim < 0) {
+        anim = 0;
+    }
+
+    oldTime      = cg.time;
+    peakCount    = 0;
+    totalCount   = 0;
+    totalBatched = 0;
+    totalScalar  = 0;
+    totalMsec    = 0;
+    worstMsec    = 0;
+
+    commandManager.ResetTempModels();
+    tempModelBenchRunning  = qtrue;
+    lastTempModelFrameTime = cg.time;
+
+    for (frame = 0; frame < numFrames; frame++) {
+        qctime_t start;
+        double   msec;
+
+        cg.time += 16;
+
+        if (!(frame % 10)) {
+            for (i = 0; i < numEmitters; i++) {
+                memset(&ent, 0, sizeof(ent));
+                ent.tiki                = tiki;
+                ent.scale               = 1.0f;
+                ent.entityNumber        = ENTITYNUM_NONE;
+                ent.shaderRGBA[3]       = 255;
+                ent.frameInfo[0].index  = anim;
+                ent.frameInfo[0].weight = 1.0f;
+                AxisCopy(cg.refdef.viewaxis, ent.axis);
+
+                // spread the emitters on a grid in front of the view
+                VectorMA(cg.refdef.vieworg, 256, cg.refdef.viewaxis[0], ent.origin);
+                VectorMA(ent.origin, ((i % 8) - 3.5f) * 48, cg.refdef.viewaxis[1], ent.origin);
+                VectorMA(ent.origin, ((i / 8) % 8 - 3.5f) * 48, cg.refdef.viewaxis[2], ent.origin);
+
+                CG_ProcessInitCommands(tiki, &ent);
+                CG_ProcessEntityCommands(TIKI_FRAME_ENTRY, anim, -1, &ent, NULL);
+                CG_ProcessEntityCommands(0, anim, -1, &ent, NULL);
+            }
+        }
+
+        start = qcclock_t::now();
+        commandManager.AddTempModels();
+        msec = std::chrono::duration<double, std::milli>(qcclock_t::now() - start).count();
+
+        totalMsec += msec;
+        worstMsec = Q_max(worstMsec, msec);
+        totalCount += commandManager.NumActiveTempModels();
+        peakCount = Q_max(peakCount, commandManager.NumActiveTempModels());
+        totalBatched += numBatchedPhysics;
+        totalScalar += numScalarPhysics;
+    }
+
+    tempModelBenchRunning = qfalse;
+    cg.time               = oldTime;
+    CG_ResetTempModels();
+
+    cgi.Printf(
+        "%s: %d emitters, %d frames, %.1f tempmodels on average, %d at most\n",
+        cgi.Argv(1),
+        numEmitters,
+        numFrames,
+        (float)totalCount / numFrames,
+        peakCount
+    );
+    cgi.Printf(
+        "update: %.3f ms per frame, %.3f ms worst, %d batched and %d scalar physics steps\n",
+        totalMsec / numFrames,
+        worstMsec,
+        totalBatched,
+        totalScalar
+    );
+}
@@ -52,6 +52,9 @@ typedef struct snd_stream_s
 	int length;
 	int pos;
 	void *ptr;
+	// Added in OPM
+	//  Set while the stream is decoded ahead by the stream thread
+	struct snd_async_stream_s *async;
 } snd_stream_t;
 
 // Codec functions
@@ -80,6 +83,13 @@ snd_stream_t *S_CodecOpenStream(const char *filename);
 void S_CodecCloseStream(snd_stream_t *stream);
 int S_CodecReadStream(snd_stream_t *stream, int bytes, void *buffer);
 
+// Added in OPM
+//  Asynchronous streams (snd_codec_async.cpp), decoded ahead on a thread.
+//  Read and closed with S_CodecReadStream and S_CodecCloseStream.
+void S_CodecInitAsync(void);
+void S_CodecShutdownAsync(void);
+snd_stream_t *S_CodecOpenStreamAsync(const char *filename);
+
 // Util functions (used by codecs)
 snd_stream_t *S_CodecUtilOpen(const char *filename, snd_codec_t *codec);
 void S_CodecUtilClose(snd_stream_t **stream);
@@ -107,6 +117,7 @@ void* S_MP3_CodecLoad(const char* filename, snd_info_t * info);
 snd_stream_t * S_MP3_CodecOpenStream(const char* filename);
 void S_MP3_CodecCloseStream(snd_stream_t * stream);
 int S_MP3_CodecReadStream(snd_stream_t * stream, int bytes, void* buffer);
+void* S_MP3_DecodeMemory(const byte* data, int length, snd_info_t* info);
 #endif // USE_CODEC_MP3
 
 // Ogg Opus codec
@@ -0,0 +1,460 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// snd_codec_async.cpp: Decodes streams ahead of playback on a worker thread
+//
+// An asynchronous stream keeps its real codec but gets the async codec,
+// so S_CodecReadStream reads from a ring buffer the worker keeps filled
+// and S_CodecCloseStream detaches it from the worker.
+// Opening and closing the stream (filesystem, zone) stay on the main thread,
+// the worker only calls the read function of the codec.
+//
+
+#include "client.h"
+#include "snd_codec.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// bytes decoded by the worker at once
+#define STREAM_DECODE_CHUNK 16384
+// reads are clamped to the ring size, it must hold the biggest streamed buffer
+#define STREAM_MIN_RING     65536
+
+typedef struct snd_async_stream_s {
+    snd_stream_t *stream;
+    snd_codec_t  *codec; // real codec of the stream
+    byte         *ring;
+    int           ringSize;
+    int           readPos;
+    int           available;
+    int           frameSize;
+    int           totalRead;
+    int           underruns;
+    bool          eof;
+    bool          busy; // being decoded by the worker
+
+    struct snd_async_stream_s *next;
+} snd_async_stream_t;
+
+static int  S_Async_CodecReadStream(snd_stream_t *stream, int bytes, void *buffer);
+static void S_Async_CodecCloseStream(snd_stream_t *stream);
+
+static snd_codec_t async_codec = {(char *)"async", NULL, NULL, S_Async_CodecReadStream, S_Async_CodecCloseStream, NULL};
+
+static cvar_t *s_streamLookahead;
+
+struct streamDecodeState_t {
+    std::mutex              mutex;
+    std::condition_variable wakeWorker;
+    std::condition_variable dataReady;
+    std::thread             worker;
+    snd_async_stream_t     *streams;
+    bool                    running;
+    int                     underruns;
+    byte                    decodeBuffer[STREAM_DECODE_CHUNK];
+};
+
+// allocated on first use so no thread is left to destroy at exit
+static streamDecodeState_t *s_streamDecode;
+
+/*
+==============
+S_Async_PickStream
+
+Returns the stream with the least buffered data that has room for a chunk
+==============
+*/
+static snd_async_stream_t *S_Async_PickStream()
+{
+    snd_async_stream_t *async;
+    snd_async_stream_t *best = NULL;
+
+    for (async = s_streamDecode->streams; async; async = async->next) {
+        if (async->eof || async->ringSize - async->available < async->frameSize) {
+            continue;
+        }
+
+        if (!best || async->available < best->available) {
+            best = async;
+        }
+    }
+
+    return best;
+}
+
+/*
+==============
+S_Async_Worker
+==============
+*/
+static void S_Async_Worker(streamDecodeState_t *state)
+{
+    std::unique_lock<std::mutex> lock(state->mutex);
+
+    while (state->running) {
+        snd_async_stream_t *async;
+        int                 bytes;
+        int                 writePos;
+        int                 part;
+
+        async = S_Async_PickStream();
+        if (!async) {
+            state->wakeWorker.wait(lock);
+            continue;
+        }
+
+        bytes = Q_min(async->ringSize - async->available, STREAM_DECODE_CHUNK);
+        bytes -= bytes % async->frameSize;
+        async->busy = true;
+
+        lock.unlock();
+        bytes = async->codec->read(async->stream, bytes, state->decodeBuffer);
+        lock.lock();
+
+        async->busy = false;
+
+        if (bytes <= 0) {
+            async->eof = true;
+        } else {
+            writePos = (async->readPos + async->available) % async->ringSize;
+            part     = Q_min(bytes, async->ringSize - writePos);
+
+            memcpy(async->ring + writePos, state->decodeBuffer, part);
+            memcpy(async->ring, state->decodeBuffer + part, bytes - part);
+            async->available += bytes;
+        }
+
+        state->dataReady.notify_all();
+    }
+}
+
+/*
+==============
+S_CodecOpenStreamAsync
+==============
+*/
+snd_stream_t *S_CodecOpenStreamAsync(const char *filename)
+{
+    snd_stream_t       *stream;
+    snd_async_stream_t *async;
+
+    stream = S_CodecOpenStream(filename);
+    if (!stream) {
+        return NULL;
+    }
+
+    if (!s_streamLookahead || s_streamLookahead->integer <= 0 || !stream->info.rate || stream->info.width <= 0
+        || stream->info.channels <= 0) {
+        // decode on demand
+        return stream;
+    }
+
+    if (!s_streamDecode) {
+        s_streamDecode            = new streamDecodeState_t;
+        s_streamDecode->streams   = NULL;
+        s_streamDecode->running   = false;
+        s_streamDecode->underruns = 0;
+    }
+
+    if (!s_streamDecode->running) {
+        s_streamDecode->running = true;
+        s_streamDecode->worker  = std::thread(S_Async_Worker, s_streamDecode);
+    }
+
+    async            = (snd_async_stream_t *)Z_Malloc(sizeof(snd_async_stream_t));
+    async->stream    = stream;
+    async->codec     = stream->codec;
+    async->frameSize = (int)(stream->info.width * stream->info.channels);
+    async->ringSize  = (int)((int64_t)s_streamLookahead->integer * stream->info.rate / 1000) * async->frameSize;
+    async->ringSize  = Q_max(async->ringSize, STREAM_MIN_RING);
+    async->ringSize -= async->ringSize % async->frameSize;
+    async->ring      = (byte *)Z_Malloc(async->ringSize);
+
+    stream->async = async;
+    stream->codec = &async_codec;
+
+    std::lock_guard<std::mutex> lock(s_streamDecode->mutex);
+
+    async->next             = s_streamDecode->streams;
+    s_streamDecode->streams = async;
+    s_streamDecode->wakeWorker.notify_one();
+
+    return stream;
+}
+
+/*
+==============
+S_Async_CodecReadStream
+==============
+*/
+static int S_Async_CodecReadStream(snd_stream_t *stream, int bytes, void *buffer)
+{
+    snd_async_stream_t          *async = stream->async;
+    std::unique_lock<std::mutex> lock(s_streamDecode->mutex);
+    int                          part;
+
+    bytes = Q_min(bytes, async->ringSize);
+    bytes -= bytes % async->frameSize;
+
+    if (async->available < bytes && !async->eof) {
+        if (async->totalRead) {
+            // the first read is expected to wait for the stream to start
+            async->underruns++;
+            s_streamDecode->underruns++;
+        }
+
+        s_streamDecode->wakeWorker.notify_one();
+
+        while (async->available < bytes && !async->eof) {
+            s_streamDecode->dataReady.wait(lock);
+        }
+    }
+
+    bytes = Q_min(bytes, async->available);
+    part  = Q_min(bytes, async->ringSize - async->readPos);
+
+    memcpy(buffer, async->ring + async->readPos, part);
+    memcpy((byte *)buffer + part, async->ring, bytes - part);
+
+    async->readPos = (async->readPos + bytes) % async->ringSize;
+    async->available -= bytes;
+    async->totalRead += bytes;
+
+    s_streamDecode->wakeWorker.notify_one();
+
+    return bytes;
+}
+
+/*
+==============
+S_Async_CodecCloseStream
+==============
+*/
+static void S_Async_CodecCloseStream(snd_stream_t *stream)
+{
+    snd_async_stream_t  *async = stream->async;
+    snd_async_stream_t **prev;
+
+    {
+        std::unique_lock<std::mutex> lock(s_streamDecode->mutex);
+
+        while (async->busy) {
+            s_streamDecode->dataReady.wait(lock);
+        }
+
+        for (prev = &s_streamDecode->streams; *prev; prev = &(*prev)->next) {
+            if (*prev == async) {
+                *prev = async->next;
+                break;
+            }
+        }
+    }
+
+    stream->codec = async->codec;
+    stream->async = NULL;
+
+    Z_Free(async->ring);
+    Z_Free(async);
+
+    S_CodecCloseStream(stream);
+}
+
+/*
+==============
+S_StreamInfo_f
+==============
+*/
+static void S_StreamInfo_f()
+{
+    snd_async_stream_t *async;
+    int                 numStreams = 0;
+
+    Com_Printf("Stream lookahead: %d ms\n", s_streamLookahead->integer);
+
+    if (!s_streamDecode) {
+        Com_Printf("No asynchronous stream was opened\n");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(s_streamDecode->mutex);
+
+    for (async = s_streamDecode->streams; async; async = async->next) {
+        Com_Printf(
+            "%6d ms buffered, %4d underruns%s\n",
+            (int)((int64_t)async->available * 1000 / async->frameSize / async->stream->info.rate),
+            async->underruns,
+            async->eof ? ", decoded" : ""
+        );
+        numStreams++;
+    }
+
+    Com_Printf("%d streams, %d underruns in total\n", numStreams, s_streamDecode->underruns);
+}
+
+/*
+==============
+S_StreamTest_f
+
+Decodes a file both on demand and through the worker and compares the output.
+MP3 dithering is random so a difference of a few units is expected there.
+==============
+*/
+static void S_StreamTest_f()
+{
+    snd_stream_t *streams[2];
+    byte         *buffers[2];
+    const char   *filename;
+    int           bytes[2];
+    int           total;
+    int           maxDiff;
+    int           underruns;
+    int           start;
+    int           i;
+
+    if (Cmd_Argc() < 2) {
+        Com_Printf("Usage: streamtest <sound file>\n");
+        return;
+    }
+
+    filename = Cmd_Argv(1);
+
+    streams[0] = S_CodecOpenStream(filename);
+    if (!streams[0]) {
+        Com_Printf("Couldn't open %s\n", filename);
+        return;
+    }
+
+    streams[1] = S_CodecOpenStreamAsync(filename);
+    if (!streams[1] || !streams[1]->async) {
+        Com_Printf("Couldn't open %s asynchronously (s_streamLookahead is %d)\n", filename, s_streamLookahead->integer);
+        S_CodecCloseStream(streams[0]);
+        if (streams[1]) {
+            S_CodecCloseStream(streams[1]);
+        }
+        return;
+    }
+
+    buffers[0] = (byte *)Z_Malloc(STREAM_DECODE_CHUNK);
+    buffers[1] = (byte *)Z_Malloc(STREAM_DECODE_CHUNK);
+    underruns  = s_streamDecode->underruns;
+    total      = 0;
+    maxDiff    = 0;
+    start      = Sys_Milliseconds();
+
+    for (;;) {
+        bytes[0] = S_CodecReadStream(streams[0], STREAM_DECODE_CHUNK, buffers[0]);
+        bytes[1] = S_CodecReadStream(streams[1], STREAM_DECODE_CHUNK, buffers[1]);
+
+        if (bytes[0] != bytes[1]) {
+            Com_Printf(S_COLOR_RED "Length mismatch after %d bytes (%d vs %d)\n", total, bytes[0], bytes[1]);
+            maxDiff = -1;
+            break;
+        }
+
+        if (bytes[0] <= 0) {
+            break;
+        }
+
+        if (streams[0]->info.width == 2) {
+            const short *a = (const short *)buffers[0];
+            const short *b = (const short *)buffers[1];
+
+            for (i = 0; i < bytes[0] / 2; i++) {
+                maxDiff = Q_max(maxDiff, abs(a[i] - b[i]));
+            }
+        } else if (memcmp(buffers[0], buffers[1], bytes[0])) {
+            maxDiff = Q_max(maxDiff, 1);
+        }
+
+        total += bytes[0];
+    }
+
+    Com_Printf(
+        "%s: %d bytes, %d Hz, %d channels, max sample difference %d, %d underruns, %d ms\n",
+        filename,
+        total,
+        streams[0]->info.rate,
+        streams[0]->info.channels,
+        maxDiff,
+        s_streamDecode->underruns - underruns,
+        Sys_Milliseconds() - start
+    );
+
+    Z_Free(buffers[0]);
+    Z_Free(buffers[1]);
+    S_CodecCloseStream(streams[0]);
+    S_CodecCloseStream(streams[1]);
+}
+
+/*
+==============
+S_CodecInitAsync
+==============
+*/
+void S_CodecInitAsync()
+{
+    s_streamLookahead = Cvar_Get("s_streamLookahead", "500", CVAR_ARCHIVE);
+    Cvar_SetDescription(s_streamLookahead, "Milliseconds of streamed sounds decoded ahead on a thread, 0 to decode on demand");
+
+    Cmd_AddCommand("streaminfo", S_StreamInfo_f);
+    Cmd_AddCommand("streamtest", S_StreamTest_f);
+}
+
+/*
+==============
+S_CodecShutdownAsync
+
+Streams that are still open are decoded on demand from now on
+==============
+*/
+void S_CodecShutdownAsync()
+{
+    snd_async_stream_t *async;
+
+    Cmd_RemoveCommand("streaminfo");
+    Cmd_RemoveCommand("streamtest");
+
+    if (!s_streamDecode || !s_streamDecode->running) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_streamDecode->mutex);
+        s_streamDecode->running = false;
+        s_streamDecode->wakeWorker.notify_one();
+    }
+
+    s_streamDecode->worker.join();
+
+    while (s_streamDecode->streams) {
+        async                   = s_streamDecode->streams;
+        s_streamDecode->streams = async->next;
+
+        async->stream->codec = async->codec;
+        async->stream->async = NULL;
+
+        Z_Free(async->ring);
+        Z_Free(async);
+    }
+}
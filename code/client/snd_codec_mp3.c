@@ -234,8 +234,16 @@ int S_MP3_Scanfile(snd_stream_t* stream)
 #define TEMPERING_SHIFT_T(y)  (y << 15)
 #define TEMPERING_SHIFT_L(y)  (y >> 18)
 
-static unsigned long mt[MP3_DITH_N]; /* the array for the state vector  */
-static int mti = MP3_DITH_N + 1; /* mti==MP3_DITH_N+1 means mt[MP3_DITH_N] is not initialized */
+// Added in OPM
+//  The generator state is per thread, as streams are decoded on a worker thread
+#ifdef _MSC_VER
+#define MP3_THREAD_LOCAL __declspec(thread)
+#else
+#define MP3_THREAD_LOCAL __thread
+#endif
+
+static MP3_THREAD_LOCAL unsigned long mt[MP3_DITH_N]; /* the array for the state vector  */
+static MP3_THREAD_LOCAL int mti = MP3_DITH_N + 1; /* mti==MP3_DITH_N+1 means mt[MP3_DITH_N] is not initialized */
 
 /* initializing the array with a NONZERO seed */
 void sgenrand(unsigned long seed)
@@ -492,12 +500,14 @@ int S_MP3_Decode(snd_stream_t* stream)
         if (samplecount < pcm->length)
         {
             // The pcm buffer was not large enough. Make it bigger.
-            byte* newbuf = Z_Malloc(cursize);
+            // Added in OPM
+            //  Not allocated from the zone, reads can happen on the stream thread
+            byte* newbuf = malloc(cursize);
 
             if (mp3info->pcmbuf)
             {
                 memcpy(newbuf, mp3info->pcmbuf, mp3info->buflen);
-                Z_Free(mp3info->pcmbuf);
+                free(mp3info->pcmbuf);
             }
 
             mp3info->pcmbuf = newbuf;
@@ -594,7 +604,7 @@ void S_MP3_CodecCloseStream(snd_stream_t* stream)
         mp3info = stream->ptr;
 
         if (mp3info->pcmbuf)
-            Z_Free(mp3info->pcmbuf);
+            free(mp3info->pcmbuf);
 
         mad_synth_finish(&mp3info->madsynth);
         mad_frame_finish(&mp3info->madframe);
@@ -713,4 +723,166 @@ void* S_MP3_CodecLoad(const char* filename, snd_info_t* info)
     return pcmbuffer;
 }
 
+/*
+=================
+S_MP3_ScaleNoDither
+
+Same as S_MP3_Scale without the dithering, which uses a global
+random generator and can't run outside of the main thread.
+=================
+*/
+static signed int S_MP3_ScaleNoDither(mad_fixed_t sample)
+{
+    int n_bits_to_loose = MAD_F_FRACBITS + 1 - 16;
+
+    // round
+    sample += (1L << (n_bits_to_loose - 1));
+
+    /* clip */
+    if (sample >= MAD_F_ONE)
+        sample = MAD_F_ONE - 1;
+    else if (sample < -MAD_F_ONE)
+        sample = -MAD_F_ONE;
+
+    /* quantize */
+    return sample >> n_bits_to_loose;
+}
+
+/*
+=====================================================================
+S_MP3_DecodeMemory
+
+Decodes a whole mp3 file that was already read into memory.
+It doesn't use the filesystem nor the zone so it can be called from
+any thread, the returned buffer must be released with free().
+======================================================================
+*/
+void* S_MP3_DecodeMemory(const byte* data, int length, snd_info_t* info)
+{
+    struct mad_stream madstream;
+    struct mad_frame madframe;
+    struct mad_synth madsynth;
+    struct mad_pcm* pcm;
+    byte* encbuf;
+    byte* pcmbuffer;
+    byte* newbuf;
+    int pcmsize;
+    int pcmlen;
+    int needsize;
+    int i, j;
+    signed int sample;
+    qboolean failed;
+
+    memset(info, 0, sizeof(*info));
+
+    if (!data || length <= 0)
+        return NULL;
+
+    // libmad needs a few zero bytes after the last frame to decode it
+    encbuf = malloc(length + MAD_BUFFER_GUARD);
+    if (!encbuf)
+        return NULL;
+
+    memcpy(encbuf, data, length);
+    memset(&encbuf[length], 0, MAD_BUFFER_GUARD);
+
+    mad_stream_init(&madstream);
+    mad_frame_init(&madframe);
+    mad_synth_init(&madsynth);
+    mad_stream_buffer(&madstream, encbuf, length + MAD_BUFFER_GUARD);
+
+    pcmbuffer = NULL;
+    pcmsize = 0;
+    pcmlen = 0;
+    failed = qfalse;
+
+    for (;;)
+    {
+        if (mad_frame_decode(&madframe, &madstream))
+        {
+            if (MAD_RECOVERABLE(madstream.error))
+                continue;
+
+            // running out of data is the normal end
+            if (madstream.error != MAD_ERROR_BUFLEN)
+                failed = qtrue;
+            break;
+        }
+
+        // check whether this really is an mp3
+        if (madframe.header.layer != MAD_LAYER_III)
+        {
+            failed = qtrue;
+            break;
+        }
+
+        mad_synth_frame(&madsynth, &madframe);
+        pcm = &madsynth.pcm;
+
+        if (!info->rate)
+        {
+            info->rate = pcm->samplerate;
+            info->channels = pcm->channels;
+            info->width = MP3_SAMPLE_WIDTH;
+        }
+        else if (info->rate != pcm->samplerate || info->channels != pcm->channels)
+        {
+            failed = qtrue;
+            break;
+        }
+
+        needsize = pcmlen + pcm->length * pcm->channels * MP3_SAMPLE_WIDTH;
+        if (needsize > pcmsize)
+        {
+            // start with a guess of the compression ratio
+            pcmsize = pcmsize ? pcmsize * 2 : length * 8;
+            if (pcmsize < needsize)
+                pcmsize = needsize;
+
+            newbuf = realloc(pcmbuffer, pcmsize);
+            if (!newbuf)
+            {
+                failed = qtrue;
+                break;
+            }
+
+            pcmbuffer = newbuf;
+        }
+
+        for (i = 0; i < pcm->length; i++)
+        {
+            for (j = 0; j < pcm->channels; j++)
+            {
+                sample = S_MP3_ScaleNoDither(pcm->samples[j][i]);
+
+#ifdef Q3_BIG_ENDIAN
+                pcmbuffer[pcmlen++] = (sample >> 8) & 0xff;
+                pcmbuffer[pcmlen++] = sample & 0xff;
+#else
+                pcmbuffer[pcmlen++] = sample & 0xff;
+                pcmbuffer[pcmlen++] = (sample >> 8) & 0xff;
+#endif
+            }
+        }
+
+        info->samples += pcm->length;
+    }
+
+    mad_synth_finish(&madsynth);
+    mad_frame_finish(&madframe);
+    mad_stream_finish(&madstream);
+    free(encbuf);
+
+    if (failed || !pcmlen)
+    {
+        free(pcmbuffer);
+        memset(info, 0, sizeof(*info));
+        return NULL;
+    }
+
+    info->size = pcmlen;
+
+    return pcmbuffer;
+}
+
 #endif
@@ -80,6 +80,7 @@ cvar_t		*s_testsound;
 cvar_t		*s_show;
 cvar_t		*s_mixahead;
 cvar_t		*s_mixPreStep;
+cvar_t		*s_mixSIMD;
 
 static loopSound_t		loopSounds[MAX_GENTITIES];
 static	channel_t		*freelist = NULL;
@@ -1566,6 +1567,7 @@ void S_Base_Shutdown( void ) {
 	s_numSfx = 0;
 
 	Cmd_RemoveCommand("s_info");
+	Cmd_RemoveCommand("s_mixbench");
 }
 
 /*
@@ -1584,6 +1586,7 @@ qboolean S_Base_Init( soundInterface_t *si ) {
 	s_mixPreStep = Cvar_Get ("s_mixPreStep", "0.05", CVAR_ARCHIVE);
 	s_show = Cvar_Get ("s_show", "0", CVAR_CHEAT);
 	s_testsound = Cvar_Get ("s_testsound", "0", CVAR_CHEAT);
+	s_mixSIMD = Cvar_Get ("s_mixSIMD", "1", CVAR_ARCHIVE);
 
 	r = SNDDMA_Init();
 
@@ -1600,6 +1603,8 @@ qboolean S_Base_Init( soundInterface_t *si ) {
 		s_paintedtime = 0;
 
 		S_Base_StopAllSounds( );
+
+		Cmd_AddCommand("s_mixbench", S_MixBench_f);
 	} else {
 		return qfalse;
 	}
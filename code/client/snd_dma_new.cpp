@@ -55,6 +55,16 @@ sfx_info_t sfx_infos[MAX_SFX_INFOS];
 sfx_t s_knownSfx[MAX_SFX];
 int   s_numSfx;
 
+// Added in OPM
+//  Hash index of s_knownSfx by name, the chains hold the sfx number + 1
+#define SFX_HASH_SIZE 1024
+
+static int s_sfxHashTable[SFX_HASH_SIZE];
+static int s_sfxHashNext[MAX_SFX];
+static int s_firstFreeSfx; // no free slot below this one
+
+static void S_RebuildSfxHash();
+
 s_entity_t s_entity[MAX_GENTITIES];
 
 static int      s_registrationSequence;
@@ -126,6 +136,7 @@ void S_Init(qboolean full_startup)
 
             if (full_startup) {
                 s_numSfx = 0;
+                S_RebuildSfxHash();
                 S_StopAllSounds(true);
             }
 
@@ -171,6 +182,8 @@ void S_Shutdown(qboolean full_shutdown)
             sfx = &s_knownSfx[i];
 
             if (sfx->name[0]) {
+                S_CancelSoundDecode(sfx);
+
                 if (sfx->data) {
                     Z_Free(sfx->data);
                 }
@@ -180,6 +193,8 @@ void S_Shutdown(qboolean full_shutdown)
         }
 
         s_numSfx = 0;
+        S_RebuildSfxHash();
+        S_ShutdownSoundDecode();
     }
 
     Com_Printf("------- Sound Shutdown Complete -------\n");
@@ -187,25 +202,91 @@ void S_Shutdown(qboolean full_shutdown)
 
 /*
 ==============
-S_NameExists
+S_HashSfxName
 ==============
 */
-qboolean S_NameExists(const char *name)
+static int S_HashSfxName(const char *name)
+{
+    int  i;
+    long hash;
+
+    hash = 0;
+    for (i = 0; name[i]; i++) {
+        hash += (long)name[i] * (i + 119);
+    }
+
+    hash = (hash ^ (hash >> 10) ^ (hash >> 20));
+    return hash & (SFX_HASH_SIZE - 1);
+}
+
+/*
+==============
+S_HashSfx
+==============
+*/
+static void S_HashSfx(int index)
+{
+    int hash;
+
+    hash                 = S_HashSfxName(s_knownSfx[index].name);
+    s_sfxHashNext[index] = s_sfxHashTable[hash];
+    s_sfxHashTable[hash] = index + 1;
+}
+
+/*
+==============
+S_RebuildSfxHash
+
+Called when sfx slots are emptied
+==============
+*/
+static void S_RebuildSfxHash()
 {
     int i;
 
-    if (strlen(name) >= MAX_RES_NAME) {
-        Com_DPrintf("Sound name too long: %s", name);
-        return qfalse;
+    memset(s_sfxHashTable, 0, sizeof(s_sfxHashTable));
+    s_firstFreeSfx = s_numSfx;
+
+    for (i = s_numSfx - 1; i >= 0; i--) {
+        if (s_knownSfx[i].name[0]) {
+            S_HashSfx(i);
+        } else {
+            s_firstFreeSfx = i;
+        }
     }
+}
 
-    for (i = 0; i < s_numSfx; i++) {
-        if (!strcmp(s_knownSfx[i].name, name)) {
-            return qtrue;
+/*
+==============
+S_HashFindSfx
+==============
+*/
+static sfx_t *S_HashFindSfx(const char *name)
+{
+    int index;
+
+    for (index = s_sfxHashTable[S_HashSfxName(name)]; index; index = s_sfxHashNext[index - 1]) {
+        if (!strcmp(s_knownSfx[index - 1].name, name)) {
+            return &s_knownSfx[index - 1];
         }
     }
 
-    return qfalse;
+    return NULL;
+}
+
+/*
+==============
+S_NameExists
+==============
+*/
+qboolean S_NameExists(const char *name)
+{
+    if (strlen(name) >= MAX_RES_NAME) {
+        Com_DPrintf("Sound name too long: %s", name);
+        return qfalse;
+    }
+
+    return S_HashFindSfx(name) != NULL;
 }
 
 /*
@@ -233,21 +314,20 @@ sfx_t *S_FindName(const char *name, int sequenceNumber)
         return NULL;
     }
 
-    for (i = 0; i < s_numSfx; i++) {
-        sfx = &s_knownSfx[i];
-
-        if (!strcmp(sfx->name, name)) {
-            if (sfx->registration_sequence != -1) {
-                sfx->registration_sequence = sequenceNumber;
-            }
-
-            return sfx;
+    sfx = S_HashFindSfx(name);
+    if (sfx) {
+        if (sfx->registration_sequence != -1) {
+            sfx->registration_sequence = sequenceNumber;
         }
+
+        return sfx;
     }
 
     sfx = &s_knownSfx[0];
 
-    for (i = 0; i < s_numSfx; i++) {
+    // Added in OPM
+    //  Start from the lowest slot that can be free
+    for (i = s_firstFreeSfx; i < s_numSfx; i++) {
         sfx = &s_knownSfx[i];
         if (!sfx->name[0]) {
             break;
@@ -270,6 +350,9 @@ sfx_t *S_FindName(const char *name, int sequenceNumber)
     Q_strncpyz(sfx->name, name, sizeof(sfx->name));
     sfx->registration_sequence = sequenceNumber;
 
+    s_firstFreeSfx = i + 1;
+    S_HashSfx(i);
+
     return sfx;
 }
 
@@ -429,6 +512,8 @@ void S_EndRegistration()
         }
 
         if (sfx->registration_sequence && sfx->registration_sequence != s_registrationSequence) {
+            S_CancelSoundDecode(sfx);
+
             if (sfx->data) {
                 Z_Free(sfx->data);
             }
@@ -437,6 +522,8 @@ void S_EndRegistration()
         }
     }
 
+    S_RebuildSfxHash();
+
     Com_Printf("------- Sound End Registration Complete -------\n");
 }
 
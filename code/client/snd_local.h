@@ -219,6 +219,7 @@ extern cvar_t *s_muted;
 extern cvar_t *s_doppler;
 
 extern cvar_t *s_testsound;
+extern cvar_t *s_mixSIMD;
 
 qboolean S_LoadSound( sfx_t *sfx );
 
@@ -274,6 +275,17 @@ typedef int srcHandle_t;
 
 qboolean S_AL_Init( soundInterface_t *si );
 
+// Added in OPM
+//  SSE2/NEON mixing kernels (snd_mixsimd.c)
+qboolean S_MixSIMDAvailable( void );
+void S_MixSamples16_scalar( portable_samplepair_t *samp, const short *samples, int count, int channels, int leftvol, int rightvol );
+void S_MixSamples16_simd( portable_samplepair_t *samp, const short *samples, int count, int channels, int leftvol, int rightvol );
+void S_MixSamples16( portable_samplepair_t *samp, const short *samples, int count, int channels, int leftvol, int rightvol );
+void S_ClampSamples16_scalar( short *out, const int *in, int count );
+void S_ClampSamples16_simd( short *out, const int *in, int count );
+void S_ClampSamples16( short *out, const int *in, int count );
+void S_MixBench_f( void );
+
 #ifdef idppc_altivec
 void S_PaintChannelFrom16_altivec( portable_samplepair_t paintbuffer[PAINTBUFFER_SIZE], int snd_vol, channel_t *ch, const sfx_t *sc, int count, int sampleOffset, int bufferOffset );
 #endif
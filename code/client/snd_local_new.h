@@ -79,6 +79,10 @@ typedef struct sfx_s {
 
     wavinfo_t    info;
     unsigned int buffer;
+
+    // Added in OPM
+    //  Pending background decode of the sound data
+    struct sfxDecodeJob_s *decodeJob;
 } sfx_t;
 
 typedef struct {
@@ -218,6 +222,13 @@ void S_ClearSoundBuffer();
 //
 qboolean S_LoadSound(const char *fileName, sfx_t *sfx, int streamed, qboolean force_load);
 
+// Added in OPM
+//  Background decoding of compressed sounds
+byte *S_FinishSoundDecode(sfx_t *sfx, int *rate, int *channels, int *size);
+void  S_FreeDecodedSound(byte *data);
+void  S_CancelSoundDecode(sfx_t *sfx);
+void  S_ShutdownSoundDecode();
+
 #define S_StopAllSounds2 S_StopAllSounds
 
 //
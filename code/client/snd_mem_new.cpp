@@ -21,8 +21,13 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
 #include "snd_local.h"
+#include "snd_codec.h"
 #include "cl_ui.h"
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 byte *data_p;
 byte *iff_end;
 byte *last_chunk;
@@ -535,6 +540,283 @@ qboolean S_LoadSound(const char *fileName, sfx_t *sfx, int streamed, qboolean fo
     return qtrue;
 }
 
+//
+// Added in OPM
+//  Background decoding of compressed sounds.
+//  The file is still read on the main thread (the filesystem and the zone
+//  aren't thread-safe), the worker only turns sfx->data into PCM
+//  with malloc'ed memory. The PCM is picked up when the sound is first played.
+//  Until then it's held next to the compressed data, so only s_decodeAhead
+//  sounds are decoded ahead, the others are decoded when they're first played.
+//
+
+typedef enum {
+    SFX_DECODE_QUEUED,
+    SFX_DECODE_RUNNING,
+    SFX_DECODE_DONE
+} sfxDecodeState_t;
+
+typedef struct sfxDecodeJob_s {
+    sfxDecodeState_t       state;
+    const byte            *source;
+    int                    sourceLength;
+    byte                  *pcm;
+    snd_info_t             info;
+    struct sfxDecodeJob_s *next;
+} sfxDecodeJob_t;
+
+struct sfxDecodeQueue_t {
+    std::mutex              mutex;
+    std::condition_variable wakeWorker;
+    std::condition_variable jobDone;
+    std::thread             worker;
+    sfxDecodeJob_t         *head;
+    sfxDecodeJob_t         *tail;
+    bool                    running;
+};
+
+// allocated on first use so no thread is left to destroy at exit
+static sfxDecodeQueue_t *s_decodeQueue;
+// sounds with a job, queued or decoded but not played yet
+static int               s_numDecodeJobs;
+static cvar_t           *s_decodeAhead;
+
+/*
+==============
+S_DecodeJob
+==============
+*/
+static void S_DecodeJob(sfxDecodeJob_t *job)
+{
+#ifdef USE_CODEC_MP3
+    job->pcm = (byte *)S_MP3_DecodeMemory(job->source, job->sourceLength, &job->info);
+#else
+    job->pcm = NULL;
+#endif
+}
+
+/*
+==============
+S_DecodeWorker
+==============
+*/
+static void S_DecodeWorker(sfxDecodeQueue_t *queue)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+
+    for (;;) {
+        sfxDecodeJob_t *job;
+
+        while (queue->running && !queue->head) {
+            queue->wakeWorker.wait(lock);
+        }
+
+        if (!queue->running) {
+            break;
+        }
+
+        job         = queue->head;
+        queue->head = job->next;
+        if (!queue->head) {
+            queue->tail = NULL;
+        }
+
+        job->state = SFX_DECODE_RUNNING;
+        job->next  = NULL;
+
+        lock.unlock();
+        S_DecodeJob(job);
+        lock.lock();
+
+        job->state = SFX_DECODE_DONE;
+        queue->jobDone.notify_all();
+    }
+}
+
+/*
+==============
+S_QueueSoundDecode
+==============
+*/
+static void S_QueueSoundDecode(sfx_t *sfx)
+{
+    sfxDecodeJob_t *job;
+
+    if (!s_decodeAhead) {
+        s_decodeAhead = Cvar_Get("s_decodeAhead", "32", CVAR_ARCHIVE);
+        Cvar_SetDescription(
+            s_decodeAhead, "Maximum number of MP3 sounds decoded on a thread before they're played, 0 to decode on demand"
+        );
+    }
+
+    if (s_numDecodeJobs >= s_decodeAhead->integer) {
+        // decoded when it's first played
+        return;
+    }
+
+    if (!s_decodeQueue) {
+        s_decodeQueue          = new sfxDecodeQueue_t;
+        s_decodeQueue->head    = NULL;
+        s_decodeQueue->tail    = NULL;
+        s_decodeQueue->running = false;
+    }
+
+    if (!s_decodeQueue->running) {
+        s_decodeQueue->running = true;
+        s_decodeQueue->worker  = std::thread(S_DecodeWorker, s_decodeQueue);
+    }
+
+    job               = (sfxDecodeJob_t *)Z_TagMalloc(sizeof(sfxDecodeJob_t), TAG_SOUND);
+    job->state        = SFX_DECODE_QUEUED;
+    job->source       = sfx->data;
+    job->sourceLength = sfx->length;
+    job->pcm          = NULL;
+    job->next         = NULL;
+    memset(&job->info, 0, sizeof(job->info));
+
+    sfx->decodeJob = job;
+    s_numDecodeJobs++;
+
+    std::lock_guard<std::mutex> lock(s_decodeQueue->mutex);
+
+    if (s_decodeQueue->tail) {
+        s_decodeQueue->tail->next = job;
+    } else {
+        s_decodeQueue->head = job;
+    }
+    s_decodeQueue->tail = job;
+
+    s_decodeQueue->wakeWorker.notify_one();
+}
+
+/*
+==============
+S_UnlinkSoundDecode
+
+Waits for the job of the sfx to be done, or removes it from the queue
+if it hasn't started. Returns false if the job hasn't run.
+==============
+*/
+static bool S_UnlinkSoundDecode(sfx_t *sfx)
+{
+    sfxDecodeJob_t              *job = sfx->decodeJob;
+    sfxDecodeJob_t             **prev;
+    sfxDecodeJob_t              *last;
+    std::unique_lock<std::mutex> lock(s_decodeQueue->mutex);
+
+    while (job->state == SFX_DECODE_RUNNING) {
+        s_decodeQueue->jobDone.wait(lock);
+    }
+
+    if (job->state == SFX_DECODE_DONE) {
+        return true;
+    }
+
+    prev = &s_decodeQueue->head;
+    last = NULL;
+
+    while (*prev) {
+        if (*prev == job) {
+            *prev = job->next;
+            continue;
+        }
+
+        last = *prev;
+        prev = &last->next;
+    }
+
+    s_decodeQueue->tail = last;
+
+    return false;
+}
+
+/*
+==============
+S_FinishSoundDecode
+
+Returns the PCM of the sound, decoding it now if the worker didn't get to it yet.
+The data must be released with S_FreeDecodedSound.
+==============
+*/
+byte *S_FinishSoundDecode(sfx_t *sfx, int *rate, int *channels, int *size)
+{
+    sfxDecodeJob_t *job = sfx->decodeJob;
+    byte           *pcm;
+
+    if (!job) {
+        return NULL;
+    }
+
+    if (!S_UnlinkSoundDecode(sfx)) {
+        // don't wait for the sounds queued before this one
+        S_DecodeJob(job);
+    }
+
+    pcm       = job->pcm;
+    *rate     = job->info.rate;
+    *channels = job->info.channels;
+    *size     = job->info.size;
+
+    Z_Free(job);
+    sfx->decodeJob = NULL;
+    s_numDecodeJobs--;
+
+    return pcm;
+}
+
+/*
+==============
+S_FreeDecodedSound
+==============
+*/
+void S_FreeDecodedSound(byte *data)
+{
+    free(data);
+}
+
+/*
+==============
+S_CancelSoundDecode
+
+Must be called before freeing the data of the sfx
+==============
+*/
+void S_CancelSoundDecode(sfx_t *sfx)
+{
+    sfxDecodeJob_t *job = sfx->decodeJob;
+
+    if (!job) {
+        return;
+    }
+
+    S_UnlinkSoundDecode(sfx);
+
+    free(job->pcm);
+    Z_Free(job);
+    sfx->decodeJob = NULL;
+    s_numDecodeJobs--;
+}
+
+/*
+==============
+S_ShutdownSoundDecode
+==============
+*/
+void S_ShutdownSoundDecode()
+{
+    if (!s_decodeQueue || !s_decodeQueue->running) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_decodeQueue->mutex);
+        s_decodeQueue->running = false;
+        s_decodeQueue->wakeWorker.notify_one();
+    }
+
+    s_decodeQueue->worker.join();
+}
+
 /*
 ==============
 S_LoadMP3
@@ -562,5 +844,10 @@ qboolean S_LoadMP3(const char *fileName, sfx_t *sfx)
 
     sfx->iFlags |= SFX_FLAG_MP3;
 
+    // Added in OPM
+    //  Decode it ahead of time rather than when it's first played,
+    //  as long as there are less than s_decodeAhead sounds waiting
+    S_QueueSoundDecode(sfx);
+
     return qtrue;
 }
@@ -35,27 +35,9 @@ short*   snd_out;
 
 void S_WriteLinearBlastStereo16 (void)
 {
-	int		i;
-	int		val;
-
-	for (i=0 ; i<snd_linear_count ; i+=2)
-	{
-		val = snd_p[i]>>8;
-		if (val > 0x7fff)
-			snd_out[i] = 0x7fff;
-		else if (val < -32768)
-			snd_out[i] = -32768;
-		else
-			snd_out[i] = val;
-
-		val = snd_p[i+1]>>8;
-		if (val > 0x7fff)
-			snd_out[i+1] = 0x7fff;
-		else if (val < -32768)
-			snd_out[i+1] = -32768;
-		else
-			snd_out[i+1] = val;
-	}
+	// Added in OPM
+	//  The clamping is done by the SIMD kernels when available
+	S_ClampSamples16(snd_out, snd_p, snd_linear_count);
 }
 #elif defined(__GNUC__)
 // uses snd_mixa.s
@@ -351,6 +333,70 @@ static void S_PaintChannelFrom16_scalar( channel_t *ch, const sfx_t *sc, int cou
 	}
 }
 
+/*
+===================
+S_PaintChannelFrom16_simd
+
+Added in OPM
+Same as the non-doppler path of S_PaintChannelFrom16_scalar,
+mixing whole chunk spans with the SIMD kernel
+===================
+*/
+static void S_PaintChannelFrom16_simd( channel_t *ch, const sfx_t *sc, int count, int sampleOffset, int bufferOffset ) {
+	int						leftvol, rightvol;
+	int						i, n;
+	portable_samplepair_t	*samp;
+	sndBuffer				*chunk;
+
+	if (sc->soundChannels <= 0) {
+		return;
+	}
+
+	samp = &paintbuffer[ bufferOffset ];
+
+	if (ch->doppler) {
+		sampleOffset = sampleOffset*ch->oldDopplerScale;
+	}
+
+	if ( sc->soundChannels == 2 ) {
+		sampleOffset *= sc->soundChannels;
+
+		if ( sampleOffset & 1 ) {
+			sampleOffset &= ~1;
+		}
+	}
+
+	chunk = sc->soundData;
+	while (sampleOffset>=SND_CHUNK_SIZE) {
+		chunk = chunk->next;
+		sampleOffset -= SND_CHUNK_SIZE;
+		if (!chunk) {
+			chunk = sc->soundData;
+		}
+	}
+
+	leftvol = ch->leftvol*snd_vol;
+	rightvol = ch->rightvol*snd_vol;
+
+	for ( i=0 ; i<count ; i+=n ) {
+		n = (SND_CHUNK_SIZE - sampleOffset) / sc->soundChannels;
+		if (n > count - i) {
+			n = count - i;
+		}
+
+		S_MixSamples16_simd( &samp[i], &chunk->sndChunk[sampleOffset], n, sc->soundChannels, leftvol, rightvol );
+		sampleOffset += n * sc->soundChannels;
+
+		if (sampleOffset == SND_CHUNK_SIZE) {
+			chunk = chunk->next;
+			if (!chunk) {
+				chunk = sc->soundData;
+			}
+			sampleOffset = 0;
+		}
+	}
+}
+
 static void S_PaintChannelFrom16( channel_t *ch, const sfx_t *sc, int count, int sampleOffset, int bufferOffset ) {
 #if idppc_altivec
 	if (com_altivec->integer) {
@@ -359,13 +405,17 @@ static void S_PaintChannelFrom16( channel_t *ch, const sfx_t *sc, int count, int
 		return;
 	}
 #endif
+	// Added in OPM
+	if (s_mixSIMD->integer && S_MixSIMDAvailable() && (!ch->doppler || ch->dopplerScale==1.0f)) {
+		S_PaintChannelFrom16_simd( ch, sc, count, sampleOffset, bufferOffset );
+		return;
+	}
 	S_PaintChannelFrom16_scalar( ch, sc, count, sampleOffset, bufferOffset );
 }
 
 void S_PaintChannelFromWavelet( channel_t *ch, sfx_t *sc, int count, int sampleOffset, int bufferOffset ) {
-	int						data;
 	int						leftvol, rightvol;
-	int						i;
+	int						i, n;
 	portable_samplepair_t	*samp;
 	sndBuffer				*chunk;
 	short					*samples;
@@ -390,10 +440,14 @@ void S_PaintChannelFromWavelet( channel_t *ch, sfx_t *sc, int count, int sampleO
 
 	samples = sfxScratchBuffer;
 
-	for ( i=0 ; i<count ; i++ ) {
-		data  = samples[sampleOffset++];
-		samp[i].left += (data * leftvol)>>8;
-		samp[i].right += (data * rightvol)>>8;
+	for ( i=0 ; i<count ; i+=n ) {
+		n = SND_CHUNK_SIZE*2 - sampleOffset;
+		if (n > count - i) {
+			n = count - i;
+		}
+
+		S_MixSamples16( &samp[i], &samples[sampleOffset], n, 1, leftvol, rightvol );
+		sampleOffset += n;
 
 		if (sampleOffset == SND_CHUNK_SIZE*2) {
 			chunk = chunk->next;
@@ -405,9 +459,8 @@ void S_PaintChannelFromWavelet( channel_t *ch, sfx_t *sc, int count, int sampleO
 }
 
 void S_PaintChannelFromADPCM( channel_t *ch, sfx_t *sc, int count, int sampleOffset, int bufferOffset ) {
-	int						data;
 	int						leftvol, rightvol;
-	int						i;
+	int						i, n;
 	portable_samplepair_t	*samp;
 	sndBuffer				*chunk;
 	short					*samples;
@@ -437,10 +490,14 @@ void S_PaintChannelFromADPCM( channel_t *ch, sfx_t *sc, int count, int sampleOff
 
 	samples = sfxScratchBuffer;
 
-	for ( i=0 ; i<count ; i++ ) {
-		data  = samples[sampleOffset++];
-		samp[i].left += (data * leftvol)>>8;
-		samp[i].right += (data * rightvol)>>8;
+	for ( i=0 ; i<count ; i+=n ) {
+		n = SND_CHUNK_SIZE*4 - sampleOffset;
+		if (n > count - i) {
+			n = count - i;
+		}
+
+		S_MixSamples16( &samp[i], &samples[sampleOffset], n, 1, leftvol, rightvol );
+		sampleOffset += n;
 
 		if (sampleOffset == SND_CHUNK_SIZE*4) {
 			chunk = chunk->next;
@@ -459,6 +516,8 @@ void S_PaintChannelFromMuLaw( channel_t *ch, sfx_t *sc, int count, int sampleOff
 	sndBuffer				*chunk;
 	byte					*samples;
 	float					ooff;
+	int						j, n;
+	short					decoded[SND_CHUNK_SIZE*2];
 
 	leftvol = ch->leftvol*snd_vol;
 	rightvol = ch->rightvol*snd_vol;
@@ -475,11 +534,21 @@ void S_PaintChannelFromMuLaw( channel_t *ch, sfx_t *sc, int count, int sampleOff
 
 	if (!ch->doppler) {
 		samples = (byte *)chunk->sndChunk + sampleOffset;
-		for ( i=0 ; i<count ; i++ ) {
-			data  = mulawToShort[*samples];
-			samp[i].left += (data * leftvol)>>8;
-			samp[i].right += (data * rightvol)>>8;
-			samples++;
+		for ( i=0 ; i<count ; i+=n ) {
+			// Added in OPM
+			//  Expand the rest of the chunk and mix it at once
+			n = (byte *)chunk->sndChunk + (SND_CHUNK_SIZE*2) - samples;
+			if (n > count - i) {
+				n = count - i;
+			}
+
+			for ( j=0 ; j<n ; j++ ) {
+				decoded[j] = mulawToShort[samples[j]];
+			}
+
+			S_MixSamples16( &samp[i], decoded, n, 1, leftvol, rightvol );
+			samples += n;
+
 			if (chunk != NULL && samples == (byte *)chunk->sndChunk+(SND_CHUNK_SIZE*2)) {
 				chunk = chunk->next;
 				samples = (byte *)chunk->sndChunk;
@@ -0,0 +1,375 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+// snd_mixsimd.c -- SSE2/NEON kernels for the mixer in snd_mix.c
+
+/* The kernels give exactly the same output as the scalar code:
+   (sample * vol) >> 8 is computed on 32-bit integers, and the final
+   clamp is a saturating pack. SSE2 has no 32-bit multiply, so the
+   volume (up to 255*255) is split into two halves that fit in 16 bits
+   and pmaddwd adds sample*half1 + sample*half2. */
+
+#include "client.h"
+#include "snd_local.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SND_MIX_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SND_MIX_NEON 1
+#include <arm_neon.h>
+#endif
+
+/*
+===============================================================================
+
+SCALAR KERNELS
+
+===============================================================================
+*/
+
+void S_MixSamples16_scalar( portable_samplepair_t *samp, const short *samples, int count, int channels, int leftvol, int rightvol ) {
+	int		data;
+	int		i;
+
+	for ( i=0 ; i<count ; i++ ) {
+		data  = *samples++;
+		samp[i].left += (data * leftvol)>>8;
+
+		if ( channels == 2 ) {
+			data = *samples++;
+		}
+		samp[i].right += (data * rightvol)>>8;
+	}
+}
+
+void S_ClampSamples16_scalar( short *out, const int *in, int count ) {
+	int		i;
+	int		val;
+
+	for ( i=0 ; i<count ; i++ ) {
+		val = in[i]>>8;
+		if (val > 0x7fff)
+			out[i] = 0x7fff;
+		else if (val < -32768)
+			out[i] = -32768;
+		else
+			out[i] = val;
+	}
+}
+
+/*
+===============================================================================
+
+SIMD KERNELS
+
+===============================================================================
+*/
+
+#if SND_MIX_SSE2
+
+static void S_MixSamples16_sse2( portable_samplepair_t *samp, const short *samples, int count, int channels, int leftvol, int rightvol ) {
+	__m128i	vol;
+	__m128i	s, lo, hi;
+	__m128i	*out;
+	int		i;
+
+	if ( leftvol < 0 || leftvol >= 0xffff || rightvol < 0 || rightvol >= 0xffff ) {
+		// the volume halves wouldn't fit in 16 bits
+		S_MixSamples16_scalar( samp, samples, count, channels, leftvol, rightvol );
+		return;
+	}
+
+	vol = _mm_setr_epi16(
+		leftvol>>1, leftvol-(leftvol>>1), rightvol>>1, rightvol-(rightvol>>1),
+		leftvol>>1, leftvol-(leftvol>>1), rightvol>>1, rightvol-(rightvol>>1)
+	);
+
+	i = 0;
+	if ( channels == 2 ) {
+		for ( ; i+4<=count ; i+=4 ) {
+			// L0 R0 L1 R1 L2 R2 L3 R3
+			s = _mm_loadu_si128( (const __m128i *)&samples[i*2] );
+			lo = _mm_unpacklo_epi16( s, s );
+			hi = _mm_unpackhi_epi16( s, s );
+
+			out = (__m128i *)&samp[i];
+			_mm_storeu_si128( out, _mm_add_epi32( _mm_loadu_si128( out ), _mm_srai_epi32( _mm_madd_epi16( lo, vol ), 8 ) ) );
+			_mm_storeu_si128( out+1, _mm_add_epi32( _mm_loadu_si128( out+1 ), _mm_srai_epi32( _mm_madd_epi16( hi, vol ), 8 ) ) );
+		}
+	} else {
+		for ( ; i+4<=count ; i+=4 ) {
+			// s0 s1 s2 s3, each one is used for both sides
+			s = _mm_loadl_epi64( (const __m128i *)&samples[i] );
+			s = _mm_unpacklo_epi16( s, s );
+			lo = _mm_unpacklo_epi32( s, s );
+			hi = _mm_unpackhi_epi32( s, s );
+
+			out = (__m128i *)&samp[i];
+			_mm_storeu_si128( out, _mm_add_epi32( _mm_loadu_si128( out ), _mm_srai_epi32( _mm_madd_epi16( lo, vol ), 8 ) ) );
+			_mm_storeu_si128( out+1, _mm_add_epi32( _mm_loadu_si128( out+1 ), _mm_srai_epi32( _mm_madd_epi16( hi, vol ), 8 ) ) );
+		}
+	}
+
+	S_MixSamples16_scalar( &samp[i], &samples[i*channels], count-i, channels, leftvol, rightvol );
+}
+
+static void S_ClampSamples16_sse2( short *out, const int *in, int count ) {
+	__m128i	a, b;
+	int		i;
+
+	for ( i=0 ; i+8<=count ; i+=8 ) {
+		a = _mm_srai_epi32( _mm_loadu_si128( (const __m128i *)&in[i] ), 8 );
+		b = _mm_srai_epi32( _mm_loadu_si128( (const __m128i *)&in[i+4] ), 8 );
+		_mm_storeu_si128( (__m128i *)&out[i], _mm_packs_epi32( a, b ) );
+	}
+
+	S_ClampSamples16_scalar( &out[i], &in[i], count-i );
+}
+
+#elif SND_MIX_NEON
+
+static void S_MixSamples16_neon( portable_samplepair_t *samp, const short *samples, int count, int channels, int leftvol, int rightvol ) {
+	int32x4_t	vol;
+	int32x4_t	w;
+	int32x4x2_t	z;
+	int16x8_t	s;
+	int32_t		*out;
+	int			i;
+
+	vol = vsetq_lane_s32( leftvol, vdupq_n_s32( rightvol ), 0 );
+	vol = vsetq_lane_s32( leftvol, vol, 2 );
+
+	i = 0;
+	if ( channels == 2 ) {
+		for ( ; i+4<=count ; i+=4 ) {
+			s = vld1q_s16( &samples[i*2] );
+			out = (int32_t *)&samp[i];
+
+			w = vmovl_s16( vget_low_s16( s ) );
+			vst1q_s32( out, vaddq_s32( vld1q_s32( out ), vshrq_n_s32( vmulq_s32( w, vol ), 8 ) ) );
+			w = vmovl_s16( vget_high_s16( s ) );
+			vst1q_s32( out+4, vaddq_s32( vld1q_s32( out+4 ), vshrq_n_s32( vmulq_s32( w, vol ), 8 ) ) );
+		}
+	} else {
+		for ( ; i+4<=count ; i+=4 ) {
+			w = vmovl_s16( vld1_s16( &samples[i] ) );
+			z = vzipq_s32( w, w );
+			out = (int32_t *)&samp[i];
+
+			vst1q_s32( out, vaddq_s32( vld1q_s32( out ), vshrq_n_s32( vmulq_s32( z.val[0], vol ), 8 ) ) );
+			vst1q_s32( out+4, vaddq_s32( vld1q_s32( out+4 ), vshrq_n_s32( vmulq_s32( z.val[1], vol ), 8 ) ) );
+		}
+	}
+
+	S_MixSamples16_scalar( &samp[i], &samples[i*channels], count-i, channels, leftvol, rightvol );
+}
+
+static void S_ClampSamples16_neon( short *out, const int *in, int count ) {
+	int16x4_t	a, b;
+	int			i;
+
+	for ( i=0 ; i+8<=count ; i+=8 ) {
+		a = vqmovn_s32( vshrq_n_s32( vld1q_s32( &in[i] ), 8 ) );
+		b = vqmovn_s32( vshrq_n_s32( vld1q_s32( &in[i+4] ), 8 ) );
+		vst1q_s16( &out[i], vcombine_s16( a, b ) );
+	}
+
+	S_ClampSamples16_scalar( &out[i], &in[i], count-i );
+}
+
+#endif
+
+/*
+===============================================================================
+
+DISPATCH
+
+===============================================================================
+*/
+
+qboolean S_MixSIMDAvailable( void ) {
+#if SND_MIX_SSE2 || SND_MIX_NEON
+	return qtrue;
+#else
+	return qfalse;
+#endif
+}
+
+static qboolean S_UseMixSIMD( void ) {
+	return s_mixSIMD && s_mixSIMD->integer && S_MixSIMDAvailable();
+}
+
+void S_MixSamples16_simd( portable_samplepair_t *samp, const short *samples, int count, int channels, int leftvol, int rightvol ) {
+#if SND_MIX_SSE2
+	S_MixSamples16_sse2( samp, samples, count, channels, leftvol, rightvol );
+#elif SND_MIX_NEON
+	S_MixSamples16_neon( samp, samples, count, channels, leftvol, rightvol );
+#else
+	S_MixSamples16_scalar( samp, samples, count, channels, leftvol, rightvol );
+#endif
+}
+
+void S_ClampSamples16_simd( short *out, const int *in, int count ) {
+#if SND_MIX_SSE2
+	S_ClampSamples16_sse2( out, in, count );
+#elif SND_MIX_NEON
+	S_ClampSamples16_neon( out, in, count );
+#else
+	S_ClampSamples16_scalar( out, in, count );
+#endif
+}
+
+void S_MixSamples16( portable_samplepair_t *samp, const short *samples, int count, int channels, int leftvol, int rightvol ) {
+	if ( S_UseMixSIMD() ) {
+		S_MixSamples16_simd( samp, samples, count, channels, leftvol, rightvol );
+	} else {
+		S_MixSamples16_scalar( samp, samples, count, channels, leftvol, rightvol );
+	}
+}
+
+void S_ClampSamples16( short *out, const int *in, int count ) {
+	if ( S_UseMixSIMD() ) {
+		S_ClampSamples16_simd( out, in, count );
+	} else {
+		S_ClampSamples16_scalar( out, in, count );
+	}
+}
+
+/*
+===============================================================================
+
+BENCHMARK
+
+===============================================================================
+*/
+
+typedef void (*mixKernel_t)( portable_samplepair_t *samp, const short *samples, int count, int channels, int leftvol, int rightvol );
+typedef void (*clampKernel_t)( short *out, const int *in, int count );
+
+typedef struct {
+	short	*samples;
+	int		channels;
+	int		leftvol;
+	int		rightvol;
+} mixBenchChannel_t;
+
+static void S_MixBench_Run( mixKernel_t mix, clampKernel_t clamp, const mixBenchChannel_t *chans, int numChans, portable_samplepair_t *paint, short *out ) {
+	int		i;
+
+	Com_Memset( paint, 0, sizeof(portable_samplepair_t) * SND_CHUNK_SIZE );
+
+	for ( i=0 ; i<numChans ; i++ ) {
+		mix( paint, chans[i].samples, SND_CHUNK_SIZE, chans[i].channels, chans[i].leftvol, chans[i].rightvol );
+	}
+
+	clamp( out, (const int *)paint, SND_CHUNK_SIZE * 2 );
+}
+
+/*
+=================
+S_MixBench_f
+
+Mixes synthetic channels with both the scalar and the SIMD kernels,
+checks that the output is identical and times them.
+usage: s_mixbench [channels] [iterations]
+=================
+*/
+void S_MixBench_f( void ) {
+	mixBenchChannel_t		*chans;
+	portable_samplepair_t	*paint[2];
+	short					*out[2];
+	int						numChans;
+	int						iterations;
+	int						i, j;
+	int						start;
+	int						scalarTime, simdTime;
+
+	numChans = Cmd_Argc() > 1 ? atoi( Cmd_Argv( 1 ) ) : 32;
+	iterations = Cmd_Argc() > 2 ? atoi( Cmd_Argv( 2 ) ) : 1000;
+
+	if ( numChans < 1 || iterations < 1 ) {
+		Com_Printf( "usage: s_mixbench [channels] [iterations]\n" );
+		return;
+	}
+
+	chans = Z_Malloc( sizeof(mixBenchChannel_t) * numChans );
+	for ( i=0 ; i<numChans ; i++ ) {
+		// every other channel is stereo, with full range samples and volumes
+		chans[i].channels = (i & 1) + 1;
+		chans[i].leftvol = (rand() & 255) * (rand() & 255);
+		chans[i].rightvol = (rand() & 255) * (rand() & 255);
+		chans[i].samples = Z_Malloc( sizeof(short) * SND_CHUNK_SIZE * 2 );
+
+		for ( j=0 ; j<SND_CHUNK_SIZE * 2 ; j++ ) {
+			chans[i].samples[j] = (short)(rand() ^ (rand() << 8));
+		}
+	}
+
+	for ( i=0 ; i<2 ; i++ ) {
+		paint[i] = Z_Malloc( sizeof(portable_samplepair_t) * SND_CHUNK_SIZE );
+		out[i] = Z_Malloc( sizeof(short) * SND_CHUNK_SIZE * 2 );
+	}
+
+	S_MixBench_Run( S_MixSamples16_scalar, S_ClampSamples16_scalar, chans, numChans, paint[0], out[0] );
+	S_MixBench_Run( S_MixSamples16_simd, S_ClampSamples16_simd, chans, numChans, paint[1], out[1] );
+
+	if ( memcmp( paint[0], paint[1], sizeof(portable_samplepair_t) * SND_CHUNK_SIZE )
+		|| memcmp( out[0], out[1], sizeof(short) * SND_CHUNK_SIZE * 2 ) ) {
+		Com_Printf( S_COLOR_RED "s_mixbench: the SIMD output differs from the scalar output\n" );
+	} else {
+		Com_Printf( "s_mixbench: SIMD output matches the scalar output\n" );
+	}
+
+	start = Sys_Milliseconds();
+	for ( i=0 ; i<iterations ; i++ ) {
+		S_MixBench_Run( S_MixSamples16_scalar, S_ClampSamples16_scalar, chans, numChans, paint[0], out[0] );
+	}
+	scalarTime = Sys_Milliseconds() - start;
+
+	start = Sys_Milliseconds();
+	for ( i=0 ; i<iterations ; i++ ) {
+		S_MixBench_Run( S_MixSamples16_simd, S_ClampSamples16_simd, chans, numChans, paint[1], out[1] );
+	}
+	simdTime = Sys_Milliseconds() - start;
+
+	Com_Printf( "%i channels, %i samples, %i iterations (%s)\n", numChans, SND_CHUNK_SIZE, iterations,
+#if SND_MIX_SSE2
+		"SSE2"
+#elif SND_MIX_NEON
+		"NEON"
+#else
+		"no SIMD"
+#endif
+	);
+	Com_Printf( "scalar: %i ms\n", scalarTime );
+	Com_Printf( "SIMD:   %i ms (%.2fx)\n", simdTime, simdTime ? (float)scalarTime / simdTime : 0.f );
+
+	for ( i=0 ; i<2 ; i++ ) {
+		Z_Free( paint[i] );
+		Z_Free( out[i] );
+	}
+
+	for ( i=0 ; i<numChans ; i++ ) {
+		Z_Free( chans[i].samples );
+	}
+	Z_Free( chans );
+}
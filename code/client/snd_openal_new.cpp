@@ -118,6 +118,7 @@ static int
 S_OPENAL_SpatializeStereoSound(const vec3_t listener_origin, const vec3_t listener_left, const vec3_t origin);
 static void   S_OPENAL_reverb(int iChannel, int iReverbType, float fReverbLevel);
 static bool   S_OPENAL_LoadMP3_Codec(const char *_path, sfx_t *pSfx);
+static bool   S_OPENAL_LoadMP3_Decoded(sfx_t *pSfx);
 static ALuint S_OPENAL_Format(float width, int channels);
 
 #define alDieIfError() __alDieIfError(__FILE__, __LINE__)
@@ -706,6 +707,7 @@ qboolean S_OPENAL_Init()
 
     // Added in OPM
     S_CodecInit();
+    S_CodecInitAsync();
 
     return true;
 }
@@ -737,6 +739,10 @@ void S_OPENAL_Shutdown()
 
     S_OPENAL_NukeContext();
 
+    // Added in OPM
+    //  The streams were closed with the channels
+    S_CodecShutdownAsync();
+
     s_bProvidersEmunerated = false;
     al_initialized         = false;
 
@@ -3070,7 +3076,9 @@ bool openal_channel::set_sfx(sfx_t *pSfx)
             qalGenBuffers(1, &pSfx->buffer);
             alDieIfError();
 
-            if (!S_OPENAL_LoadMP3_Codec(pSfx->name, pSfx)) {
+            // Added in OPM
+            //  Use the PCM decoded in the background if possible
+            if (!S_OPENAL_LoadMP3_Decoded(pSfx) && !S_OPENAL_LoadMP3_Codec(pSfx->name, pSfx)) {
                 qalDeleteBuffers(1, &pSfx->buffer);
                 alDieIfError();
 
@@ -4403,6 +4411,38 @@ static bool S_OPENAL_LoadMP3_Codec(const char *_path, sfx_t *pSfx)
     return true;
 }
 
+/*
+==============
+S_OPENAL_LoadMP3_Decoded
+==============
+*/
+static bool S_OPENAL_LoadMP3_Decoded(sfx_t *pSfx)
+{
+    byte  *data;
+    int    rate;
+    int    channels;
+    int    size;
+    ALuint format;
+
+    data = S_FinishSoundDecode(pSfx, &rate, &channels, &size);
+    if (!data) {
+        return false;
+    }
+
+    format = S_OPENAL_Format(2, channels);
+    if (!format) {
+        S_FreeDecodedSound(data);
+        return false;
+    }
+
+    qalBufferData(pSfx->buffer, format, data, size, rate);
+    alDieIfError();
+
+    S_FreeDecodedSound(data);
+
+    return true;
+}
+
 /*
 ==============
 openal_channel::update
@@ -4441,7 +4481,7 @@ bool openal_channel_two_d_stream::set_sfx(sfx_t *pSfx)
     this->pSfx = pSfx;
     Q_strncpyz(this->fileName, pSfx->name, sizeof(this->fileName));
 
-    streamHandle = S_CodecLoad(pSfx->name, NULL);
+    streamHandle = S_CodecOpenStreamAsync(pSfx->name);
     if (!streamHandle) {
         Com_DPrintf("OpenAL: Failed to load sound file.\n");
         return false;
@@ -4607,7 +4647,7 @@ void openal_channel_two_d_stream::update()
         //
         // Looped, start again from the beginning
         //
-        streamHandle = S_CodecLoad(this->fileName, NULL);
+        streamHandle = S_CodecOpenStreamAsync(this->fileName);
         if (!streamHandle) {
             clear_stream();
             return;
@@ -4781,7 +4821,7 @@ void openal_channel_two_d_stream::set_sample_offset(U32 offset)
     }
 
     if (!streamHandle) {
-        streamHandle = S_CodecLoad(this->fileName, NULL);
+        streamHandle = S_CodecOpenStreamAsync(this->fileName);
         if (!streamHandle) {
             clear_stream();
             return;
@@ -4869,7 +4909,7 @@ bool openal_channel_two_d_stream::queue_stream(const char *fileName)
     //
     // Load the file
     //
-    streamHandle = S_CodecLoad(this->fileName, NULL);
+    streamHandle = S_CodecOpenStreamAsync(this->fileName);
     if (!streamHandle) {
         return false;
     }
@@ -2982,6 +2982,10 @@ Actor::Actor()
     m_bEnemySwitch    = true;
     m_iNationality    = ACTOR_NATIONALITY_DEFAULT;
 
+    m_iLodNextThinkTime = 0;
+    m_iLodWakeTime      = 0;
+    m_bLodReduced       = false;
+
     if (g_aistats) {
         PostEvent(EV_Actor_WriteStats, 1.0);
     }
@@ -5078,6 +5082,8 @@ Pain event.
 */
 void Actor::EventPain(Event *ev)
 {
+    WakeLodThink();
+
     if (g_showinfo->integer) {
         ShowInfo();
     }
@@ -6625,6 +6631,10 @@ void Actor::SetEnemy(Sentient *pEnemy, bool bForceConfirmed)
         return;
     }
 
+    if (pEnemy) {
+        WakeLodThink();
+    }
+
     if (m_Enemy) {
         m_Enemy->m_iAttackerCount--;
     }
@@ -7472,6 +7482,12 @@ void Actor::Think(void)
         }
     }
 
+    if (CheckLodThink()) {
+        LodThink();
+        Director.Unpause();
+        return;
+    }
+
     m_eNextAnimMode = -1;
     FixAIParameters();
     UpdateEnableEnemy();
@@ -7502,6 +7518,120 @@ void Actor::Think(void)
     Director.Unpause();
 }
 
+/*
+===============
+Actor::IsNearClient
+
+Returns true if a client is close enough and could see the actor.
+===============
+*/
+bool Actor::IsNearClient(void)
+{
+    int    i;
+    float  maxDistSquared;
+    Vector vOrigin;
+
+    maxDistSquared = Square(ai_loddist->value);
+    vOrigin        = origin;
+
+    for (i = 0; i < game.maxclients; i++) {
+        gentity_t *ent = &g_entities[i];
+
+        if (!ent->inuse || !ent->client || !ent->entity) {
+            continue;
+        }
+
+        if ((ent->entity->origin - origin).lengthSquared() > maxDistSquared) {
+            continue;
+        }
+
+        if (!AreasConnected(ent->entity)) {
+            continue;
+        }
+
+        if (gi.InPVS(vOrigin, ent->entity->origin)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+===============
+Actor::CheckLodThink
+
+Returns true if the actor should only run a reduced think this frame.
+Only idle actors without enemy are reduced, and only while no client
+is near, every ai_lodinterval milliseconds they still think fully.
+===============
+*/
+bool Actor::CheckLodThink(void)
+{
+    int interval;
+
+    if (!ai_lod->integer) {
+        m_bLodReduced = false;
+        return false;
+    }
+
+    if (level.inttime < m_iLodWakeTime || m_Enemy || m_ThinkState != THINKSTATE_IDLE || m_bDirtyThinkState
+        || m_bBecomeRunner || IsNearClient()) {
+        m_bLodReduced = false;
+        return false;
+    }
+
+    interval = Q_max(ai_lodinterval->integer, level.intframetime);
+
+    if (!m_bLodReduced) {
+        // Spread the full thinks of the reduced actors over the interval
+        m_bLodReduced       = true;
+        m_iLodNextThinkTime = level.inttime + (entnum * level.intframetime) % interval + level.intframetime;
+        return false;
+    }
+
+    if (level.inttime >= m_iLodNextThinkTime) {
+        m_iLodNextThinkTime += interval;
+        if (m_iLodNextThinkTime <= level.inttime) {
+            m_iLodNextThinkTime = level.inttime + interval;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+/*
+===============
+Actor::LodThink
+
+Reduced think, the actor keeps the animation and the path
+it had at the last full think and keeps moving along them.
+Perception and the think state wait for the next full think.
+===============
+*/
+void Actor::LodThink(void)
+{
+    parm.movefail   = false;
+    m_eNextAnimMode = -1;
+    ContinueAnimation();
+
+    PostThink(false);
+}
+
+/*
+===============
+Actor::WakeLodThink
+
+Go back to full thinks right away.
+===============
+*/
+void Actor::WakeLodThink(void)
+{
+    m_iLodWakeTime = level.inttime + 5000;
+    m_bLodReduced  = false;
+}
+
 /*
 ===============
 Actor::CheckUnregister
@@ -8984,6 +9114,8 @@ void Actor::ReceiveAIEvent(
         }
     }
 
+    WakeLodThink();
+
     GlobalFuncs_t *func = &GlobalFuncs[CurrentThink()];
 
     if (func->ReceiveAIEvent) {
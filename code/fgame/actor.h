@@ -884,6 +884,13 @@ public:
     vec2_t m_vOriginHistory[MAX_ORIGIN_HISTORY];
     /* current origin history index */
     int  m_iCurrentHistory;
+    // Added in OPM
+    /* next full think while the think is reduced */
+    int m_iLodNextThinkTime;
+    /* full think until this time, after damage, alarms and enemies */
+    int m_iLodWakeTime;
+    /* the last think was reduced */
+    bool m_bLodReduced;
     bool m_bHeadAnglesAchieved;
     bool m_bLUpperArmAnglesAchieved;
     bool m_bTorsoAnglesAchieved;
@@ -1243,6 +1250,10 @@ public:
     //====
     virtual void Think(void) override;
     void         PostThink(bool bDontFaceWall);
+    bool         IsNearClient(void);
+    bool         CheckLodThink(void);
+    void         LodThink(void);
+    void         WakeLodThink(void);
     virtual void SetMoveInfo(mmove_t *mm) override;
     virtual void GetMoveInfo(mmove_t *mm) override;
     void         DoFailSafeMove(vec3_t dest);
@@ -3844,13 +3844,17 @@ void Entity::detach(void)
 void Entity::Flags(Event *ev)
 {
     const char *flag;
+    str         flagName;
     int         mask;
     int         action;
     int         i;
 
     for (i = 1; i <= ev->NumArgs(); i++) {
         action = FLAG_IGNORE;
-        flag   = ev->GetString(i);
+        // Fixed in OPM
+        //  keep the string alive while it's parsed
+        flagName = ev->GetString(i);
+        flag     = flagName;
         switch (flag[0]) {
         case '+':
             action = FLAG_ADD;
@@ -3902,13 +3906,17 @@ void Entity::Flags(Event *ev)
 void Entity::Effects(Event *ev)
 {
     const char *flag;
+    str         flagName;
     int         mask = 0;
     int         action;
     int         i;
 
     for (i = 1; i <= ev->NumArgs(); i++) {
         action = 0;
-        flag   = ev->GetString(i);
+        // Fixed in OPM
+        //  keep the string alive while it's parsed
+        flagName = ev->GetString(i);
+        flag     = flagName;
         switch (flag[0]) {
         case '+':
             action = FLAG_ADD;
@@ -3955,13 +3963,17 @@ void Entity::Effects(Event *ev)
 void Entity::RenderEffects(Event *ev)
 {
     const char *flag;
+    str         flagName;
     int         mask = 0;
     int         action;
     int         i;
 
     for (i = 1; i <= ev->NumArgs(); i++) {
         action = 0;
-        flag   = ev->GetString(i);
+        // Fixed in OPM
+        //  keep the string alive while it's parsed
+        flagName = ev->GetString(i);
+        flag     = flagName;
         switch (flag[0]) {
         case '+':
             action = FLAG_ADD;
@@ -4029,6 +4041,7 @@ void Entity::RenderEffects(Event *ev)
 void Entity::SVFlags(Event *ev)
 {
     const char *flag;
+    str         flagName;
     int         mask         = 0;
     Entity     *ent          = NULL;
     int         singleClient = 0;
@@ -4037,7 +4050,10 @@ void Entity::SVFlags(Event *ev)
 
     for (i = 1; i <= ev->NumArgs(); i++) {
         action = 0;
-        flag   = ev->GetString(i);
+        // Fixed in OPM
+        //  keep the string alive while it's parsed
+        flagName = ev->GetString(i);
+        flag     = flagName;
         switch (flag[0]) {
         case '+':
             action = FLAG_ADD;
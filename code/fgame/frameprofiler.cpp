@@ -0,0 +1,471 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// frameprofiler.cpp: Game frame profiler
+//
+// Phases nest: a phase entered from another one pauses it, so the time of each
+// phase is exclusive and the phases of a frame add up to at most the frame time.
+// Entities are timed around G_RunEntity, inclusive of the phases they run.
+// The time of the last FRAMEPROFILER_HISTORY frames is kept for the percentiles.
+//
+
+#include "frameprofiler.h"
+#include "entity.h"
+#include "level.h"
+
+FrameProfiler frameProfiler;
+
+static const char *frameProfilePhaseNames[FPP_NUM_PHASES] =
+    {"events", "scripts", "poses", "think", "physics", "snapshot"};
+
+FrameProfiler::FrameProfiler()
+    : active(false)
+    , inFrame(false)
+    , trace(false)
+    , framesLeft(0)
+    , frameNum(0)
+    , depth(0)
+    , numFrames(0)
+    , totalTime(0)
+    , maxFrameTime(0)
+    , overBudget(0)
+    , droppedTraceEvents(0)
+{
+    memset(&current, 0, sizeof(current));
+    memset(history, 0, sizeof(history));
+    memset(phaseTime, 0, sizeof(phaseTime));
+    memset(entities, 0, sizeof(entities));
+}
+
+void FrameProfiler::Start(bool withTrace, int frames)
+{
+    trace      = withTrace;
+    framesLeft = Q_max(frames, 0);
+    startTime  = qcclock_t::now();
+    inFrame    = false;
+    depth      = 0;
+
+    memset(&current, 0, sizeof(current));
+    memset(history, 0, sizeof(history));
+    memset(phaseTime, 0, sizeof(phaseTime));
+    memset(entities, 0, sizeof(entities));
+    numFrames    = 0;
+    totalTime    = 0;
+    maxFrameTime = 0;
+    overBudget   = 0;
+
+    classes.FreeObjectList();
+    classIndex.clear();
+
+    traceEvents.FreeObjectList();
+    droppedTraceEvents = 0;
+    if (trace) {
+        traceEvents.Resize(FRAMEPROFILER_MAX_TRACE_EVENTS);
+    }
+
+    active = true;
+}
+
+void FrameProfiler::Stop()
+{
+    active     = false;
+    inFrame    = false;
+    framesLeft = 0;
+    depth      = 0;
+}
+
+uint64_t FrameProfiler::ElapsedNs(qctime_t begin, qctime_t end) const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+}
+
+void FrameProfiler::AddStat(frameProfileStat_t& stat, uint64_t elapsed)
+{
+    stat.time += elapsed;
+    stat.calls++;
+    if (elapsed > stat.maxTime) {
+        stat.maxTime = elapsed;
+    }
+}
+
+void FrameProfiler::AddTraceEvent(const char *name, qctime_t begin, qctime_t end, int entnum)
+{
+    frameProfileTraceEvent_t event;
+
+    if (!trace) {
+        return;
+    }
+
+    if (traceEvents.NumObjects() >= FRAMEPROFILER_MAX_TRACE_EVENTS) {
+        droppedTraceEvents++;
+        return;
+    }
+
+    event.name     = name;
+    event.start    = ElapsedNs(startTime, begin);
+    event.duration = ElapsedNs(begin, end);
+    event.entnum   = entnum;
+    event.frame    = frameNum;
+    traceEvents.AddObject(event);
+}
+
+void FrameProfiler::BeginFrame()
+{
+    memset(&current, 0, sizeof(current));
+
+    inFrame    = true;
+    depth      = 0;
+    frameNum   = level.framenum;
+    frameStart = qcclock_t::now();
+}
+
+void FrameProfiler::EndFrame()
+{
+    qctime_t now;
+    int      i;
+
+    if (!inFrame) {
+        return;
+    }
+
+    now           = qcclock_t::now();
+    current.total = ElapsedNs(frameStart, now);
+
+    history[numFrames % FRAMEPROFILER_HISTORY] = current;
+    numFrames++;
+
+    totalTime += current.total;
+    for (i = 0; i < FPP_NUM_PHASES; i++) {
+        phaseTime[i] += current.phases[i];
+    }
+
+    if (current.total > maxFrameTime) {
+        maxFrameTime = current.total;
+    }
+
+    if (level.frametime > 0 && current.total > (uint64_t)(level.frametime * 1000000000.0)) {
+        overBudget++;
+    }
+
+    AddTraceEvent("frame", frameStart, now, -1);
+    inFrame = false;
+
+    if (framesLeft && !--framesLeft) {
+        Stop();
+        PrintReport(20);
+    }
+}
+
+void FrameProfiler::BeginPhase(frameProfilePhase_t phase)
+{
+    frameProfileScope_t *scope;
+    qctime_t             now;
+
+    if (depth >= FRAMEPROFILER_MAX_DEPTH) {
+        // too deep, account it to the outer phase
+        depth++;
+        return;
+    }
+
+    now = qcclock_t::now();
+
+    if (depth) {
+        // pause the outer phase
+        scope = &scopes[depth - 1];
+        current.phases[scope->phase] += ElapsedNs(scope->resume, now);
+    }
+
+    scope         = &scopes[depth++];
+    scope->phase  = phase;
+    scope->begin  = now;
+    scope->resume = now;
+}
+
+void FrameProfiler::EndPhase()
+{
+    frameProfileScope_t *scope;
+    qctime_t             now;
+
+    if (!depth) {
+        return;
+    }
+
+    if (depth > FRAMEPROFILER_MAX_DEPTH) {
+        depth--;
+        return;
+    }
+
+    now   = qcclock_t::now();
+    scope = &scopes[--depth];
+
+    current.phases[scope->phase] += ElapsedNs(scope->resume, now);
+    AddTraceEvent(frameProfilePhaseNames[scope->phase], scope->begin, now, -1);
+
+    if (depth) {
+        scopes[depth - 1].resume = now;
+    }
+}
+
+qctime_t FrameProfiler::BeginEntity() const
+{
+    return qcclock_t::now();
+}
+
+void FrameProfiler::EndEntity(int entnum, ClassDef *classDef, qctime_t start)
+{
+    qctime_t now;
+    uint64_t elapsed;
+    int     *index;
+
+    now     = qcclock_t::now();
+    elapsed = ElapsedNs(start, now);
+
+    entities[entnum].classDef = classDef;
+    AddStat(entities[entnum].stat, elapsed);
+
+    index = classIndex.find(classDef);
+    if (!index) {
+        frameProfileClass_t cls;
+
+        memset(&cls, 0, sizeof(cls));
+        cls.classDef = classDef;
+
+        index  = &classIndex[classDef];
+        *index = classes.AddObject(cls);
+    }
+
+    AddStat(classes.ObjectAt(*index).stat, elapsed);
+
+    AddTraceEvent(classDef->classname, start, now, entnum);
+}
+
+static int FrameProfiler_CompareTimes(const void *a, const void *b)
+{
+    const uint64_t timeA = *(const uint64_t *)a;
+    const uint64_t timeB = *(const uint64_t *)b;
+
+    if (timeA != timeB) {
+        return timeA < timeB ? -1 : 1;
+    }
+
+    return 0;
+}
+
+//
+// Prints the average and the percentiles of the frames in history,
+// phase -1 being the whole frame
+//
+static void FrameProfiler_PrintPercentiles(
+    const char *name, const frameProfileFrame_t *history, int count, int phase, uint64_t total, int numFrames
+)
+{
+    uint64_t times[FRAMEPROFILER_HISTORY];
+    int      i;
+
+    for (i = 0; i < count; i++) {
+        times[i] = phase == -1 ? history[i].total : history[i].phases[phase];
+    }
+
+    qsort(times, count, sizeof(times[0]), FrameProfiler_CompareTimes);
+
+    gi.Printf(
+        "%-10s %8.3f %8.3f %8.3f %8.3f %8.3f\n",
+        name,
+        total / 1000000.0 / numFrames,
+        times[(count - 1) * 50 / 100] / 1000000.0,
+        times[(count - 1) * 95 / 100] / 1000000.0,
+        times[(count - 1) * 99 / 100] / 1000000.0,
+        times[count - 1] / 1000000.0
+    );
+}
+
+static const frameProfileStat_t *const *sortedStats;
+
+static int FrameProfiler_CompareStats(const void *a, const void *b)
+{
+    const frameProfileStat_t *statA = sortedStats[*(const int *)a];
+    const frameProfileStat_t *statB = sortedStats[*(const int *)b];
+
+    if (statA->time != statB->time) {
+        return statA->time < statB->time ? 1 : -1;
+    }
+
+    return *(const int *)a - *(const int *)b;
+}
+
+static void FrameProfiler_SortStats(Container<int>& order, const frameProfileStat_t *const *stats, int count)
+{
+    int i;
+
+    for (i = 0; i < count; i++) {
+        if (stats[i]->calls) {
+            order.AddObject(i);
+        }
+    }
+
+    sortedStats = stats;
+    order.Sort(FrameProfiler_CompareStats);
+    sortedStats = NULL;
+}
+
+void FrameProfiler::PrintReport(int maxLines)
+{
+    Container<int>             order;
+    const frameProfileStat_t **stats;
+    uint64_t                   otherTime;
+    int                        count;
+    int                        i;
+
+    if (!numFrames) {
+        gi.Printf("Frame profile: no frame recorded\n");
+        return;
+    }
+
+    count = Q_min(numFrames, FRAMEPROFILER_HISTORY);
+
+    gi.Printf(
+        "Frame profile: %d frames, %.3f ms total, %u frames over budget, longest %.3f ms\n",
+        numFrames,
+        totalTime / 1000000.0,
+        overBudget,
+        maxFrameTime / 1000000.0
+    );
+
+    gi.Printf("\nPercentiles over the last %d frames (ms):\n", count);
+    gi.Printf("phase           avg      p50      p95      p99      max\n");
+    FrameProfiler_PrintPercentiles("frame", history, count, -1, totalTime, numFrames);
+
+    otherTime = totalTime;
+    for (i = 0; i < FPP_NUM_PHASES; i++) {
+        FrameProfiler_PrintPercentiles(frameProfilePhaseNames[i], history, count, i, phaseTime[i], numFrames);
+        otherTime -= Q_min(otherTime, phaseTime[i]);
+    }
+    gi.Printf("%-10s %8.3f\n", "other", otherTime / 1000000.0 / numFrames);
+
+    //
+    // by class
+    //
+    stats = (const frameProfileStat_t **)gi.Malloc(sizeof(*stats) * Q_max(classes.NumObjects(), MAX_GENTITIES));
+
+    for (i = 0; i < classes.NumObjects(); i++) {
+        stats[i] = &classes.ObjectAt(i + 1).stat;
+    }
+    FrameProfiler_SortStats(order, stats, classes.NumObjects());
+
+    gi.Printf("\nBy class:\n");
+    gi.Printf("  time (ms)      %%    calls  avg (us)  max (us)  class\n");
+
+    for (i = 1; i <= order.NumObjects() && i <= maxLines; i++) {
+        const frameProfileClass_t& cls = classes.ObjectAt(order.ObjectAt(i) + 1);
+
+        gi.Printf(
+            "%11.3f %6.2f %8u %9.2f %9.2f  %s\n",
+            cls.stat.time / 1000000.0,
+            totalTime ? cls.stat.time * 100.0 / totalTime : 0.0,
+            cls.stat.calls,
+            cls.stat.time / 1000.0 / cls.stat.calls,
+            cls.stat.maxTime / 1000.0,
+            cls.classDef->classname
+        );
+    }
+
+    //
+    // by entity
+    //
+    order.ClearObjectList();
+    for (i = 0; i < MAX_GENTITIES; i++) {
+        stats[i] = &entities[i].stat;
+    }
+    FrameProfiler_SortStats(order, stats, MAX_GENTITIES);
+
+    gi.Printf("\nBy entity:\n");
+    gi.Printf("  time (ms)      %%    calls  avg (us)  max (us)  entnum  class  targetname\n");
+
+    for (i = 1; i <= order.NumObjects() && i <= maxLines; i++) {
+        const int                   entnum = order.ObjectAt(i);
+        const frameProfileEntity_t& info   = entities[entnum];
+        const Entity               *ent    = G_GetEntity(entnum);
+
+        gi.Printf(
+            "%11.3f %6.2f %8u %9.2f %9.2f  %6d  %s  %s\n",
+            info.stat.time / 1000000.0,
+            totalTime ? info.stat.time * 100.0 / totalTime : 0.0,
+            info.stat.calls,
+            info.stat.time / 1000.0 / info.stat.calls,
+            info.stat.maxTime / 1000.0,
+            entnum,
+            info.classDef->classname,
+            // the number may have been reused since
+            ent && ent->classinfo() == info.classDef ? ent->targetname.c_str() : ""
+        );
+    }
+
+    gi.Free(stats);
+}
+
+bool FrameProfiler::WriteChromeTrace(const char *filename)
+{
+    fileHandle_t file;
+    str          line;
+    int          i;
+
+    file = gi.FS_FOpenFileWrite(filename);
+    if (!file) {
+        return false;
+    }
+
+    line = "{\"traceEvents\":[\n"
+           "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"game\"}}";
+    gi.FS_Write(line.c_str(), line.length(), file);
+
+    for (i = 1; i <= traceEvents.NumObjects(); i++) {
+        const frameProfileTraceEvent_t& event = traceEvents.ObjectAt(i);
+
+        // microseconds
+        line = va(
+            ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1,"
+            "\"args\":{\"frame\":%d",
+            event.name,
+            event.entnum == -1 ? "game" : "entity",
+            event.start / 1000.0,
+            event.duration / 1000.0,
+            event.frame
+        );
+
+        if (event.entnum != -1) {
+            line += va(",\"entnum\":%d", event.entnum);
+        }
+
+        line += "}}";
+        gi.FS_Write(line.c_str(), line.length(), file);
+    }
+
+    line = "\n]}\n";
+    gi.FS_Write(line.c_str(), line.length(), file);
+    gi.FS_FCloseFile(file);
+
+    if (droppedTraceEvents) {
+        gi.Printf("Trace buffer was full, %u events were dropped\n", droppedTraceEvents);
+    }
+
+    return true;
+}
@@ -0,0 +1,197 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// frameprofiler.h: Game frame profiler, time per phase, class and entity
+
+#pragma once
+
+#include "g_local.h"
+#include "container.h"
+#include "con_set.h"
+#include "class.h"
+
+#define FRAMEPROFILER_HISTORY          1024 // frames kept for the percentiles
+#define FRAMEPROFILER_MAX_DEPTH        16
+#define FRAMEPROFILER_MAX_TRACE_EVENTS 262144
+
+typedef enum {
+    FPP_EVENTS,
+    FPP_SCRIPTS,
+    FPP_POSES,
+    FPP_THINK,
+    FPP_PHYSICS,
+    FPP_SNAPSHOT,
+    FPP_NUM_PHASES
+} frameProfilePhase_t;
+
+struct frameProfileStat_t {
+    uint64_t     time;    // nanoseconds
+    uint64_t     maxTime; // longest single run
+    unsigned int calls;
+};
+
+struct frameProfileClass_t {
+    ClassDef          *classDef;
+    frameProfileStat_t stat;
+};
+
+struct frameProfileEntity_t {
+    ClassDef          *classDef; // last class seen with this number
+    frameProfileStat_t stat;
+};
+
+struct frameProfileFrame_t {
+    uint64_t total;
+    uint64_t phases[FPP_NUM_PHASES];
+};
+
+struct frameProfileScope_t {
+    int      phase;
+    qctime_t begin;  // when the phase was entered
+    qctime_t resume; // when the phase last became the innermost one
+};
+
+//
+// Complete event of the Chrome trace format
+//
+struct frameProfileTraceEvent_t {
+    const char *name;
+    uint64_t    start; // nanoseconds since the profiler was started
+    uint64_t    duration;
+    int         entnum; // -1 for frames and phases
+    int         frame;
+};
+
+class FrameProfiler
+{
+public:
+    FrameProfiler();
+
+    bool IsActive() const;
+    void Start(bool trace, int numFrames = 0);
+    void Stop();
+
+    //
+    // Called by the game loop
+    //
+    void     BeginFrame();
+    void     EndFrame();
+    void     BeginPhase(frameProfilePhase_t phase);
+    void     EndPhase();
+    qctime_t BeginEntity() const;
+    void     EndEntity(int entnum, ClassDef *classDef, qctime_t start);
+
+    //
+    // Reports
+    //
+    void PrintReport(int maxLines);
+    bool WriteChromeTrace(const char *filename);
+
+private:
+    void     AddStat(frameProfileStat_t& stat, uint64_t elapsed);
+    void     AddTraceEvent(const char *name, qctime_t begin, qctime_t end, int entnum);
+    uint64_t ElapsedNs(qctime_t begin, qctime_t end) const;
+
+private:
+    bool     active;
+    bool     inFrame;
+    bool     trace;
+    int      framesLeft;
+    int      frameNum;
+    qctime_t startTime;
+    qctime_t frameStart;
+
+    frameProfileScope_t scopes[FRAMEPROFILER_MAX_DEPTH];
+    int                 depth;
+
+    frameProfileFrame_t current;
+    frameProfileFrame_t history[FRAMEPROFILER_HISTORY];
+    int                 numFrames;
+    uint64_t            totalTime;
+    uint64_t            phaseTime[FPP_NUM_PHASES];
+    uint64_t            maxFrameTime;
+    unsigned int        overBudget;
+
+    frameProfileEntity_t               entities[MAX_GENTITIES];
+    Container<frameProfileClass_t>     classes;
+    con_map<const void *, int>         classIndex;
+    Container<frameProfileTraceEvent_t> traceEvents;
+    unsigned int                        droppedTraceEvents;
+};
+
+extern FrameProfiler frameProfiler;
+
+inline bool FrameProfiler::IsActive() const
+{
+    return active;
+}
+
+//
+// Times the enclosing block as a phase of the frame, does nothing
+// while the profiler is stopped
+//
+class FrameProfilePhase
+{
+public:
+    FrameProfilePhase(frameProfilePhase_t phase)
+        : active(frameProfiler.IsActive())
+    {
+        if (active) {
+            frameProfiler.BeginPhase(phase);
+        }
+    }
+
+    ~FrameProfilePhase()
+    {
+        if (active) {
+            frameProfiler.EndPhase();
+        }
+    }
+
+private:
+    bool active;
+};
+
+//
+// Times the enclosing block as a whole game frame
+//
+class FrameProfileFrame
+{
+public:
+    FrameProfileFrame()
+        : active(frameProfiler.IsActive())
+    {
+        if (active) {
+            frameProfiler.BeginFrame();
+        }
+    }
+
+    ~FrameProfileFrame()
+    {
+        if (active) {
+            frameProfiler.EndFrame();
+        }
+    }
+
+private:
+    bool active;
+};
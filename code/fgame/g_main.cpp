@@ -38,13 +38,14 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "smokesprite.h"
 #include "playerbot.h"
 #include "g_bot.h"
+#include "frameprofiler.h"
 #include <tiki.h>
 
 #ifdef WIN32
 #    include <intrin.h>
 #endif
 
-#define SAVEGAME_VERSION   80
+#define SAVEGAME_VERSION   82 // Added in OPM: 81 for the variable access cache slots, 82 for the compare-jump opcodes
 #define PERSISTANT_VERSION 2
 
 static char G_ErrorMessage[4096];
@@ -68,7 +69,6 @@ target_game_e g_target_game = target_game_e::TG_INVALID;
 gentity_t    *g_entities;
 qboolean      g_iInThinks     = 0;
 qboolean      g_bBeforeThinks = qfalse;
-static float  g_fMsecPerClock = 0;
 
 usercmd_t  *current_ucmd;
 usereyes_t *current_eyeinfo;
@@ -326,6 +326,8 @@ void G_ShutdownGame()
 
     level.CleanUp();
 
+    G_ShutdownBotJobs();
+
     L_ShutdownEvents();
 
     G_DeAllocGameData();
@@ -396,22 +398,16 @@ G_AddGEntity
 */
 void G_AddGEntity(gentity_t *edict, qboolean showentnums)
 {
-    unsigned long long start, end;
-    Entity            *ent = edict->entity;
+    Entity *ent = edict->entity;
+
+    if (frameProfiler.IsActive()) {
+        // the entity can be removed while it runs
+        const int      entnum   = ent->entnum;
+        ClassDef      *classDef = ent->classinfo();
+        const qctime_t start    = frameProfiler.BeginEntity();
 
-    if (g_timeents->integer) {
-        start = clock();
         G_RunEntity(ent);
-        end = clock();
-
-        gi.DebugPrintf(
-            "%d: <%s> '%s'(%d) : %d clocks, %.1f msec\n",
-            level.framenum,
-            ent->getClassname(),
-            ent->targetname.c_str(),
-            end - start,
-            g_fMsecPerClock
-        );
+        frameProfiler.EndEntity(entnum, classDef, start);
     } else {
         G_RunEntity(ent);
     }
@@ -448,11 +444,18 @@ void G_RunFrame(int levelTime, int frameTime)
     gentity_t         *edict;
     int                num;
     qboolean           showentnums;
-    unsigned long long start;
-    unsigned long long end;
     static int         processed[MAX_GENTITIES] = {0};
     static int         processedFrameID         = 0;
 
+    // Added in OPM
+    //  g_timeents profiles that many frames and prints the report
+    if (g_timeents->integer > 0) {
+        frameProfiler.Start(false, g_timeents->integer);
+        gi.cvar_set("g_timeents", "0");
+    }
+
+    FrameProfileFrame frameScope;
+
     try {
         g_iInThinks = 0;
 
@@ -499,35 +502,50 @@ void G_RunFrame(int levelTime, int frameTime)
 
         // Process most of the events before the physics are run
         // so that we can affect the physics immediately
-        L_ProcessPendingEvents();
+        {
+            FrameProfilePhase phase(FPP_EVENTS);
+            L_ProcessPendingEvents();
+        }
 
         Director.AllowPause(true);
         Director.Pause();
         Director.SetTime(level.inttime);
 
-        //
-        // treat each object in turn
-        //
-        for (edict = active_edicts.next; edict != &active_edicts; edict = edict->next) {
-            assert(edict);
-            assert(edict->inuse);
-            assert(edict->entity);
-
-            Actor *actor = static_cast<Actor *>(edict->entity);
-            if (actor->IsSubclassOfActor()) {
-                actor->m_bUpdateAnimDoneFlags = false;
-                if (actor->m_bAnimating) {
-                    actor->PreAnimate();
+        {
+            FrameProfilePhase phase(FPP_POSES);
+
+            //
+            // treat each object in turn
+            //
+            for (edict = active_edicts.next; edict != &active_edicts; edict = edict->next) {
+                assert(edict);
+                assert(edict->inuse);
+                assert(edict->entity);
+
+                Actor *actor = static_cast<Actor *>(edict->entity);
+                if (actor->IsSubclassOfActor()) {
+                    actor->m_bUpdateAnimDoneFlags = false;
+                    if (actor->m_bAnimating) {
+                        actor->PreAnimate();
+                    }
                 }
             }
         }
 
-        g_iInThinks++;
-        Director.Unpause();
-        g_iInThinks--;
+        {
+            FrameProfilePhase phase(FPP_SCRIPTS);
+
+            g_iInThinks++;
+            Director.Unpause();
+            g_iInThinks--;
+        }
 
-        // Process any pending events that got posted during the script code
-        L_ProcessPendingEvents();
+        {
+            FrameProfilePhase phase(FPP_EVENTS);
+
+            // Process any pending events that got posted during the script code
+            L_ProcessPendingEvents();
+        }
 
         path_checksthisframe = 0;
 
@@ -557,13 +575,11 @@ void G_RunFrame(int levelTime, int frameTime)
             }
         }
 
-        if (g_timeents->integer) {
-            g_fMsecPerClock = 1.0f / gi.Cvar_Get("CPS", "1", 0)->value;
-            start           = clock();
+        {
+            FrameProfilePhase phase(FPP_THINK);
+            G_BotFrame();
         }
 
-        G_BotFrame();
-
         for (edict = active_edicts.next; edict != &active_edicts; edict = edict->next) {
             for (num = edict->s.parent; num != ENTITYNUM_NONE; num = g_entities[num].s.parent) {
                 if (processed[num] == processedFrameID) {
@@ -580,32 +596,36 @@ void G_RunFrame(int levelTime, int frameTime)
             }
         }
 
-        if (g_timeents->integer) {
-            gi.cvar_set("g_timeents", va("%d", g_timeents->integer - 1));
-            end = clock();
-
-            gi.DebugPrintf(
-                "\n%i total: %d (%.1f)\n-----------------------\n",
-                level.framenum,
-                end - start,
-                static_cast<float>(end - start) * g_fMsecPerClock
-            );
-        }
-
         g_iInThinks--;
         g_bBeforeThinks = qfalse;
 
-        // Process any pending events that got posted during the physics code.
-        L_ProcessPendingEvents();
+        {
+            FrameProfilePhase phase(FPP_EVENTS);
+
+            // Process any pending events that got posted during the physics code.
+            L_ProcessPendingEvents();
+        }
+
         level.DoEarthquakes();
 
-        // build the playerstate_t structures for all players
-        G_ClientEndServerFrames();
+        {
+            FrameProfilePhase phase(FPP_SNAPSHOT);
+
+            // build the playerstate_t structures for all players
+            G_ClientEndServerFrames();
+        }
+
+        {
+            FrameProfilePhase phase(FPP_SCRIPTS);
+            level.Unregister(STRING_POSTTHINK);
+        }
 
-        level.Unregister(STRING_POSTTHINK);
+        {
+            FrameProfilePhase phase(FPP_EVENTS);
 
-        // Process any pending events that got posted during the script code
-        L_ProcessPendingEvents();
+            // Process any pending events that got posted during the script code
+            L_ProcessPendingEvents();
+        }
 
         // show how many traces the game code is doing
         if (sv_traceinfo->integer) {
@@ -634,6 +654,9 @@ void G_RunFrame(int levelTime, int frameTime)
 
         level.framenum++;
 
+        // Added in OPM
+        L_EndEventAllocFrame();
+
         if (developer->integer) {
             G_ClientDrawBoundingBoxes();
             G_ClientDrawTags();
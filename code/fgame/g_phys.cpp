@@ -29,6 +29,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "actor.h"
 #include "player.h"
 #include "debuglines.h"
+#include "frameprofiler.h"
 
 /*
 
@@ -165,7 +166,6 @@ Two entities have touched, so run their touch functions
 void G_Impact(Entity *e1, trace_t *trace)
 {
     gentity_t *e2;
-    Event     *ev;
 
     e2 = trace->ent;
 
@@ -173,15 +173,15 @@ void G_Impact(Entity *e1, trace_t *trace)
 
     // touch anything, including the world
     if (e1->edict->solid != SOLID_NOT) {
-        ev = new Event(EV_Touch);
-        ev->AddEntity(e2->entity);
+        Event ev(EV_Touch, 1);
+        ev.AddEntity(e2->entity);
         e1->ProcessEvent(ev);
     }
 
     // entity could have been removed, so check if he's in use before sending the event
     if (e2->entity && (e2->solid != SOLID_NOT) && (!(e2->r.contents & CONTENTS_SHOOTONLY)) && (e2->entity != world)) {
-        ev = new Event(EV_Touch);
-        ev->AddEntity(e1);
+        Event ev(EV_Touch, 1);
+        ev.AddEntity(e1);
         e2->entity->ProcessEvent(ev);
     }
 
@@ -1394,19 +1394,24 @@ void G_RunEntity(Entity *ent)
     }
 
     if (ent->flags & FL_ANIMATE) {
+        FrameProfilePhase phase(FPP_POSES);
         ent->PreAnimate();
     }
 
     if (ent->flags & FL_THINK) {
+        FrameProfilePhase phase(FPP_THINK);
         ent->Think();
     }
 
     if (ent->flags & FL_ANIMATE) {
+        FrameProfilePhase phase(FPP_POSES);
         ent->PostAnimate();
     }
 
     // only run physics if in use and not bound and not immobilized
     if ((edict->s.parent == ENTITYNUM_NONE) && !(ent->flags & FL_IMMOBILE) && !(ent->flags & FL_PARTIAL_IMMOBILE)) {
+        FrameProfilePhase phase(FPP_PHYSICS);
+
         switch (ent->movetype) {
         case MOVETYPE_NONE:
         case MOVETYPE_STATIONARY:
@@ -1437,6 +1442,7 @@ void G_RunEntity(Entity *ent)
     }
 
     if (ent->flags & FL_POSTTHINK) {
+        FrameProfilePhase phase(FPP_THINK);
         ent->Postthink();
     }
 }
@@ -495,6 +495,17 @@ typedef struct gameImport_s {
     // New functions will start from here
     //
 
+    // gathers the entities inside mins/maxs once for the traces that follow,
+    // until EndTraceSession is called
+    void (*BeginTraceSession)(const vec3_t mins, const vec3_t maxs);
+    void (*EndTraceSession)();
+
+    // same as SightTrace with a point, but can be called from several threads
+    // at once as long as no entity is linked, unlinked or moved meanwhile
+    qboolean (*SightTraceConcurrent)(
+        const vec3_t start, const vec3_t end, int passEntityNum, int passEntityNum2, int contentMask
+    );
+
 } game_import_t;
 
 typedef struct gameExport_s {
@@ -101,7 +101,6 @@ void G_TouchTriggers(Entity *ent)
     int        num;
     int        touch[MAX_GENTITIES];
     gentity_t *hit;
-    Event     *ev;
 
     // dead things don't activate triggers!
     if ((ent->client || (ent->edict->r.svFlags & SVF_MONSTER)) && (ent->IsDead())) {
@@ -126,8 +125,8 @@ void G_TouchTriggers(Entity *ent)
 
         assert(hit->entity);
 
-        ev = new Event(EV_Touch);
-        ev->AddEntity(ent);
+        Event ev(EV_Touch, 1);
+        ev.AddEntity(ent);
         hit->entity->ProcessEvent(ev);
     }
 }
@@ -146,7 +145,6 @@ void G_TouchSolids(Entity *ent)
     int        num;
     int        touch[MAX_GENTITIES];
     gentity_t *hit;
-    Event     *ev;
 
     num = gi.AreaEntities(ent->absmin, ent->absmax, touch, MAX_GENTITIES);
 
@@ -162,8 +160,8 @@ void G_TouchSolids(Entity *ent)
 
         //FIXME
         // should we post the events so that we don't have to worry about any entities going away
-        ev = new Event(EV_Touch);
-        ev->AddEntity(ent);
+        Event ev(EV_Touch, 1);
+        ev.AddEntity(ent);
         hit->entity->ProcessEvent(ev);
     }
 }
@@ -35,6 +35,10 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "playerbot.h"
 #include "consoleevent.h"
 #include "g_bot.h"
+#include "scriptexception.h"
+#include "scriptthread.h"
+#include "scriptprofiler.h"
+#include "frameprofiler.h"
 
 typedef struct {
     const char *command;
@@ -70,6 +74,12 @@ consolecmd_t G_ConsoleCmds[] = {
     // Added in OPM
     //====
     {"compilescript",   G_CompileScript,      qfalse},
+    {"scriptbench",     G_ScriptBenchCmd,     qfalse},
+    {"scriptopcodepairs", G_ScriptOpcodePairsCmd, qfalse},
+    {"scriptprofile",   G_ScriptProfileCmd,   qfalse},
+    {"frameprofile",    G_FrameProfileCmd,    qfalse},
+    {"eventallocs",     G_EventAllocsCmd,     qfalse},
+    {"strallocs",       G_StrAllocsCmd,       qfalse},
     {"addbot",          G_AddBotCommand,      qfalse},
     {"removebot",       G_RemoveBotCommand,   qfalse},
 #ifdef _DEBUG
@@ -632,6 +642,358 @@ qboolean G_CompileScript(gentity_t *ent)
     return qtrue;
 }
 
+//
+// Variable accesses of all kinds: local variables, level/game variables,
+// a getter and a setter, and a targetname lookup. The loop protection
+// is written back unchanged
+//
+static const char *G_ScriptBenchSuite = "main:\n"
+                                        "    local.lp = level.loop_protection\n"
+                                        "    for (local.i = 0; local.i < 256; local.i++) {\n"
+                                        "        local.a = local.i\n"
+                                        "        local.b = local.a + 1\n"
+                                        "        level.scriptbench_var = local.b\n"
+                                        "        game.scriptbench_var = level.scriptbench_var\n"
+                                        "        local.c = game.scriptbench_var + local.a\n"
+                                        "        local.t = level.time\n"
+                                        "        local.w = $world\n"
+                                        "        level.loop_protection = local.lp\n"
+                                        "    }\n"
+                                        "    level.scriptbench_var = NIL\n"
+                                        "    game.scriptbench_var = NIL\n"
+                                        "end\n"
+                                        // each access through self or owner fails when they're NULL,
+                                        // the thread must carry on with the next statement
+                                        "errors:\n"
+                                        "    local.resumed = 0\n"
+                                        "    self.scriptbench_var = 1\n"
+                                        "    local.resumed++\n"
+                                        "    local.v = self.scriptbench_var\n"
+                                        "    local.resumed++\n"
+                                        "    self.scriptbench_var = 1\n"
+                                        "    local.v = self.scriptbench_var\n"
+                                        "    local.resumed++\n"
+                                        "    owner.scriptbench_var = 1\n"
+                                        "    local.resumed++\n"
+                                        "    local.v = owner.scriptbench_var\n"
+                                        "    local.resumed++\n"
+                                        "    owner.scriptbench_var = 1\n"
+                                        "    local.v = owner.scriptbench_var\n"
+                                        "    local.resumed++\n"
+                                        "    level.scriptbench_resumed = local.resumed\n"
+                                        "end\n";
+
+// statements the errors label runs after a failed access
+#define SCRIPTBENCH_ERRORS_RESUMED 6
+
+//
+// Run the errors label with a NULL self, then with a self that has no owner,
+// so both the "self is NULL" and the "self.owner is NULL" paths are taken
+//
+static void G_ScriptBenchCheckErrors(GameScript *scr)
+{
+    Listener *const selves[] = {NULL, &level};
+    ScriptThread   *thread;
+    ScriptVariable *resumed;
+    ScriptVariable  nil;
+    int             count;
+    size_t          i;
+
+    for (i = 0; i < ARRAY_LEN(selves); i++) {
+        level.Vars()->SetVariable("scriptbench_resumed", nil);
+
+        thread = Director.CreateThread(scr, "errors", selves[i]);
+        if (thread) {
+            try {
+                thread->Execute();
+            } catch (ScriptException& exc) {
+                gi.Printf("%s\n", exc.string.c_str());
+            }
+        }
+
+        resumed = level.Vars()->GetVariable("scriptbench_resumed");
+        count   = resumed ? resumed->intValue() : 0;
+
+        gi.Printf(
+            "scriptbench: errors with %s: %s (%d/%d statements after a failed access)\n",
+            selves[i] ? "no owner" : "NULL self",
+            count == SCRIPTBENCH_ERRORS_RESUMED ? "passed" : "FAILED",
+            count,
+            SCRIPTBENCH_ERRORS_RESUMED
+        );
+    }
+
+    level.Vars()->SetVariable("scriptbench_resumed", nil);
+    level.Vars()->SetVariable("scriptbench_var", nil);
+}
+
+qboolean G_ScriptBenchCmd(gentity_t *ent)
+{
+    GameScript  *scr;
+    const char  *label;
+    int          iterations;
+    int          startTime;
+    int          elapsed;
+    uint64_t     startCmdCount;
+    uint64_t     numCmds;
+    int          i;
+
+    if (!sv_cheats->integer) {
+        gi.Printf("command not available\n");
+        return qtrue;
+    }
+
+    iterations = 1000;
+    if (gi.Argc() > 1) {
+        iterations = Q_max(atoi(gi.Argv(1)), 1);
+    }
+
+    try {
+        if (gi.Argc() > 2) {
+            scr   = Director.GetGameScript(gi.Argv(2));
+            label = gi.Argc() > 3 ? gi.Argv(3) : "";
+        } else {
+            scr   = Director.GetGameScriptFromBuffer("scriptbench", G_ScriptBenchSuite);
+            label = "main";
+        }
+    } catch (ScriptException& exc) {
+        gi.Printf("Usage: scriptbench [iterations] [filename] [label]\n");
+        gi.Printf("%s\n", exc.string.c_str());
+        return qtrue;
+    }
+
+    startCmdCount = Director.totalCmdCount;
+    startTime     = gi.Milliseconds();
+
+    for (i = 0; i < iterations; i++) {
+        // every run gets the whole execution time before the loop protection kicks in
+        Director.cmdTime  = 0;
+        Director.cmdCount = 0;
+
+        Director.ExecuteThread(scr, label);
+    }
+
+    elapsed = gi.Milliseconds() - startTime;
+    numCmds = Director.totalCmdCount - startCmdCount;
+
+    gi.Printf(
+        "scriptbench: %d runs of '%s', %llu opcodes in %d ms (%.0f opcodes/sec)\n",
+        iterations,
+        scr->Filename().c_str(),
+        (unsigned long long)numCmds,
+        elapsed,
+        elapsed ? numCmds * 1000.0 / elapsed : 0.0
+    );
+
+    if (gi.Argc() <= 2) {
+        G_ScriptBenchCheckErrors(scr);
+    }
+
+    return qtrue;
+}
+
+static int G_CompareOpcodePairs(const void *a, const void *b)
+{
+    const unsigned int countA = Director.opcodePairCounts[*(const int *)a];
+    const unsigned int countB = Director.opcodePairCounts[*(const int *)b];
+
+    if (countA != countB) {
+        return countA < countB ? 1 : -1;
+    }
+
+    return *(const int *)a - *(const int *)b;
+}
+
+static void G_PrintOpcodePairs(int maxPairs)
+{
+    int     *pairs;
+    int      numPairs;
+    uint64_t total;
+    int      i;
+
+    pairs    = new int[OP_MAX * OP_MAX];
+    numPairs = 0;
+    total    = 0;
+
+    for (i = 0; i < OP_MAX * OP_MAX; i++) {
+        if (Director.opcodePairCounts[i]) {
+            pairs[numPairs++] = i;
+            total += Director.opcodePairCounts[i];
+        }
+    }
+
+    qsort(pairs, numPairs, sizeof(int), G_CompareOpcodePairs);
+
+    gi.Printf("%d distinct opcode pairs, %llu in total\n", numPairs, (unsigned long long)total);
+
+    for (i = 0; i < numPairs && i < maxPairs; i++) {
+        const unsigned int count = Director.opcodePairCounts[pairs[i]];
+
+        gi.Printf(
+            "%10u %5.1f%%  %s -> %s\n",
+            count,
+            count * 100.0 / total,
+            OpcodeName(pairs[i] / OP_MAX),
+            OpcodeName(pairs[i] % OP_MAX)
+        );
+    }
+
+    delete[] pairs;
+}
+
+qboolean G_ScriptOpcodePairsCmd(gentity_t *ent)
+{
+    const char *cmd;
+
+    if (gi.Argc() < 2) {
+        gi.Printf("Usage: scriptopcodepairs <start|dump [count]|stop [count]>\n");
+        gi.Printf("Records how often each script opcode is directly followed by another one.\n");
+        return qtrue;
+    }
+
+    cmd = gi.Argv(1);
+
+    if (!Q_stricmp(cmd, "start")) {
+        if (!Director.opcodePairCounts) {
+            Director.opcodePairCounts = new unsigned int[OP_MAX * OP_MAX];
+        }
+
+        memset(Director.opcodePairCounts, 0, sizeof(unsigned int) * OP_MAX * OP_MAX);
+        gi.Printf("Recording script opcode pairs\n");
+        return qtrue;
+    }
+
+    if (!Director.opcodePairCounts) {
+        gi.Printf("Script opcode pairs are not being recorded, use 'scriptopcodepairs start'\n");
+        return qtrue;
+    }
+
+    if (!Q_stricmp(cmd, "dump") || !Q_stricmp(cmd, "stop")) {
+        G_PrintOpcodePairs(gi.Argc() > 2 ? atoi(gi.Argv(2)) : 32);
+    }
+
+    if (!Q_stricmp(cmd, "stop")) {
+        delete[] Director.opcodePairCounts;
+        Director.opcodePairCounts = NULL;
+    }
+
+    return qtrue;
+}
+
+qboolean G_ScriptProfileCmd(gentity_t *ent)
+{
+    const char *cmd;
+
+    if (gi.Argc() < 2) {
+        gi.Printf("Usage: scriptprofile <start [interval]|stop|dump [count]|collapsed <filename>>\n");
+        gi.Printf("Samples 1 script opcode every ~interval (default %d) and reports the time per label and line.\n", SCRIPTPROFILER_DEFAULT_INTERVAL);
+        gi.Printf("'collapsed' writes the samples as collapsed stacks (flamegraph.pl input), in microseconds.\n");
+        return qtrue;
+    }
+
+    cmd = gi.Argv(1);
+
+    if (!Q_stricmp(cmd, "start")) {
+        scriptProfiler.Start(gi.Argc() > 2 ? atoi(gi.Argv(2)) : SCRIPTPROFILER_DEFAULT_INTERVAL);
+        gi.Printf("Script profiler started\n");
+    } else if (!Q_stricmp(cmd, "stop")) {
+        scriptProfiler.Stop();
+        gi.Printf("Script profiler stopped\n");
+    } else if (!Q_stricmp(cmd, "dump")) {
+        scriptProfiler.PrintReport(gi.Argc() > 2 ? atoi(gi.Argv(2)) : 20);
+    } else if (!Q_stricmp(cmd, "collapsed")) {
+        if (gi.Argc() < 3) {
+            gi.Printf("Usage: scriptprofile collapsed <filename>\n");
+        } else if (!scriptProfiler.WriteCollapsedStacks(gi.Argv(2))) {
+            gi.Printf("Couldn't write '%s'\n", gi.Argv(2));
+        } else {
+            gi.Printf("Wrote '%s'\n", gi.Argv(2));
+        }
+    } else {
+        gi.Printf("Unknown scriptprofile command '%s'\n", cmd);
+    }
+
+    return qtrue;
+}
+
+qboolean G_FrameProfileCmd(gentity_t *ent)
+{
+    const char *cmd;
+
+    if (gi.Argc() < 2) {
+        gi.Printf("Usage: frameprofile <start [trace]|frames <count> [trace]|stop|dump [count]|trace <filename>>\n");
+        gi.Printf("Times the game frames per phase, entity class and entity number.\n");
+        gi.Printf("'trace' records every phase and entity run, to be written as a Chrome trace (chrome://tracing).\n");
+        return qtrue;
+    }
+
+    cmd = gi.Argv(1);
+
+    if (!Q_stricmp(cmd, "start")) {
+        frameProfiler.Start(gi.Argc() > 2 && !Q_stricmp(gi.Argv(2), "trace"));
+        gi.Printf("Frame profiler started\n");
+    } else if (!Q_stricmp(cmd, "frames")) {
+        if (gi.Argc() < 3 || atoi(gi.Argv(2)) <= 0) {
+            gi.Printf("Usage: frameprofile frames <count> [trace]\n");
+        } else {
+            frameProfiler.Start(gi.Argc() > 3 && !Q_stricmp(gi.Argv(3), "trace"), atoi(gi.Argv(2)));
+            gi.Printf("Profiling the next %d frames\n", atoi(gi.Argv(2)));
+        }
+    } else if (!Q_stricmp(cmd, "stop")) {
+        frameProfiler.Stop();
+        gi.Printf("Frame profiler stopped\n");
+    } else if (!Q_stricmp(cmd, "dump")) {
+        frameProfiler.PrintReport(gi.Argc() > 2 ? atoi(gi.Argv(2)) : 20);
+    } else if (!Q_stricmp(cmd, "trace")) {
+        if (gi.Argc() < 3) {
+            gi.Printf("Usage: frameprofile trace <filename>\n");
+        } else if (!frameProfiler.WriteChromeTrace(gi.Argv(2))) {
+            gi.Printf("Couldn't write '%s'\n", gi.Argv(2));
+        } else {
+            gi.Printf("Wrote '%s'\n", gi.Argv(2));
+        }
+    } else {
+        gi.Printf("Unknown frameprofile command '%s'\n", cmd);
+    }
+
+    return qtrue;
+}
+
+qboolean G_EventAllocsCmd(gentity_t *ent)
+{
+    if (gi.Argc() > 1 && !Q_stricmp(gi.Argv(1), "reset")) {
+        L_ResetEventAllocStats();
+        gi.Printf("Event allocation counters reset\n");
+        return qtrue;
+    }
+
+    L_PrintEventAllocStats();
+    return qtrue;
+}
+
+//
+// Heap allocations made by the game module's strings. Reset before loading
+// a map and print after playing to measure the string churn
+//
+qboolean G_StrAllocsCmd(gentity_t *ent)
+{
+    if (gi.Argc() > 1 && !Q_stricmp(gi.Argv(1), "reset")) {
+        str::numHeapAllocs   = 0;
+        str::numHeapFrees    = 0;
+        str::numInlineStores = 0;
+        gi.Printf("String allocation counters reset\n");
+        return qtrue;
+    }
+
+    gi.Printf(
+        "str: %zu heap blocks allocated, %zu freed, %zu inline stores\n",
+        str::numHeapAllocs,
+        str::numHeapFrees,
+        str::numInlineStores
+    );
+    return qtrue;
+}
+
 qboolean G_AddBotCommand(gentity_t *ent)
 {
     unsigned int numbots;
@@ -56,6 +56,12 @@ qboolean G_GameVarsCmd(gentity_t* ent);
 qboolean G_ScriptCmd(gentity_t* ent);
 qboolean G_ReloadMap(gentity_t* ent);
 qboolean G_CompileScript(gentity_t *ent);
+qboolean G_ScriptBenchCmd(gentity_t *ent);
+qboolean G_ScriptOpcodePairsCmd(gentity_t *ent);
+qboolean G_ScriptProfileCmd(gentity_t *ent);
+qboolean G_FrameProfileCmd(gentity_t *ent);
+qboolean G_EventAllocsCmd(gentity_t *ent);
+qboolean G_StrAllocsCmd(gentity_t *ent);
 qboolean G_AddBotCommand(gentity_t *ent);
 qboolean G_RemoveBotCommand(gentity_t *ent);
 #ifdef _DEBUG
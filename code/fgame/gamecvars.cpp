@@ -158,6 +158,9 @@ cvar_t *g_ai_notifyradius;
 cvar_t *g_ai_noticescale;
 cvar_t *g_ai_soundscale;
 cvar_t *ai_debug_grenades;
+cvar_t *ai_lod;
+cvar_t *ai_loddist;
+cvar_t *ai_lodinterval;
 
 cvar_t *g_warmup;
 cvar_t *g_doWarmup;
@@ -280,6 +283,9 @@ cvar_t *sv_minPlayers;
 //  because when a client connects and the slot is used by a bot
 //  the bot will be relocated to a free entity slot
 cvar_t *sv_sharedbots;
+// The number of threads making the bot sight traces,
+//  1 makes them on the main thread while the bots decide
+cvar_t *sv_botthreads;
 
 cvar_t *g_rankedserver;
 cvar_t *g_spectatefollow_firstperson;
@@ -455,6 +461,12 @@ void CVAR_Init(void)
     g_ai_soundscale   = gi.Cvar_Get("g_ai_soundscale", "1", 0);
     ai_debug_grenades = gi.Cvar_Get("ai_debug_grenades", "0", CVAR_CHEAT);
 
+    // Added in OPM
+    //  Actors that are far from all clients or out of their view think less often
+    ai_lod         = gi.Cvar_Get("ai_lod", "0", 0);
+    ai_loddist     = gi.Cvar_Get("ai_loddist", "3072", 0);
+    ai_lodinterval = gi.Cvar_Get("ai_lodinterval", "250", 0);
+
     g_gametype       = gi.Cvar_Get("g_gametype", "0", CVAR_USERINFO | CVAR_SERVERINFO | CVAR_LATCH);
     g_gametypestring = gi.Cvar_Get("g_gametypestring", "Free-For-All", CVAR_SERVERINFO);
     g_realismmode    = gi.Cvar_Get("g_realismmode", "0", CVAR_USERINFO | CVAR_SERVERINFO | CVAR_LATCH);
@@ -657,6 +669,7 @@ void CVAR_Init(void)
     sv_sharedbots                = gi.Cvar_Get("sv_sharedbots", "0", CVAR_LATCH);
     sv_numbots                   = gi.Cvar_Get("sv_numbots", "0", 0);
     sv_minPlayers                = gi.Cvar_Get("sv_minPlayers", "0", 0);
+    sv_botthreads                = gi.Cvar_Get("sv_botthreads", "1", 0);
     g_rankedserver               = gi.Cvar_Get("g_rankedserver", "0", 0);
     g_spectatefollow_firstperson = gi.Cvar_Get("g_spectatefollow_firstperson", "0", 0);
 
@@ -163,6 +163,9 @@ extern cvar_t *g_ai_notifyradius;
 extern cvar_t *g_ai_noticescale;
 extern cvar_t *g_ai_soundscale;
 extern cvar_t *ai_debug_grenades;
+extern cvar_t *ai_lod;
+extern cvar_t *ai_loddist;
+extern cvar_t *ai_lodinterval;
 
 extern cvar_t *g_warmup;
 extern cvar_t *g_doWarmup;
@@ -272,6 +275,7 @@ extern cvar_t *sv_maxbots;
 extern cvar_t *sv_numbots;
 extern cvar_t *sv_minPlayers;
 extern cvar_t *sv_sharedbots;
+extern cvar_t *sv_botthreads;
 extern cvar_t *g_rankedserver;
 extern cvar_t *g_spectatefollow_firstperson;
 
@@ -30,6 +30,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "scriptclass.h"
 #include "scriptexception.h"
 #include "level.h"
+#include "scriptprofiler.h"
 
 static unsigned char *current_progBuffer = NULL;
 
@@ -324,6 +325,9 @@ GameScript::GameScript()
 
     requiredStackSize = 0;
 
+    m_VarCaches    = NULL;
+    m_NumVarCaches = 0;
+
     m_State.m_Parent = this;
 }
 
@@ -342,6 +346,9 @@ GameScript::GameScript(const char *filename)
 
     requiredStackSize = 0;
 
+    m_VarCaches    = NULL;
+    m_NumVarCaches = 0;
+
     m_State.m_Parent = this;
 }
 
@@ -454,6 +461,11 @@ void ArchiveOpcode(Archiver& arc, unsigned char *code)
             *reinterpret_cast<unsigned int *>(code + 1) = index;
             archivedPointerFixup.AddObject(p);
         }
+
+        if (*code != OP_STORE_STRING) {
+            // inline cache slot
+            arc.ArchiveUnsigned(reinterpret_cast<unsigned int *>(code + 1 + sizeof(op_name_t)));
+        }
         break;
 
     default:
@@ -686,6 +698,9 @@ void GameScript::ArchiveCodePos(Archiver& arc, unsigned char **codePos)
 
 void GameScript::Close(void)
 {
+    // Added in OPM
+    scriptProfiler.ForgetCode();
+
     for (int i = m_CatchBlocks.NumObjects(); i > 0; i--) {
         delete m_CatchBlocks.ObjectAt(i);
     }
@@ -702,6 +717,12 @@ void GameScript::Close(void)
         m_ProgBuffer = NULL;
     }
 
+    if (m_VarCaches) {
+        gi.Free(m_VarCaches);
+        m_VarCaches = NULL;
+    }
+    m_NumVarCaches = 0;
+
     if (m_SourceBuffer) {
         gi.Free(m_SourceBuffer);
         m_SourceBuffer = NULL;
@@ -754,6 +775,12 @@ void GameScript::Load(const void *sourceBuffer, size_t sourceLength)
 
     requiredStackSize = Compiler.m_iInternalMaxVarStackOffset + 9 * Compiler.m_iMaxExternalVarStackOffset + 1;
 
+    m_NumVarCaches = Compiler.m_iNumVarCaches;
+    if (m_NumVarCaches) {
+        m_VarCaches = (ScriptVarCache *)gi.Malloc(sizeof(ScriptVarCache) * m_NumVarCaches);
+        memset(m_VarCaches, 0, sizeof(ScriptVarCache) * m_NumVarCaches);
+    }
+
     successCompile = true;
 }
 
@@ -39,6 +39,14 @@ typedef struct {
     bool      isprivate; // new script engine implementation
 } script_label_t;
 
+// Added in OPM
+//  Inline cache of a variable opcode.
+//  Remembers how the variable name resolved for the last class accessed.
+struct ScriptVarCache {
+    ClassDef    *classDef;
+    unsigned int eventNum; // 0 for a plain variable
+};
+
 struct sourceinfo_t {
     unsigned int sourcePos;
     unsigned int startLinePos;
@@ -133,6 +141,11 @@ public:
     // stack variables
     unsigned int requiredStackSize;
 
+    // Added in OPM
+    //  inline caches of the variable opcodes
+    ScriptVarCache *m_VarCaches;
+    unsigned int    m_NumVarCaches;
+
 public:
     GameScript();
     GameScript(const char *filename);
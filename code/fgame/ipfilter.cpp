@@ -29,6 +29,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 // 
 // The ip address is specified in dot format, and any unspecified digits will match 
 // any value, so you can specify an entire class C network with "addip 192.246.40".
+// A CIDR suffix can be given as well, like "addip 192.246.40.0/22".
 // 
 // Removeip will only remove an address specified exactly the same way.  You cannot 
 // addip a subnet, then removeip a single host.
@@ -52,17 +53,52 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "ipfilter.h"
 #include "g_local.h"
+#include "container.h"
+#include "iptrie.h"
 
 typedef struct
    {
-	unsigned	mask;
-	unsigned	compare;
+	byte	addr[ 4 ];
+	int	bits;
    } ipfilter_t;
 
-#define	MAX_IPFILTERS	1024
+//
+// Added in OPM
+//  The filters are matched with a prefix trie rather than going
+//  through the list, which is only kept for listip and writeip
+//
+Container< ipfilter_t > ipfilters;
+ipTrie_t                ipfilterTrie;
+
+static void *G_IPFilterAlloc
+   (
+   size_t size
+   )
 
-ipfilter_t	ipfilters[ MAX_IPFILTERS ];
-int			numipfilters;
+   {
+   return gi.Malloc( size );
+   }
+
+static void G_IPFilterFree
+   (
+   void *ptr
+   )
+
+   {
+   gi.Free( ptr );
+   }
+
+static void G_InitIPFilters
+   (
+   void
+   )
+
+   {
+   if ( !ipfilterTrie.alloc )
+      {
+      IPTrie_Init( &ipfilterTrie, G_IPFilterAlloc, G_IPFilterFree );
+      }
+   }
 
 /*
 =================
@@ -80,14 +116,16 @@ static qboolean StringToFilter
 	int	i;
    int   j;
 	byte	b[ 4 ];
-	byte	m[ 4 ];
+   int   bits;
 
 	for( i = 0; i < 4; i++ )
 	   {
 		b[ i ] = 0;
-		m[ i ] = 0;
 	   }
 
+   // unspecified and trailing zero digits match any value
+   bits = 0;
+
 	for( i = 0; i < 4; i++ )
 	   {
 		if ( *s < '0' || *s > '9' )
@@ -106,10 +144,10 @@ static qboolean StringToFilter
 		b[ i ] = atoi( num );
 		if ( b[ i ] != 0 )
          {
-			m[ i ] = 255;
+			bits = ( i + 1 ) * 8;
          }
 
-		if ( !*s )
+		if ( !*s || *s == '/' )
          {
 			break;
          }
@@ -117,8 +155,21 @@ static qboolean StringToFilter
 		s++;
 	   }
 
-	f->mask = *( unsigned * )m;
-	f->compare = *( unsigned * )b;
+   if ( *s == '/' )
+      {
+      bits = atoi( s + 1 );
+      if ( bits < 0 || bits > 32 )
+         {
+         gi.SendServerCommand( 0, "print \"Bad filter mask: %s\n\"", s );
+         return false;
+         }
+      }
+
+	for( i = 0; i < 4; i++ )
+	   {
+		f->addr[ i ] = b[ i ];
+	   }
+   f->bits = bits;
 
 	return true;
    }
@@ -135,10 +186,14 @@ qboolean SV_FilterPacket
 
    {
 	int i;
-	unsigned	in;
 	byte m[ 4 ];
 	const char *p;
 
+	for( i = 0; i < 4; i++ )
+	   {
+		m[ i ] = 0;
+	   }
+
 	i = 0;
 	p = from;
 	while( *p && i < 4 )
@@ -159,13 +214,11 @@ qboolean SV_FilterPacket
       p++;
 	   }
 
-	in = *( unsigned * )m;
-	for( i = 0; i < numipfilters; i++ )
+	G_InitIPFilters();
+
+	if ( IPTrie_Lookup( &ipfilterTrie, IPTRIE_IPV4, m ) != IPTRIE_NONE )
       {
-		if ( ( in & ipfilters[ i ].mask ) == ipfilters[ i ].compare )
-         {
-         return ( int )filterban->integer;
-         }
+      return ( int )filterban->integer;
       }
 
    return !( int )filterban->integer;
@@ -183,7 +236,7 @@ void SVCmd_AddIP_f
    )
 
    {
-	int i;
+	ipfilter_t	f;
 
 	if ( gi.Argc() < 3 )
       {
@@ -191,29 +244,21 @@ void SVCmd_AddIP_f
 		return;
       }
 
-	for( i = 0; i < numipfilters; i++ )
+	if ( !StringToFilter( gi.Argv( 2 ), &f ) )
       {
-		if ( ipfilters[ i ].compare == 0xffffffff )
-         {
-         // free spot
-			break;
-         }
+		return;
       }
 
-	if ( i == numipfilters )
-	   {
-		if ( numipfilters == MAX_IPFILTERS )
-         {
-         gi.SendServerCommand( 0, "print \"IP filter list is full\n\"" );
-			return;
-		   }
-		numipfilters++;
-	   }
+	G_InitIPFilters();
 
-	if ( !StringToFilter( gi.Argv( 2 ), &ipfilters[ i ] ) )
+	if ( IPTrie_Find( &ipfilterTrie, IPTRIE_IPV4, f.addr, f.bits ) != IPTRIE_NONE )
       {
-		ipfilters[ i ].compare = 0xffffffff;
+      gi.SendServerCommand( 0, "print \"%s is already filtered.\n\"", gi.Argv( 2 ) );
+		return;
       }
+
+	ipfilters.AddObject( f );
+	IPTrie_Insert( &ipfilterTrie, IPTRIE_IPV4, f.addr, f.bits, 0 );
    }
 
 /*
@@ -228,8 +273,8 @@ void SVCmd_RemoveIP_f
 
    {
 	ipfilter_t	f;
+	ipfilter_t	*filter;
 	int			i;
-   int         j;
 
 	if ( gi.Argc() < 3 )
       {
@@ -242,19 +287,22 @@ void SVCmd_RemoveIP_f
 		return;
       }
 
-	for( i = 0; i < numipfilters; i++ )
+	G_InitIPFilters();
+
+	if ( IPTrie_Remove( &ipfilterTrie, IPTRIE_IPV4, f.addr, f.bits ) )
       {
-		if ( ( ipfilters[ i ].mask == f.mask ) && ( ipfilters[ i ].compare == f.compare ) )
+		for( i = 1; i <= ipfilters.NumObjects(); i++ )
 		   {
-			for ( j = i + 1; j < numipfilters; j++ )
+			filter = &ipfilters.ObjectAt( i );
+			if ( filter->bits == f.bits && !memcmp( filter->addr, f.addr, sizeof( f.addr ) ) )
             {
-				ipfilters[ j - 1 ] = ipfilters[ j ];
+				ipfilters.RemoveObjectAt( i );
+				break;
             }
-
-			numipfilters--;
-         gi.SendServerCommand( 0, "print \"Removed.\n\"" );
-			return;
 		   }
+
+      gi.SendServerCommand( 0, "print \"Removed.\n\"" );
+		return;
       }
 
    gi.SendServerCommand( 0, "print \"Didn't find %s.\n\"", gi.Argv( 2 ) );
@@ -272,13 +320,13 @@ void SVCmd_ListIP_f
 
    {
 	int   i;
-	byte	b[ 4 ];
+	ipfilter_t	*f;
 
    gi.SendServerCommand( 0, "print \"Filter list:\n\"", gi.Argv( 2 ) );
-	for( i = 0; i < numipfilters; i++ )
+	for( i = 1; i <= ipfilters.NumObjects(); i++ )
    	{
-		*( unsigned * )b = ipfilters[ i ].compare;
-      gi.SendServerCommand( 0, "print \"%3i.%3i.%3i.%3i\n\"", b[ 0 ], b[ 1 ], b[ 2 ], b[ 3 ] );
+		f = &ipfilters.ObjectAt( i );
+      gi.SendServerCommand( 0, "print \"%3i.%3i.%3i.%3i/%i\n\"", f->addr[ 0 ], f->addr[ 1 ], f->addr[ 2 ], f->addr[ 3 ], f->bits );
 	   }
    }
 
@@ -295,7 +343,7 @@ void SVCmd_WriteIP_f
    {
 	FILE	 *f;
 	char	 name[ MAX_OSPATH ];
-	byte	 b[ 4 ];
+	ipfilter_t *filter;
 	int	 i;
 
 	Com_sprintf( name, sizeof( name ), "%s/listip.cfg", GAMEVERSION );
@@ -310,10 +358,10 @@ void SVCmd_WriteIP_f
 
    fprintf( f, "set filterban %d\n", ( int )filterban->integer );
 
-	for( i = 0; i < numipfilters; i++ )
+	for( i = 1; i <= ipfilters.NumObjects(); i++ )
 	   {
-		*( unsigned * )b = ipfilters[ i ].compare;
-		fprintf( f, "sv addip %i.%i.%i.%i\n", b[ 0 ], b[ 1 ], b[ 2 ], b[ 3 ] );
+		filter = &ipfilters.ObjectAt( i );
+		fprintf( f, "sv addip %i.%i.%i.%i/%i\n", filter->addr[ 0 ], filter->addr[ 1 ], filter->addr[ 2 ], filter->addr[ 3 ], filter->bits );
 	   }
 
 	fclose( f );
@@ -113,14 +113,14 @@ void LODMaster::Spawn
 	Event *ev
 	)
 {
-	const char *mdl;
+	str mdl;
 	Vector forward, up, delta;
 	Entity *ent;
 	LODSlave *m_lodmodel;
 
 	mdl = ev->GetString( 1 );
 
-	if( !mdl || !*mdl )
+	if( !mdl.length() )
 	{
 		ScriptError( "Must specify a model name" );
 	}
@@ -304,8 +304,8 @@ void Player::RemoveClass(Event *ev)
 void Player::TestThread(Event *ev)
 
 {
-    const char *scriptfile;
-    str         label;
+    str scriptfile;
+    str label;
 
     if (ev->NumArgs() < 1) {
         gi.SendServerCommand(edict - g_entities, "print \"Syntax: testthread scriptfile <label>.\n\"");
@@ -621,6 +621,73 @@ static int sentients_compare(const void *elem1, const void *elem2)
     }
 }
 
+/*
+====================
+InSightRange
+
+The checks of Sentient::CanSee that come before the sight trace
+====================
+*/
+bool BotController::InSightRange(Sentient *sent, float fov, float vision_distance)
+{
+    vec2_t delta;
+
+    VectorSub2D(sent->centroid, controlledEnt->centroid, delta);
+
+    if (vision_distance > 0 && Square(vision_distance) < VectorLength2DSquared(delta)) {
+        return false;
+    }
+
+    if (!controlledEnt->AreasConnected(sent)) {
+        return false;
+    }
+
+    if (fov > 0 && fov < 360 && !controlledEnt->FovCheck(delta, cos(DEG2RAD(fov / 2.f)))) {
+        return false;
+    }
+
+    return true;
+}
+
+/*
+====================
+CanSeeSentient
+
+Same as Sentient::CanSee, but the sight trace is shared with the
+other end when both are bots looking at each other this frame
+====================
+*/
+bool BotController::CanSeeSentient(Sentient *sent, float fov, float vision_distance)
+{
+    if (!InSightRange(sent, fov, vision_distance)) {
+        return false;
+    }
+
+    return botManager.getControllerManager().SightTrace(controlledEnt, sent);
+}
+
+/*
+====================
+QueueSights
+
+Queues the sight traces CheckCondition_Attack and State_Attack
+can ask for this frame, the widest of their checks is used
+====================
+*/
+void BotController::QueueSights()
+{
+    float maxDistance = Q_min(world->m_fAIVisionDistance, world->farplane_distance * 0.828);
+    int   i;
+
+    for (i = 1; i <= SentientList.NumObjects(); i++) {
+        Sentient *sent = SentientList.ObjectAt(i);
+
+        if (IsValidEnemy(sent) && InSightRange(sent, 80, maxDistance)) {
+            botManager.getControllerManager().QueueSight(controlledEnt, sent);
+        }
+    }
+}
+
 bool BotController::IsValidEnemy(Sentient *sent) const
 {
     if (sent == controlledEnt) {
@@ -674,7 +741,7 @@ bool BotController::CheckCondition_Attack(void)
 
         maxDistance = Q_min(world->m_fAIVisionDistance, world->farplane_distance * 0.828);
 
-        if (controlledEnt->CanSee(sent, 80, maxDistance, false)) {
+        if (CanSeeSentient(sent, 80, maxDistance)) {
             if (m_pEnemy != sent) {
                 m_iEnemyEyesTag = -1;
             }
@@ -735,8 +802,7 @@ void BotController::State_Attack(void)
 
     m_vOldEnemyPos = m_vLastEnemyPos;
 
-    bCanSee =
-        controlledEnt->CanSee(m_pEnemy, 20, Q_min(world->m_fAIVisionDistance, world->farplane_distance * 0.828), false);
+    bCanSee = CanSeeSentient(m_pEnemy, 20, Q_min(world->m_fAIVisionDistance, world->farplane_distance * 0.828));
     if (bCanSee) {
         if (!pWeap) {
             return;
@@ -1049,11 +1115,35 @@ void BotController::Spawned(void)
 }
 
 void BotController::Think()
+{
+    Decide();
+    Apply();
+}
+
+/*
+====================
+Decide
+
+Updates the states and builds the next usercmd, without moving the bot
+====================
+*/
+void BotController::Decide()
+{
+    UpdateBotStates();
+}
+
+/*
+====================
+Apply
+
+Runs the usercmd built by Decide
+====================
+*/
+void BotController::Apply()
 {
     usercmd_t  ucmd;
     usereyes_t eyeinfo;
 
-    UpdateBotStates();
     GetUsercmd(&ucmd);
     GetEyeInfo(&eyeinfo);
 
@@ -1183,6 +1273,10 @@ const Container<BotController *>& BotControllerManager::getControllers() const
     return controllers;
 }
 
+BotControllerManager::BotControllerManager()
+    : deciding(false)
+{}
+
 BotControllerManager::~BotControllerManager()
 {
     Cleanup();
@@ -1205,6 +1299,8 @@ void BotControllerManager::Cleanup()
     }
 
     controllers.FreeObjectList();
+    sightCache.clear();
+    sightJobs.FreeObjectList();
 }
 
 void BotControllerManager::ThinkControllers()
@@ -1224,8 +1320,165 @@ void BotControllerManager::ThinkControllers()
         }
     }
 
+    //
+    // All the bots decide on the same world state, then all of them move.
+    // Sight traces made while deciding are shared between bots
+    //
+    sightCache.clear();
+
+    if (G_BotJobThreads() > 1) {
+        TraceSights();
+    }
+
+    deciding = true;
+
+    for (i = 1; i <= controllers.NumObjects(); i++) {
+        BotController *controller = controllers.ObjectAt(i);
+        controller->Decide();
+    }
+
+    deciding = false;
+
     for (i = 1; i <= controllers.NumObjects(); i++) {
         BotController *controller = controllers.ObjectAt(i);
-        controller->Think();
+        if (controller->getControlledEntity()) {
+            controller->Apply();
+        }
+    }
+}
+
+/*
+====================
+SightKey
+
+The eye to eye trace doesn't depend on which end it starts from
+====================
+*/
+static int SightKey(Sentient *viewer, Sentient *target)
+{
+    if (viewer->entnum < target->entnum) {
+        return viewer->entnum * MAX_GENTITIES + target->entnum;
+    } else {
+        return target->entnum * MAX_GENTITIES + viewer->entnum;
+    }
+}
+
+/*
+====================
+QueueSight
+
+Adds the sight trace between viewer and target to the ones
+made up front, unless it's already there
+====================
+*/
+void BotControllerManager::QueueSight(Sentient *viewer, Sentient *target)
+{
+    botSightJob_t job;
+
+    job.key = SightKey(viewer, target);
+    if (sightCache.find(job.key)) {
+        return;
+    }
+
+    job.start = viewer->EyePosition();
+    job.end   = target->EyePosition();
+    if (job.start == job.end) {
+        // left to SightTrace, the concurrent trace doesn't test a single point
+        return;
+    }
+
+    job.passEntityNum  = viewer->entnum;
+    job.passEntityNum2 = target->entnum;
+    job.visible        = false;
+
+    // filled in by TraceSights
+    sightCache[job.key] = false;
+    sightJobs.AddObject(job);
+}
+
+/*
+====================
+RunSightJob
+====================
+*/
+void BotControllerManager::RunSightJob(int task, void *data)
+{
+    botSightJob_t& job = static_cast<Container<botSightJob_t> *>(data)->ObjectAt(task + 1);
+
+    job.visible =
+        gi.SightTraceConcurrent(job.start, job.end, job.passEntityNum, job.passEntityNum2, MASK_CANSEE) == qtrue;
+}
+
+/*
+====================
+TraceSights
+
+Makes the sight traces the bots are likely to need on all the bot
+threads before they decide. Nothing moves while the jobs run.
+====================
+*/
+void BotControllerManager::TraceSights()
+{
+    int i;
+
+    for (i = 1; i <= controllers.NumObjects(); i++) {
+        controllers.ObjectAt(i)->QueueSights();
     }
+
+    G_RunBotJobs(RunSightJob, &sightJobs, sightJobs.NumObjects());
+
+    for (i = 1; i <= sightJobs.NumObjects(); i++) {
+        const botSightJob_t& job = sightJobs.ObjectAt(i);
+
+        sightCache[job.key] = job.visible;
+
+        sv_numtraces++;
+
+        if (sv_drawtrace->integer) {
+            G_DebugLine(job.start, job.end, 1, 1, 0, 1);
+        }
+    }
+
+    sightJobs.ClearObjectList();
+}
+
+bool BotControllerManager::SightTrace(Sentient *viewer, Sentient *target)
+{
+    bool *visible;
+    int   key;
+
+    if (!deciding) {
+        return G_SightTrace(
+            viewer->EyePosition(),
+            vec_zero,
+            vec_zero,
+            target->EyePosition(),
+            viewer,
+            target,
+            MASK_CANSEE,
+            qfalse,
+            "Sentient::CanSee 1"
+        );
+    }
+
+    key = SightKey(viewer, target);
+
+    visible = sightCache.find(key);
+    if (visible) {
+        return *visible;
+    }
+
+    sightCache[key] = G_SightTrace(
+        viewer->EyePosition(),
+        vec_zero,
+        vec_zero,
+        target->EyePosition(),
+        viewer,
+        target,
+        MASK_CANSEE,
+        qfalse,
+        "Sentient::CanSee 1"
+    );
+
+    return sightCache[key];
 }
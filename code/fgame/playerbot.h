@@ -210,6 +210,9 @@ private:
 
     void CheckStates(void);
 
+    bool InSightRange(Sentient *sent, float fov, float vision_distance);
+    bool CanSeeSentient(Sentient *sent, float fov, float vision_distance);
+
 public:
     CLASS_PROTOTYPE(BotController);
 
@@ -232,6 +235,9 @@ public:
     void SendCommand(const char *text);
 
     void Think();
+    void QueueSights();
+    void Decide();
+    void Apply();
 
     void Spawned(void);
 
@@ -255,6 +261,7 @@ public:
     CLASS_PROTOTYPE(BotControllerManager);
 
 public:
+    BotControllerManager();
     ~BotControllerManager();
 
     BotController                    *createController(Player *player);
@@ -266,8 +273,34 @@ public:
     void Cleanup();
     void ThinkControllers();
 
+    void QueueSight(Sentient *viewer, Sentient *target);
+    bool SightTrace(Sentient *viewer, Sentient *target);
+
+private:
+    void        TraceSights();
+    static void RunSightJob(int task, void *data);
+
 private:
     Container<BotController *> controllers;
+
+    //
+    // Sight traces shared by both ends while the bots are deciding,
+    // nothing moves until all the bots have decided.
+    // Only holds the pairs of the current frame
+    //
+    con_map<int, bool> sightCache;
+    bool               deciding;
+
+    struct botSightJob_t {
+        Vector start;
+        Vector end;
+        int    passEntityNum;
+        int    passEntityNum2;
+        int    key;
+        bool   visible;
+    };
+
+    Container<botSightJob_t> sightJobs;
 };
 
 class BotManager : public Listener
@@ -288,3 +321,12 @@ private:
 };
 
 extern BotManager botManager;
+
+//
+// Worker threads for the bot jobs, see playerbot_jobs.cpp
+//
+typedef void (*botJobFunc_t)(int task, void *data);
+
+int  G_BotJobThreads();
+void G_RunBotJobs(botJobFunc_t func, void *data, int numTasks);
+void G_ShutdownBotJobs();
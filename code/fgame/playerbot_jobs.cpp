@@ -0,0 +1,195 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+// playerbot_jobs.cpp: Worker threads running the bot jobs
+//
+// The main thread takes part in every run, tasks are handed out one at a
+// time and a run returns once all of its tasks are done. A job must not
+// touch the game state nor call anything from gi that isn't made for it,
+// like gi.SightTraceConcurrent.
+//
+
+#include "playerbot.h"
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#define MAX_BOT_THREADS 16
+
+struct botJobs_t {
+    std::mutex              mutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable workersDone;
+    std::thread             workers[MAX_BOT_THREADS - 1];
+    int                     numWorkers;
+    bool                    running;
+    int                     generation; // incremented for each run
+    int                     numBusy;    // workers that haven't finished the current run
+
+    botJobFunc_t     func;
+    void            *data;
+    int              numTasks;
+    std::atomic<int> nextTask;
+};
+
+static botJobs_t *botJobs;
+
+static void G_BotJobs_RunTasks(botJobs_t *jobs)
+{
+    int task;
+
+    while ((task = jobs->nextTask.fetch_add(1, std::memory_order_relaxed)) < jobs->numTasks) {
+        jobs->func(task, jobs->data);
+    }
+}
+
+static void G_BotJobs_Worker(botJobs_t *jobs, int generation)
+{
+    std::unique_lock<std::mutex> lock(jobs->mutex);
+
+    for (;;) {
+        jobs->wakeWorkers.wait(lock, [&] { return !jobs->running || jobs->generation != generation; });
+        if (!jobs->running) {
+            return;
+        }
+
+        generation = jobs->generation;
+
+        lock.unlock();
+        G_BotJobs_RunTasks(jobs);
+        lock.lock();
+
+        if (!--jobs->numBusy) {
+            jobs->workersDone.notify_one();
+        }
+    }
+}
+
+/*
+====================
+G_ShutdownBotJobs
+
+The workers must be gone before the game module is unloaded
+====================
+*/
+void G_ShutdownBotJobs()
+{
+    int i;
+
+    if (!botJobs) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(botJobs->mutex);
+        botJobs->running = false;
+    }
+
+    botJobs->wakeWorkers.notify_all();
+
+    for (i = 0; i < botJobs->numWorkers; i++) {
+        botJobs->workers[i].join();
+    }
+
+    delete botJobs;
+    botJobs = NULL;
+}
+
+/*
+====================
+G_BotJobThreads
+
+Starts or stops workers to match sv_botthreads,
+returns the number of threads a run will use
+====================
+*/
+int G_BotJobThreads()
+{
+    int numThreads;
+    int i;
+
+    numThreads = Q_clamp_int(sv_botthreads->integer, 1, MAX_BOT_THREADS);
+
+    if (botJobs && botJobs->numWorkers == numThreads - 1) {
+        return numThreads;
+    }
+
+    G_ShutdownBotJobs();
+
+    if (numThreads == 1) {
+        return numThreads;
+    }
+
+    botJobs             = new botJobs_t;
+    botJobs->numWorkers = numThreads - 1;
+    botJobs->running    = true;
+    botJobs->generation = 0;
+    botJobs->numBusy    = 0;
+    botJobs->func       = NULL;
+    botJobs->data       = NULL;
+    botJobs->numTasks   = 0;
+    botJobs->nextTask   = 0;
+
+    for (i = 0; i < botJobs->numWorkers; i++) {
+        botJobs->workers[i] = std::thread(G_BotJobs_Worker, botJobs, 0);
+    }
+
+    return numThreads;
+}
+
+/*
+====================
+G_RunBotJobs
+
+Calls func for each task, spread across the bot threads
+====================
+*/
+void G_RunBotJobs(botJobFunc_t func, void *data, int numTasks)
+{
+    int task;
+
+    if (!botJobs || numTasks < 2) {
+        for (task = 0; task < numTasks; task++) {
+            func(task, data);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(botJobs->mutex);
+
+        botJobs->func     = func;
+        botJobs->data     = data;
+        botJobs->numTasks = numTasks;
+        botJobs->nextTask = 0;
+        botJobs->numBusy  = botJobs->numWorkers;
+        botJobs->generation++;
+    }
+
+    botJobs->wakeWorkers.notify_all();
+
+    G_BotJobs_RunTasks(botJobs);
+
+    std::unique_lock<std::mutex> lock(botJobs->mutex);
+    botJobs->workersDone.wait(lock, [] { return !botJobs->numBusy; });
+}
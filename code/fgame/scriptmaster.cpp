@@ -445,6 +445,7 @@ void ScriptMaster::RegisterAliasAndCache(Event *ev)
     int      i;
     char     parameters[MAX_STRING_CHARS];
     char    *psMapsBuffer;
+    str      sMapsBuffer;
     bool     bAlwaysLoaded = false;
 
     if (ev->NumArgs() < 2) {
@@ -475,7 +476,10 @@ void ScriptMaster::RegisterAliasAndCache(Event *ev)
 
         if (!s.icmp("maps")) {
             i++;
-            psMapsBuffer = (char *)ev->GetToken(i).c_str();
+            // Fixed in OPM
+            //  keep the token alive while it's parsed
+            sMapsBuffer  = ev->GetToken(i);
+            psMapsBuffer = (char *)sMapsBuffer.c_str();
             continue;
         }
 
@@ -506,6 +510,7 @@ void ScriptMaster::RegisterAlias(Event *ev)
     int      i;
     char     parameters[MAX_STRING_CHARS];
     char    *psMapsBuffer;
+    str      sMapsBuffer;
     qboolean subtitle;
     bool     bAlwaysLoaded = false;
 
@@ -538,7 +543,10 @@ void ScriptMaster::RegisterAlias(Event *ev)
 
         if (!s.icmp("maps")) {
             i++;
-            psMapsBuffer = (char *)ev->GetToken(i).c_str();
+            // Fixed in OPM
+            //  keep the token alive while it's parsed
+            sMapsBuffer  = ev->GetToken(i);
+            psMapsBuffer = (char *)sMapsBuffer.c_str();
             continue;
         }
 
@@ -764,6 +772,7 @@ void ScriptMaster::Reset(qboolean samemap)
 
         CloseGameScript();
         StringDict.clear();
+        stringDictGeneration++;
         InitConstStrings();
     }
 
@@ -908,6 +917,32 @@ GameScript *ScriptMaster::GetGameScriptInternal(str& filename)
     return scr;
 }
 
+// Added in OPM
+//  compiles a script that doesn't come from a file,
+//  it's kept until the game scripts are closed like any other
+GameScript *ScriptMaster::GetGameScriptFromBuffer(str filename, const char *sourceBuffer)
+{
+    GameScript *scr;
+
+    scr = m_GameScripts[StringDict.findKeyIndex(filename)];
+
+    if (scr != NULL) {
+        return scr;
+    }
+
+    scr = new GameScript(filename);
+
+    m_GameScripts[StringDict.addKeyIndex(filename)] = scr;
+
+    scr->Load(sourceBuffer, strlen(sourceBuffer));
+
+    if (!scr->successCompile) {
+        throw ScriptException("Script '%s' was not properly loaded", filename.c_str());
+    }
+
+    return scr;
+}
+
 GameScript *ScriptMaster::GetGameScript(const_str filename, qboolean recompile)
 {
     return GetGameScript(Director.GetString(filename), recompile);
@@ -1303,3 +1338,20 @@ void ScriptMaster::PrintThread(int iThreadNum)
 
     gi.Printf(status.c_str());
 }
+
+// Added in OPM
+//  counts an executed opcode and the opcode following it in the code,
+//  the most frequent pairs are candidates for compiler superinstructions
+void ScriptMaster::CountOpcodePair(const unsigned char *prevCodePos, const unsigned char *codePos)
+{
+    if (!prevCodePos || *prevCodePos >= OP_MAX || *codePos >= OP_MAX) {
+        return;
+    }
+
+    if (prevCodePos + OpcodeLength(*prevCodePos) != codePos) {
+        // a jump was taken
+        return;
+    }
+
+    opcodePairCounts[*prevCodePos * OP_MAX + *codePos]++;
+}
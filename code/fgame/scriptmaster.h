@@ -58,6 +58,9 @@ public:
     unsigned int cmdCount; // cmd count
     int          cmdTime;  // Elapsed VM execution time
     int          maxTime;  // Maximum VM execution time
+    // Added in OPM
+    uint64_t totalCmdCount; // cmd count since startup, for benchmarks
+    unsigned int *opcodePairCounts; // OP_MAX * OP_MAX counters, only allocated while recording opcode pairs
 
     // Thread variables
     SafePtr<ScriptThread> m_PreviousThread; // parm.previousthread
@@ -69,6 +72,8 @@ public:
     Container<str>         m_menus;    // Script menus
     con_timer              timerList;  // waiting threads list
     con_arrayset<str, str> StringDict; // const strings (improve performance)
+    // Added in OPM
+    unsigned int stringDictGeneration; // incremented every time StringDict is cleared
     int                    iPaused;    // num times paused
 
 protected:
@@ -113,6 +118,7 @@ public:
     GameScript *GetGameScript(str filename, qboolean recompile = false);
     GameScript *GetScript(const_str filename, qboolean recompile = false);
     GameScript *GetScript(str filename, qboolean recompile = false);
+    GameScript *GetGameScriptFromBuffer(str filename, const char *sourceBuffer);
 
     void SetTime(int time);
 
@@ -138,6 +144,9 @@ public:
 
     void PrintStatus(void);
     void PrintThread(int iThreadNum);
+
+    // Added in OPM
+    void CountOpcodePair(const unsigned char *prevCodePos, const unsigned char *codePos);
 };
 
 extern Event EV_RegisterAlias;
@@ -0,0 +1,393 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// scriptprofiler.cpp: Sampling profiler for the script VM
+//
+// Roughly one opcode out of 'interval' is sampled. The wall time of a sampled opcode
+// is measured from its dispatch to the dispatch of the next opcode of the same VM
+// (or to the VM leaving), so it includes the event handlers run by the opcode.
+// Nested VMs started by the opcode (waitthread, exec...) are timed separately
+// and subtracted, their own opcodes being sampled at their level.
+//
+
+#include "scriptprofiler.h"
+#include "scriptmaster.h"
+#include "scriptclass.h"
+#include "gamescript.h"
+
+ScriptProfiler scriptProfiler;
+
+ScriptProfiler::ScriptProfiler()
+    : active(false)
+    , interval(SCRIPTPROFILER_DEFAULT_INTERVAL)
+    , countdown(0)
+    , startCmdCount(0)
+    , numCmds(0)
+{
+    memset(frames, 0, sizeof(frames));
+}
+
+void ScriptProfiler::Start(int newInterval)
+{
+    interval      = Q_max(newInterval, 1);
+    countdown     = NextInterval();
+    startCmdCount = Director.totalCmdCount;
+    numCmds       = 0;
+
+    memset(frames, 0, sizeof(frames));
+    locations.FreeObjectList();
+    locationIndex.clear();
+    codeLocations.clear();
+    stacks.clear();
+
+    active = true;
+}
+
+void ScriptProfiler::Stop()
+{
+    if (!active) {
+        return;
+    }
+
+    numCmds = Director.totalCmdCount - startCmdCount;
+    active  = false;
+
+    memset(frames, 0, sizeof(frames));
+}
+
+int ScriptProfiler::NextInterval()
+{
+    // randomize the interval so loops can't alias with it
+    return interval / 2 + 1 + rand() % interval;
+}
+
+void ScriptProfiler::EnterFrame(ScriptVM *vm, int depth)
+{
+    scriptProfileFrame_t *frame = &frames[depth - 1];
+    int                   i;
+
+    frame->vm              = vm;
+    frame->codePos         = NULL;
+    frame->samplePos       = NULL;
+    frame->hasParentSample = false;
+
+    for (i = depth - 2; i >= 0; i--) {
+        if (frames[i].samplePos) {
+            frame->hasParentSample = true;
+            frame->enterTime       = qcclock_t::now();
+            break;
+        }
+    }
+}
+
+void ScriptProfiler::LeaveFrame(ScriptVM *vm, int depth)
+{
+    scriptProfileFrame_t *frame = &frames[depth - 1];
+    qctime_t              now;
+    int                   i;
+
+    if (frame->vm != vm) {
+        // entered before the profiler was started
+        return;
+    }
+
+    now = qcclock_t::now();
+
+    if (frame->samplePos) {
+        EndSample(depth, now);
+    }
+
+    if (frame->hasParentSample) {
+        for (i = depth - 2; i >= 0; i--) {
+            if (frames[i].samplePos) {
+                frames[i].childTime +=
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now - frame->enterTime).count();
+                break;
+            }
+        }
+    }
+
+    frame->vm      = NULL;
+    frame->codePos = NULL;
+}
+
+void ScriptProfiler::Tick(ScriptVM *vm, int depth, unsigned char *codePos)
+{
+    scriptProfileFrame_t *frame = &frames[depth - 1];
+
+    if (frame->samplePos) {
+        EndSample(depth, qcclock_t::now());
+    }
+
+    frame->vm      = vm;
+    frame->codePos = codePos;
+
+    if (--countdown > 0) {
+        return;
+    }
+
+    countdown = NextInterval();
+
+    frame->samplePos   = codePos;
+    frame->childTime   = 0;
+    frame->sampleStart = qcclock_t::now();
+}
+
+void ScriptProfiler::EndSample(int depth, qctime_t now)
+{
+    scriptProfileFrame_t *frame = &frames[depth - 1];
+    scriptProfileStack_t *stack;
+    str                   stackKey;
+    uint64_t              elapsed;
+    int                   location;
+    int                   i;
+
+    elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - frame->sampleStart).count();
+    elapsed = elapsed > frame->childTime ? elapsed - frame->childTime : 0;
+
+    location = ResolveLocation(frame->vm, frame->samplePos);
+    frame->samplePos = NULL;
+
+    scriptProfileLocation_t& loc = locations.ObjectAt(location);
+    loc.samples++;
+    loc.selfTime += elapsed;
+
+    for (i = 0; i < depth - 1; i++) {
+        if (frames[i].vm && frames[i].codePos) {
+            stackKey += str(ResolveLocation(frames[i].vm, frames[i].codePos)) + ";";
+        } else {
+            // the VM was entered before the profiler was started
+            stackKey += "0;";
+        }
+    }
+    stackKey += str(location);
+
+    stack = &stacks[stackKey];
+    stack->samples++;
+    stack->selfTime += elapsed;
+}
+
+int ScriptProfiler::ResolveLocation(ScriptVM *vm, unsigned char *codePos)
+{
+    int                    *cached;
+    int                    *index;
+    GameScript             *scr;
+    scriptProfileLocation_t loc;
+    str                     key;
+    const_str               label;
+    int                     column;
+
+    cached = codeLocations.find(codePos);
+    if (cached) {
+        return *cached;
+    }
+
+    scr = vm->GetScript();
+
+    loc.file     = scr->Filename();
+    loc.line     = 0;
+    loc.samples  = 0;
+    loc.selfTime = 0;
+
+    label = vm->GetScriptClass()->NearestLabel(codePos);
+    if (label) {
+        loc.label = Director.GetString(label);
+    }
+
+    if (scr->m_ProgToSource && !scr->GetSourceAt(codePos, NULL, column, loc.line)) {
+        loc.line = 0;
+    }
+
+    key = loc.file + ":" + loc.label + ":" + str(loc.line);
+
+    index = locationIndex.find(key);
+    if (!index) {
+        index  = &locationIndex[key];
+        *index = locations.AddObject(loc);
+    }
+
+    codeLocations[codePos] = *index;
+    return *index;
+}
+
+void ScriptProfiler::ForgetCode()
+{
+    // code positions can be reused by the next scripts
+    codeLocations.clear();
+}
+
+static Container<scriptProfileLocation_t> *sortedLocations;
+
+static int ScriptProfiler_CompareLocations(const void *a, const void *b)
+{
+    const scriptProfileLocation_t& locA = sortedLocations->ObjectAt(*(const int *)a);
+    const scriptProfileLocation_t& locB = sortedLocations->ObjectAt(*(const int *)b);
+
+    if (locA.selfTime != locB.selfTime) {
+        return locA.selfTime < locB.selfTime ? 1 : -1;
+    }
+
+    return *(const int *)a - *(const int *)b;
+}
+
+static void ScriptProfiler_PrintLocations(
+    Container<scriptProfileLocation_t>& list, int maxLines, int interval, uint64_t totalTime, bool showLine
+)
+{
+    Container<int> order;
+    int            i;
+
+    for (i = 1; i <= list.NumObjects(); i++) {
+        order.AddObject(i);
+    }
+
+    sortedLocations = &list;
+    order.Sort(ScriptProfiler_CompareLocations);
+    sortedLocations = NULL;
+
+    gi.Printf("  time (ms)      %%    opcodes  samples  location\n");
+
+    for (i = 1; i <= order.NumObjects() && i <= maxLines; i++) {
+        const scriptProfileLocation_t& loc = list.ObjectAt(order.ObjectAt(i));
+
+        if (showLine) {
+            gi.Printf(
+                "%11.3f %6.2f %10u %8u  %s:%s:%d\n",
+                loc.selfTime * (double)interval / 1000000.0,
+                totalTime ? loc.selfTime * 100.0 / totalTime : 0.0,
+                loc.samples * interval,
+                loc.samples,
+                loc.file.c_str(),
+                loc.label.c_str(),
+                loc.line
+            );
+        } else {
+            gi.Printf(
+                "%11.3f %6.2f %10u %8u  %s:%s\n",
+                loc.selfTime * (double)interval / 1000000.0,
+                totalTime ? loc.selfTime * 100.0 / totalTime : 0.0,
+                loc.samples * interval,
+                loc.samples,
+                loc.file.c_str(),
+                loc.label.c_str()
+            );
+        }
+    }
+}
+
+void ScriptProfiler::PrintReport(int maxLines)
+{
+    Container<scriptProfileLocation_t> labels;
+    con_map<str, int>                  labelIndex;
+    uint64_t                           totalTime;
+    unsigned int                       totalSamples;
+    int                                i;
+
+    totalTime    = 0;
+    totalSamples = 0;
+
+    for (i = 1; i <= locations.NumObjects(); i++) {
+        const scriptProfileLocation_t& loc = locations.ObjectAt(i);
+        const str                      key = loc.file + ":" + loc.label;
+        int                           *index;
+
+        totalTime += loc.selfTime;
+        totalSamples += loc.samples;
+
+        index = labelIndex.find(key);
+        if (!index) {
+            scriptProfileLocation_t labelLoc;
+
+            labelLoc.file     = loc.file;
+            labelLoc.label    = loc.label;
+            labelLoc.line     = 0;
+            labelLoc.samples  = 0;
+            labelLoc.selfTime = 0;
+
+            index  = &labelIndex[key];
+            *index = labels.AddObject(labelLoc);
+        }
+
+        labels.ObjectAt(*index).samples += loc.samples;
+        labels.ObjectAt(*index).selfTime += loc.selfTime;
+    }
+
+    gi.Printf(
+        "Script profile: %u samples, 1 per ~%d opcodes, %llu opcodes executed, ~%.3f ms of script time\n",
+        totalSamples,
+        interval,
+        (unsigned long long)(active ? Director.totalCmdCount - startCmdCount : numCmds),
+        totalTime * (double)interval / 1000000.0
+    );
+
+    gi.Printf("\nBy label:\n");
+    ScriptProfiler_PrintLocations(labels, maxLines, interval, totalTime, false);
+
+    gi.Printf("\nBy line:\n");
+    ScriptProfiler_PrintLocations(locations, maxLines, interval, totalTime, true);
+}
+
+bool ScriptProfiler::WriteCollapsedStacks(const char *filename)
+{
+    con_map_enum<str, scriptProfileStack_t> en(stacks);
+    str                                    *key;
+    fileHandle_t                            file;
+
+    file = gi.FS_FOpenFileWrite(filename);
+    if (!file) {
+        return false;
+    }
+
+    for (key = en.NextKey(); key; key = en.NextKey()) {
+        const scriptProfileStack_t *stack = en.CurrentValue();
+        const char                 *p     = key->c_str();
+        str                         line;
+
+        // translate the location numbers into names
+        while (*p) {
+            const int location = atoi(p);
+
+            if (location) {
+                const scriptProfileLocation_t& loc = locations.ObjectAt(location);
+                line += loc.file + ":" + loc.label + ":" + str(loc.line);
+            } else {
+                line += "?";
+            }
+
+            while (*p && *p != ';') {
+                p++;
+            }
+
+            if (*p == ';') {
+                line += ";";
+                p++;
+            }
+        }
+
+        // microseconds
+        line += va(" %llu\n", (unsigned long long)(stack->selfTime * interval / 1000));
+        gi.FS_Write(line.c_str(), line.length(), file);
+    }
+
+    gi.FS_FCloseFile(file);
+    return true;
+}
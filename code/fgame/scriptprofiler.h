@@ -0,0 +1,111 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// scriptprofiler.h: Sampling profiler for the script VM
+
+#pragma once
+
+#include "g_local.h"
+#include "container.h"
+#include "con_set.h"
+#include "scriptvm.h"
+
+#define SCRIPTPROFILER_DEFAULT_INTERVAL 64
+
+//
+// Source location of the sampled opcodes, a script file, label and line
+//
+struct scriptProfileLocation_t {
+    str          file;
+    str          label;
+    int          line;
+    unsigned int samples;
+    uint64_t     selfTime; // nanoseconds spent in the sampled opcodes, nested threads excluded
+};
+
+struct scriptProfileStack_t {
+    unsigned int samples;
+    uint64_t     selfTime;
+};
+
+//
+// One entry per VM nesting level (Director.stackCount)
+//
+struct scriptProfileFrame_t {
+    ScriptVM      *vm;
+    unsigned char *codePos;     // opcode being executed at this level
+    unsigned char *samplePos;   // opcode being sampled, NULL if none
+    qctime_t       sampleStart;
+    qctime_t       enterTime;   // when the VM was entered, while a lower level is sampling
+    uint64_t       childTime;   // time spent in nested VMs during the sample
+    bool           hasParentSample;
+};
+
+class ScriptProfiler
+{
+public:
+    ScriptProfiler();
+
+    bool IsActive() const;
+    void Start(int interval);
+    void Stop();
+
+    //
+    // Called by the VM
+    //
+    void EnterFrame(ScriptVM *vm, int depth);
+    void LeaveFrame(ScriptVM *vm, int depth);
+    void Tick(ScriptVM *vm, int depth, unsigned char *codePos);
+    void ForgetCode();
+
+    //
+    // Reports
+    //
+    void PrintReport(int maxLines);
+    bool WriteCollapsedStacks(const char *filename);
+
+private:
+    void EndSample(int depth, qctime_t now);
+    int  ResolveLocation(ScriptVM *vm, unsigned char *codePos);
+    int  NextInterval();
+
+private:
+    bool     active;
+    int      interval;
+    int      countdown;
+    uint64_t startCmdCount;
+    uint64_t numCmds;
+
+    scriptProfileFrame_t frames[MAX_STACK_DEPTH];
+
+    Container<scriptProfileLocation_t>   locations;
+    con_map<str, int>                    locationIndex;
+    con_map<const unsigned char *, int>  codeLocations; // resolved code positions, emptied when scripts are freed
+    con_map<str, scriptProfileStack_t>   stacks;        // key is the list of location numbers, outermost first
+};
+
+extern ScriptProfiler scriptProfiler;
+
+inline bool ScriptProfiler::IsActive() const
+{
+    return active;
+}
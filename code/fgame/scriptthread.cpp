@@ -3256,13 +3256,19 @@ void ScriptThread::MusicEvent(Event *ev)
 {
     const char *current;
     const char *fallback;
+    str         currentName;
+    str         fallbackName;
 
     current  = NULL;
     fallback = NULL;
-    current  = ev->GetString(1);
+    // Fixed in OPM
+    //  keep the strings alive, the pointers would refer to temporaries
+    currentName = ev->GetString(1);
+    current     = currentName;
 
     if (ev->NumArgs() > 1) {
-        fallback = ev->GetString(2);
+        fallbackName = ev->GetString(2);
+        fallback     = fallbackName;
     }
 
     ChangeMusic(current, fallback, false);
@@ -3292,13 +3298,19 @@ void ScriptThread::ForceMusicEvent(Event *ev)
 {
     const char *current;
     const char *fallback;
+    str         currentName;
+    str         fallbackName;
 
     current  = NULL;
     fallback = NULL;
-    current  = ev->GetString(1);
+    // Fixed in OPM
+    //  keep the strings alive, the pointers would refer to temporaries
+    currentName = ev->GetString(1);
+    current     = currentName;
 
     if (ev->NumArgs() > 1) {
-        fallback = ev->GetString(2);
+        fallbackName = ev->GetString(2);
+        fallback     = fallbackName;
     }
 
     ChangeMusic(current, fallback, true);
@@ -4947,7 +4959,7 @@ void ScriptThread::GetEntArray(Event *ev)
                 continue;
             }
         } else {
-            const char *value = NULL;
+            str value;
 
             returnValue = entity->ProcessEventReturn(event);
 
@@ -4957,10 +4969,6 @@ void ScriptThread::GetEntArray(Event *ev)
 
             value = returnValue.stringValue();
 
-            if (value == NULL) {
-                continue;
-            }
-
             if (strcmp(value, name) != 0) {
                 continue;
             }
@@ -6005,7 +6013,7 @@ void ScriptThread::FileReadPak(Event *ev)
 void ScriptThread::FileList(Event *ev)
 {
     int             i = 0, numArgs = 0;
-    const char     *path = NULL;
+    str             path;
     str             extension;
     int             wantSubs = 0;
     int             numFiles = 0;
@@ -27,8 +27,254 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 Container<SmokeSprite> g_Sprites;
 
+//
+// Added in OPM
+//  Uniform grid over the smoke sprites, so sight queries only
+//  test the sprites in the cells crossed by the line of sight.
+//  Each sprite is linked in every cell its bounding box touches.
+//  The grid is rebuilt after the sprites moved.
+//
+#define SMOKE_GRID_CELL_SIZE 256.f
+#define SMOKE_GRID_HASH_SIZE 1024
+#define SMOKE_GRID_MAX_CELLS 64   // sprites touching more cells are tested by every query
+#define SMOKE_GRID_MAX_STEPS 1024
+
+struct smokeCell_t {
+    int x, y, z;
+    int sprite; // index in g_Sprites
+    int next;   // next entry in the same hash slot, 0 if none
+};
+
+static Container<smokeCell_t> g_SpriteCells;
+static int                    g_SpriteCellHead[SMOKE_GRID_HASH_SIZE];
+static Container<int>         g_SpriteLarge;
+static Container<int>         g_SpriteQueryMark;
+static Container<int>         g_SpriteCandidates;
+static int                    g_SpriteQueryStamp;
+static Vector                 g_SpriteMins;
+static Vector                 g_SpriteMaxs;
+
+static int G_SmokeCellHash(int x, int y, int z)
+{
+    return ((unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u ^ (unsigned int)z * 83492791u)
+         & (SMOKE_GRID_HASH_SIZE - 1);
+}
+
+static int G_SmokeCellCoord(float value)
+{
+    return (int)floor(value / SMOKE_GRID_CELL_SIZE);
+}
+
+static void G_LinkSmokeSprite(int index)
+{
+    const SmokeSprite& sp = g_Sprites.ObjectAt(index);
+    int                mins[3], maxs[3];
+    int                x, y, z;
+    int                i;
+
+    for (i = 0; i < 3; i++) {
+        mins[i] = G_SmokeCellCoord(sp.origin[i] - sp.scale);
+        maxs[i] = G_SmokeCellCoord(sp.origin[i] + sp.scale);
+
+        if (sp.origin[i] - sp.scale < g_SpriteMins[i]) {
+            g_SpriteMins[i] = sp.origin[i] - sp.scale;
+        }
+        if (sp.origin[i] + sp.scale > g_SpriteMaxs[i]) {
+            g_SpriteMaxs[i] = sp.origin[i] + sp.scale;
+        }
+    }
+
+    g_SpriteQueryMark.AddObject(0);
+
+    if ((maxs[0] - mins[0] + 1) * (maxs[1] - mins[1] + 1) * (maxs[2] - mins[2] + 1) > SMOKE_GRID_MAX_CELLS) {
+        g_SpriteLarge.AddObject(index);
+        return;
+    }
+
+    for (x = mins[0]; x <= maxs[0]; x++) {
+        for (y = mins[1]; y <= maxs[1]; y++) {
+            for (z = mins[2]; z <= maxs[2]; z++) {
+                smokeCell_t cell;
+                int         hash;
+
+                hash        = G_SmokeCellHash(x, y, z);
+                cell.x      = x;
+                cell.y      = y;
+                cell.z      = z;
+                cell.sprite = index;
+                cell.next   = g_SpriteCellHead[hash];
+
+                g_SpriteCellHead[hash] = g_SpriteCells.AddObject(cell);
+            }
+        }
+    }
+}
+
+static void G_ClearSmokeGrid()
+{
+    g_SpriteCells.ClearObjectList();
+    g_SpriteLarge.ClearObjectList();
+    g_SpriteQueryMark.ClearObjectList();
+    memset(g_SpriteCellHead, 0, sizeof(g_SpriteCellHead));
+
+    g_SpriteMins = Vector(99999, 99999, 99999);
+    g_SpriteMaxs = Vector(-99999, -99999, -99999);
+}
+
+static void G_BuildSmokeGrid()
+{
+    int i;
+
+    G_ClearSmokeGrid();
+
+    for (i = 1; i <= g_Sprites.NumObjects(); i++) {
+        G_LinkSmokeSprite(i);
+    }
+}
+
+static void G_AddSmokeCandidate(int index)
+{
+    int& mark = g_SpriteQueryMark.ObjectAt(index);
+
+    if (mark != g_SpriteQueryStamp) {
+        mark = g_SpriteQueryStamp;
+        g_SpriteCandidates.AddObject(index);
+    }
+}
+
+static int G_CompareSmokeCandidates(const void *elem1, const void *elem2)
+{
+    return *(const int *)elem1 - *(const int *)elem2;
+}
+
+/*
+====================
+G_GatherSmokeCandidates
+
+Collects, in g_Sprites order, the sprites linked in the cells crossed
+by the segment. Returns false if the segment misses every sprite.
+====================
+*/
+static bool G_GatherSmokeCandidates(const Vector& start, const Vector& end)
+{
+    Vector vDelta = end - start;
+    float  tEnter = 0;
+    float  tExit  = 1;
+    float  tMax[3], tDelta[3];
+    int    cell[3], step[3], last[3];
+    int    i, steps;
+
+    g_SpriteCandidates.ClearObjectList();
+
+    // clip the segment to the bounds of all sprites
+    for (i = 0; i < 3; i++) {
+        if (fabs(vDelta[i]) < 0.0001f) {
+            if (start[i] < g_SpriteMins[i] || start[i] > g_SpriteMaxs[i]) {
+                return false;
+            }
+        } else {
+            float t1 = (g_SpriteMins[i] - start[i]) / vDelta[i];
+            float t2 = (g_SpriteMaxs[i] - start[i]) / vDelta[i];
+
+            if (t1 > t2) {
+                float tmp = t1;
+                t1        = t2;
+                t2        = tmp;
+            }
+
+            tEnter = Q_max(tEnter, t1);
+            tExit  = Q_min(tExit, t2);
+            if (tEnter > tExit) {
+                return false;
+            }
+        }
+    }
+
+    g_SpriteQueryStamp++;
+    if (g_SpriteQueryStamp <= 0) {
+        for (i = 1; i <= g_SpriteQueryMark.NumObjects(); i++) {
+            g_SpriteQueryMark.ObjectAt(i) = 0;
+        }
+        g_SpriteQueryStamp = 1;
+    }
+
+    for (i = 1; i <= g_SpriteLarge.NumObjects(); i++) {
+        G_AddSmokeCandidate(g_SpriteLarge.ObjectAt(i));
+    }
+
+    //
+    // walk the cells crossed by the clipped segment
+    //
+    for (i = 0; i < 3; i++) {
+        float from = start[i] + vDelta[i] * tEnter;
+
+        cell[i] = G_SmokeCellCoord(from);
+        last[i] = G_SmokeCellCoord(start[i] + vDelta[i] * tExit);
+
+        if (vDelta[i] > 0) {
+            step[i]   = 1;
+            tMax[i]   = tEnter + ((cell[i] + 1) * SMOKE_GRID_CELL_SIZE - from) / vDelta[i];
+            tDelta[i] = SMOKE_GRID_CELL_SIZE / vDelta[i];
+        } else if (vDelta[i] < 0) {
+            step[i]   = -1;
+            tMax[i]   = tEnter + (cell[i] * SMOKE_GRID_CELL_SIZE - from) / vDelta[i];
+            tDelta[i] = -SMOKE_GRID_CELL_SIZE / vDelta[i];
+        } else {
+            step[i]   = 0;
+            tMax[i]   = 2;
+            tDelta[i] = 0;
+        }
+    }
+
+    for (steps = 0; steps < SMOKE_GRID_MAX_STEPS; steps++) {
+        int entry;
+
+        for (entry = g_SpriteCellHead[G_SmokeCellHash(cell[0], cell[1], cell[2])]; entry;) {
+            const smokeCell_t& c = g_SpriteCells.ObjectAt(entry);
+
+            if (c.x == cell[0] && c.y == cell[1] && c.z == cell[2]) {
+                G_AddSmokeCandidate(c.sprite);
+            }
+            entry = c.next;
+        }
+
+        if (cell[0] == last[0] && cell[1] == last[1] && cell[2] == last[2]) {
+            break;
+        }
+
+        // step into the next cell along the axis whose boundary is the closest
+        i = 0;
+        if (tMax[1] < tMax[i]) {
+            i = 1;
+        }
+        if (tMax[2] < tMax[i]) {
+            i = 2;
+        }
+
+        if (tMax[i] > tExit) {
+            break;
+        }
+
+        cell[i] += step[i];
+        tMax[i] += tDelta[i];
+    }
+
+    if (steps == SMOKE_GRID_MAX_STEPS) {
+        // degenerate walk, test everything
+        for (i = 1; i <= g_Sprites.NumObjects(); i++) {
+            G_AddSmokeCandidate(i);
+        }
+    }
+
+    // keep the order of g_Sprites, the obfuscation depends on it
+    g_SpriteCandidates.Sort(G_CompareSmokeCandidates);
+
+    return g_SpriteCandidates.NumObjects() > 0;
+}
+
 void G_ResetSmokeSprites() {
     g_Sprites.ClearObjectList();
+    G_ClearSmokeGrid();
 }
 
 void G_ArchiveSmokeSpritesFunction(Archiver& arc, SmokeSprite* sp) {
@@ -48,6 +294,10 @@ void G_ArchiveSmokeSpritesFunction(Archiver& arc, SmokeSprite* sp) {
 
 void G_ArchiveSmokeSprites(Archiver& arc) {
     g_Sprites.Archive(arc, &G_ArchiveSmokeSpritesFunction);
+
+    if (arc.Loading()) {
+        G_BuildSmokeGrid();
+    }
 }
 
 qboolean UpdateSprite(SmokeSprite& sp) {
@@ -98,18 +348,44 @@ qboolean UpdateSprite(SmokeSprite& sp) {
 }
 
 void G_UpdateSmokeSprites() {
-    for (int count = 1; count <= g_Sprites.NumObjects();) {
-        if (UpdateSprite(g_Sprites.ObjectAt(count))) {
-            count++;
-        } else {
-            g_Sprites.RemoveObjectAt(count);
+    int numSprites;
+    int numAlive;
+    int count;
+
+    if (!g_Sprites.NumObjects()) {
+        return;
+    }
+
+    // Expired sprites are dropped in the same pass, the
+    // remaining ones are moved down and keep their order
+    numSprites = g_Sprites.NumObjects();
+    numAlive   = 0;
+
+    for (count = 1; count <= numSprites; count++) {
+        if (!UpdateSprite(g_Sprites.ObjectAt(count))) {
+            continue;
+        }
+
+        numAlive++;
+        if (numAlive != count) {
+            g_Sprites.ObjectAt(numAlive) = g_Sprites.ObjectAt(count);
         }
     }
+
+    while (g_Sprites.NumObjects() > numAlive) {
+        g_Sprites.RemoveObjectAt(g_Sprites.NumObjects());
+    }
+
+    G_BuildSmokeGrid();
 }
 
 void G_AddSmokeSprite(const SmokeSprite* sprite)
 {
-    g_Sprites.AddObject(*sprite);
+    if (!g_Sprites.NumObjects()) {
+        G_ClearSmokeGrid();
+    }
+
+    G_LinkSmokeSprite(g_Sprites.AddObject(*sprite));
 }
 
 float G_ObfuscationForSmokeSprites(float visibilityAlpha, const Vector& start, const Vector& end) {
@@ -119,8 +395,12 @@ float G_ObfuscationForSmokeSprites(float visibilityAlpha, const Vector& start, c
     float fObfuscation = visibilityAlpha;
     int i;
 
-    for (i = 1; i <= g_Sprites.NumObjects(); i++) {
-        const SmokeSprite& sprite = g_Sprites.ObjectAt(i);
+    if (!g_Sprites.NumObjects() || !G_GatherSmokeCandidates(start, end)) {
+        return fObfuscation;
+    }
+
+    for (i = 1; i <= g_SpriteCandidates.NumObjects(); i++) {
+        const SmokeSprite& sprite = g_Sprites.ObjectAt(g_SpriteCandidates.ObjectAt(i));
         Vector vSpriteDelta = sprite.origin - start;
         float fDot = vSpriteDelta * vDir;
         float fTimeAlive;
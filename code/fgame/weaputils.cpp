@@ -2121,6 +2121,71 @@ void BulletAttack_Stat(Entity *owner, Entity *target, trace_t *trace, Weapon *we
     }
 }
 
+/*
+====================
+BulletAttack_BeginTraceSession
+
+Added in OPM
+Encloses all pellets of a multi-shot attack in the cone spanned by the spread,
+so the server gathers the entities along the burst only once.
+Pellets landing outside of the cone still trace normally.
+====================
+*/
+static void BulletAttack_BeginTraceSession(
+    const Vector& start, const Vector& dir, const Vector& right, const Vector& up, float range, const Vector& spread
+)
+{
+    // grandom() is a normal distribution, 3 deviations covers nearly every pellet
+    const float spreadDeviations = 3.f;
+    // VectorNormalizeFast isn't exact
+    const float maxDist = MAX_TRAVEL_DIST * 1.01f;
+    Vector      axis;
+    Vector      corner;
+    Vector      mins, maxs;
+    float       len;
+    float       cosHalfAngle;
+    float       halfAngle;
+    float       axisAngle;
+    int         i;
+
+    axis = dir * range;
+    if (axis.normalize() <= 0) {
+        return;
+    }
+
+    cosHalfAngle = 1.f;
+
+    for (i = 0; i < 4; i++) {
+        corner = dir * range + right * ((i & 1) ? spread.x : -spread.x) * spreadDeviations
+               + up * ((i & 2) ? spread.y : -spread.y) * spreadDeviations;
+
+        len = corner.length();
+        if (len <= 0) {
+            return;
+        }
+
+        cosHalfAngle = Q_min(cosHalfAngle, Vector::Dot(corner, axis) / len);
+    }
+
+    if (cosHalfAngle <= 0) {
+        // too wide to be worth it
+        return;
+    }
+
+    halfAngle = acos(cosHalfAngle);
+
+    for (i = 0; i < 3; i++) {
+        axisAngle = acos(Q_clamp_float(axis[i], -1, 1));
+
+        // furthest reach of the cone on both sides of this axis,
+        // bullets going through things also trace 4 units back
+        maxs[i] = start[i] + Q_max(cos(Q_max(0, axisAngle - halfAngle)) * maxDist, 4) + 2;
+        mins[i] = start[i] - Q_max(cos(Q_max(0, M_PI - axisAngle - halfAngle)) * maxDist, 4) - 2;
+    }
+
+    gi.BeginTraceSession(mins, maxs);
+}
+
 float BulletAttack(
     Vector  start,
     Vector  vBarrel,
@@ -2188,6 +2253,10 @@ float BulletAttack(
         weap = NULL;
     }
 
+    if (count > 1) {
+        BulletAttack_BeginTraceSession(start, dir, right, up, range, spread);
+    }
+
     for (i = 0; i < count; i++) {
         trace_t tracethrough;
 
@@ -2516,6 +2585,10 @@ float BulletAttack(
         }
     }
 
+    if (count > 1) {
+        gi.EndTraceSession();
+    }
+
     if (g_gametype->integer == GT_SINGLE_PLAYER && weap) {
         weap->m_iNumShotsFired++;
         if (owner && owner->IsSubclassOfPlayer() && weap->IsSubclassOfTurretGun()) {
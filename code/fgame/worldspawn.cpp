@@ -546,6 +546,8 @@ World::World()
 {
     world       = this;
     world_dying = qfalse;
+    // Added in OPM
+    m_targetListIndexGeneration = Director.stringDictGeneration;
 
     // Anything that modifies configstrings, or spawns things is ignored when loading savegames
     if (LoadingSavegame) {
@@ -1025,6 +1027,15 @@ Listener *World::GetTarget(str targetname, bool quiet)
 }
 
 Listener *World::GetScriptTarget(str targetname)
+{
+    if (!targetname.length()) {
+        return NULL;
+    }
+
+    return GetScriptTarget(Director.AddString(targetname));
+}
+
+Listener *World::GetScriptTarget(const_str targetname)
 {
     TargetList *targetList = GetTargetList(targetname);
 
@@ -1038,36 +1049,79 @@ Listener *World::GetScriptTarget(str targetname)
         ScriptError(
             "There are %d entities with targetname '%s'. You are using a command that requires exactly one.",
             targetList->list.NumObjects(),
-            targetname.c_str()
+            targetList->targetname.c_str()
         );
     }
 
     return NULL;
 }
 
-TargetList *World::GetExistingTargetList(const str& targetname)
+void World::IndexTargetList(TargetList *targetList)
+{
+    const_str name = Director.AddString(targetList->targetname);
+
+    while (m_targetListIndex.NumObjects() < (int)name) {
+        m_targetListIndex.AddObject(NULL);
+    }
+
+    m_targetListIndex.SetObjectAt(name, targetList);
+}
+
+void World::SyncTargetListIndex()
+{
+    int i;
+
+    if (m_targetListIndexGeneration == Director.stringDictGeneration) {
+        return;
+    }
+
+    //
+    // The string table was cleared, the indexes are no longer valid
+    //
+    m_targetListIndexGeneration = Director.stringDictGeneration;
+    m_targetListIndex.ClearObjectList();
+
+    for (i = 1; i <= m_targetListContainer.NumObjects(); i++) {
+        IndexTargetList(m_targetListContainer.ObjectAt(i));
+    }
+}
+
+TargetList *World::CreateTargetList(const str& targetname)
 {
     TargetList *targetList;
-    int         i;
 
+    targetList = new TargetList(targetname);
+    m_targetListContainer.AddObject(targetList);
+    IndexTargetList(targetList);
+
+    return targetList;
+}
+
+TargetList *World::GetExistingTargetList(const str& targetname)
+{
     if (!targetname.length()) {
         return NULL;
     }
 
-    for (i = m_targetListContainer.NumObjects(); i > 0; i--) {
-        targetList = m_targetListContainer.ObjectAt(i);
-        if (targetname == targetList->targetname) {
-            return targetList;
-        }
+    SyncTargetListIndex();
+
+    return GetExistingTargetList(Director.GetString(targetname.c_str()));
+}
+
+TargetList *World::GetExistingTargetList(const_str targetname)
+{
+    SyncTargetListIndex();
+
+    if (targetname <= STRING_EMPTY || (int)targetname > m_targetListIndex.NumObjects()) {
+        return NULL;
     }
 
-    return NULL;
+    return m_targetListIndex.ObjectAt(targetname);
 }
 
 TargetList *World::GetTargetList(str& targetname)
 {
     TargetList *targetList;
-    int         i;
 
     if (!targetname.length()) {
         // Fixed in OPM
@@ -1075,17 +1129,28 @@ TargetList *World::GetTargetList(str& targetname)
         return NULL;
     }
 
-    for (i = m_targetListContainer.NumObjects(); i > 0; i--) {
-        targetList = m_targetListContainer.ObjectAt(i);
-        if (targetname == targetList->targetname) {
-            return targetList;
-        }
+    targetList = GetExistingTargetList(targetname);
+    if (targetList) {
+        return targetList;
     }
 
-    targetList = new TargetList(targetname);
-    m_targetListContainer.AddObject(targetList);
+    return CreateTargetList(targetname);
+}
 
-    return targetList;
+TargetList *World::GetTargetList(const_str targetname)
+{
+    TargetList *targetList;
+
+    if (targetname <= STRING_EMPTY) {
+        return NULL;
+    }
+
+    targetList = GetExistingTargetList(targetname);
+    if (targetList) {
+        return targetList;
+    }
+
+    return CreateTargetList(Director.GetString(targetname));
 }
 
 void World::AddTargetEntity(SimpleEntity *ent)
@@ -1154,6 +1219,7 @@ void World::FreeTargetList()
     }
 
     m_targetListContainer.FreeObjectList();
+    m_targetListIndex.FreeObjectList();
 }
 
 void World::Archive(Archiver& arc)
@@ -1170,8 +1236,7 @@ void World::Archive(Archiver& arc)
         for (i = 1; i <= num; i++) {
             arc.ArchiveString(&targetname);
 
-            targetList = new TargetList(targetname);
-            m_targetListContainer.AddObject(targetList);
+            targetList = CreateTargetList(targetname);
 
             arc.ArchiveObjectPosition((LightClass *)&targetList->list);
             arc.ArchiveInteger(&num2);
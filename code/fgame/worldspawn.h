@@ -100,6 +100,17 @@ class World : public Entity
     Container<TargetList*> m_targetListContainer;
     qboolean world_dying;
 
+    // Added in OPM
+    //  Direct-index table from the interned targetname to its list.
+    //  It is rebuilt when the Director's string table is cleared.
+    Container<TargetList*> m_targetListIndex;
+    unsigned int           m_targetListIndexGeneration;
+
+private:
+    void        IndexTargetList(TargetList *targetList);
+    void        SyncTargetListIndex();
+    TargetList *CreateTargetList(const str& targetname);
+
 public:
     // farplane variables
     float    farplane_distance;
@@ -146,11 +157,15 @@ public:
 
     SimpleEntity *GetNextEntity(str targetname, SimpleEntity *ent);
     Listener     *GetScriptTarget(str targetname);
+    Listener     *GetScriptTarget(const_str targetname); // Added in OPM
     Listener     *GetTarget(str targetname, bool quiet);
     int           GetTargetnameIndex(SimpleEntity *ent);
 
     TargetList *GetExistingTargetList(const str& targetname);
     TargetList *GetTargetList(str& targetname);
+    // Added in OPM
+    TargetList *GetExistingTargetList(const_str targetname);
+    TargetList *GetTargetList(const_str targetname);
 
     void SetFarClipOverride(Event *ev);
     void SetFarPlaneColorOverride(Event *ev);
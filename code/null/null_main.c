@@ -83,6 +83,10 @@ int		Sys_Milliseconds (void) {
 	return 0;
 }
 
+unsigned long long	Sys_Microseconds (void) {
+	return 0;
+}
+
 qboolean	Sys_Mkdir (const char *path) {
 	return qfalse;
 }
@@ -619,7 +619,7 @@ qboolean CM_TraceThroughFence(traceWork_t *tw, cbrush_t *brush, cbrushside_t *si
     fT = DotProduct(vPos, side->pEq->fTeq) + side->pEq->fTeq[3];
     fT = fT - floor(fT);
 
-    if (cm_FCMdebug->integer) {
+    if (cm_FCMdebug->integer && !tw->concurrent) {
         Com_Printf(
             "Trace ST coords: (%.2f %.2f) or (%i %i)\n",
             fS,
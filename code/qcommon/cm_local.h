@@ -212,6 +212,7 @@ typedef struct {
 	float		radius;
 	int			contents;	// ored contents of the model tracing through
 	qboolean	isPoint;	// optimized case
+	qboolean	concurrent;	// other threads may be tracing, leave the shared marks and debug state alone
 	trace_t		trace;		// returned from trace call
 } traceWork_t;
 
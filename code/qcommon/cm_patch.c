@@ -1321,12 +1321,14 @@ void CM_TracePointThroughPatchCollide( traceWork_t *tw, const struct patchCollid
 		if ( j == facet->numBorders ) {
 			// we hit this facet
 #ifndef BSPC
-			if (!cv) {
-				cv = Cvar_Get( "r_debugSurfaceUpdate", "1", 0 );
-			}
-			if (cv->integer) {
-				debugPatchCollide = pc;
-				debugFacet = facet;
+			if (!tw->concurrent) {
+				if (!cv) {
+					cv = Cvar_Get( "r_debugSurfaceUpdate", "1", 0 );
+				}
+				if (cv->integer) {
+					debugPatchCollide = pc;
+					debugFacet = facet;
+				}
 			}
 #endif //BSPC
 			planes = &pc->planes[facet->surfacePlane];
@@ -1460,12 +1462,14 @@ void CM_TraceThroughPatchCollide( traceWork_t *tw, const struct patchCollide_s *
 		if (enterFrac <= leaveFrac && enterFrac >= 0) {
 			if (enterFrac < tw->trace.fraction) {
 #ifndef BSPC
-				if (!cv) {
-					cv = Cvar_Get( "r_debugSurfaceUpdate", "1", 0 );
-				}
-				if (cv && cv->integer) {
-					debugPatchCollide = pc;
-					debugFacet = facet;
+				if (!tw->concurrent) {
+					if (!cv) {
+						cv = Cvar_Get( "r_debugSurfaceUpdate", "1", 0 );
+					}
+					if (cv && cv->integer) {
+						debugPatchCollide = pc;
+						debugFacet = facet;
+					}
 				}
 #endif //BSPC
 
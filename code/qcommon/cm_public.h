@@ -55,6 +55,12 @@ qboolean	CM_BoxSightTrace( const vec3_t start, const vec3_t end,
 qboolean	CM_TransformedBoxSightTrace( const vec3_t start, const vec3_t end,
 										 const vec3_t mins, const vec3_t maxs,
 										 clipHandle_t model, int brushmask, const vec3_t origin, const vec3_t angles, qboolean cylinder );
+// point sight traces that can run on several threads at once
+qboolean	CM_ConcurrentSightTrace( const vec3_t start, const vec3_t end,
+									 clipHandle_t model, int brushmask, const vec3_t origin, const vec3_t angles );
+qboolean	CM_ConcurrentBoxSightTrace( const vec3_t start, const vec3_t end,
+										const vec3_t mins, const vec3_t maxs, int contents,
+										int brushmask, const vec3_t origin, const vec3_t angles );
 void		CM_BoxTrace ( trace_t *results, const vec3_t start, const vec3_t end,
 						  const vec3_t mins, const vec3_t maxs,
 						  clipHandle_t model, int brushmask, int cylinder );
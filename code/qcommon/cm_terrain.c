@@ -51,7 +51,8 @@ typedef struct pointtrace_s {
 } pointtrace_t;
 
 varnodeIndex_t      g_vni[2][8][8][2];
-static pointtrace_t g_trace;
+// per thread so concurrent sight traces can go through terrain
+static Q_THREAD_LOCAL pointtrace_t g_trace;
 
 static int modeTable[] = {2, 2, 5, 6, 4, 3, 0, 0};
 
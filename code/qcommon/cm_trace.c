@@ -1558,7 +1558,9 @@ qboolean CM_SightTraceThroughBrush( traceWork_t *tw, cbrush_t *brush )
 	enterFrac = -1.0;
 	leaveFrac = 1.0;
 
-	c_brush_traces++;
+	if( !tw->concurrent ) {
+		c_brush_traces++;
+	}
 
 	startout = qfalse;
 
@@ -1781,10 +1783,12 @@ qboolean CM_SightTraceToLeaf( traceWork_t *tw, cLeaf_t *leaf ) {
 	// test box position against all brushes in the leaf
 	for( k = 0; k<leaf->numLeafBrushes; k++ ) {
 		b = &cm.brushes[ cm.leafbrushes[ leaf->firstLeafBrush + k ] ];
-		if( b->checkcount == cm.checkcount ) {
-			continue;	// already checked this brush in another leaf
+		if( !tw->concurrent ) {
+			if( b->checkcount == cm.checkcount ) {
+				continue;	// already checked this brush in another leaf
+			}
+			b->checkcount = cm.checkcount;
 		}
-		b->checkcount = cm.checkcount;
 
 		if( !( b->contents & tw->contents ) ) {
 			continue;
@@ -1806,10 +1810,12 @@ qboolean CM_SightTraceToLeaf( traceWork_t *tw, cLeaf_t *leaf ) {
 			if( !patch ) {
 				continue;
 			}
-			if( patch->checkcount == cm.checkcount ) {
-				continue;	// already checked this brush in another leaf
+			if( !tw->concurrent ) {
+				if( patch->checkcount == cm.checkcount ) {
+					continue;	// already checked this brush in another leaf
+				}
+				patch->checkcount = cm.checkcount;
 			}
-			patch->checkcount = cm.checkcount;
 
 			if( !( patch->contents & tw->contents ) ) {
 				continue;
@@ -1827,10 +1833,12 @@ qboolean CM_SightTraceToLeaf( traceWork_t *tw, cLeaf_t *leaf ) {
 		if( !terrain ) {
 			continue;
 		}
-		if( terrain->checkcount == cm.checkcount ) {
-			continue;
+		if( !tw->concurrent ) {
+			if( terrain->checkcount == cm.checkcount ) {
+				continue;
+			}
+			terrain->checkcount = cm.checkcount;
 		}
-		terrain->checkcount = cm.checkcount;
 
 		if( !CM_SightTraceThroughTerrain( tw, terrain ) ) {
 			return qfalse;
@@ -2167,3 +2175,138 @@ qboolean CM_TransformedBoxSightTrace( const vec3_t start, const vec3_t end, cons
 	// sweep the box through the model
 	return CM_BoxSightTrace( start_l, end_l, symetricSize[ 0 ], symetricSize[ 1 ], model, brushmask, cylinder );
 }
+
+/*
+===============================================================================
+
+CONCURRENT SIGHT TRACES
+
+Added in OPM.
+Point sight traces that can run on several threads at once, as long as
+nothing in the clip map changes while they run. They skip the checkcount
+marks, so a brush reached from more than one leaf is tested again, and
+they leave the statistics and the debug state alone. A trace that starts
+and ends at the same point is reported as clear.
+
+===============================================================================
+*/
+
+/*
+==================
+CM_InitConcurrentSightTrace
+
+Sets up a point trace in the frame of a model at origin/angles
+==================
+*/
+static void CM_InitConcurrentSightTrace( traceWork_t *tw, const vec3_t start, const vec3_t end, int brushmask, const vec3_t origin, const vec3_t angles )
+{
+	vec3_t	forward, left, up;
+	vec3_t	temp;
+	int		i;
+
+	Com_Memset( tw, 0, sizeof( *tw ) );
+	tw->trace.fraction = 1;
+	tw->contents = brushmask;
+	tw->isPoint = qtrue;
+	tw->concurrent = qtrue;
+
+	VectorSubtract( start, origin, tw->start );
+	VectorSubtract( end, origin, tw->end );
+
+	if( angles[ 0 ] || angles[ 1 ] || angles[ 2 ] ) {
+		AngleVectorsLeft( angles, forward, left, up );
+
+		VectorCopy( tw->start, temp );
+		tw->start[ 0 ] = DotProduct( temp, forward );
+		tw->start[ 1 ] = DotProduct( temp, left );
+		tw->start[ 2 ] = DotProduct( temp, up );
+
+		VectorCopy( tw->end, temp );
+		tw->end[ 0 ] = DotProduct( temp, forward );
+		tw->end[ 1 ] = DotProduct( temp, left );
+		tw->end[ 2 ] = DotProduct( temp, up );
+	}
+
+	for( i = 0; i < 3; i++ ) {
+		if( tw->start[ i ] < tw->end[ i ] ) {
+			tw->bounds[ 0 ][ i ] = tw->start[ i ];
+			tw->bounds[ 1 ][ i ] = tw->end[ i ];
+		}
+		else {
+			tw->bounds[ 0 ][ i ] = tw->end[ i ];
+			tw->bounds[ 1 ][ i ] = tw->start[ i ];
+		}
+	}
+}
+
+/*
+==================
+CM_ConcurrentSightTrace
+
+Same as CM_TransformedBoxSightTrace with a point, model can't be the temp box
+==================
+*/
+qboolean CM_ConcurrentSightTrace( const vec3_t start, const vec3_t end, clipHandle_t model, int brushmask, const vec3_t origin, const vec3_t angles )
+{
+	traceWork_t	tw;
+	cmodel_t	*cmod;
+
+	if( !cm.numNodes ) {
+		return qfalse;
+	}
+
+	CM_InitConcurrentSightTrace( &tw, start, end, brushmask, origin, angles );
+
+	if( model ) {
+		cmod = CM_ClipHandleToModel( model );
+		return CM_SightTraceToLeaf( &tw, &cmod->leaf );
+	}
+
+	return CM_SightTraceThroughTree( &tw, 0, 0, 1, tw.start, tw.end );
+}
+
+/*
+==================
+CM_ConcurrentBoxSightTrace
+
+Same as CM_TransformedBoxSightTrace with a point against
+CM_TempBoxModel( mins, maxs, contents ), the box is built
+on the stack instead of the shared box model
+==================
+*/
+qboolean CM_ConcurrentBoxSightTrace( const vec3_t start, const vec3_t end, const vec3_t mins, const vec3_t maxs, int contents, int brushmask, const vec3_t origin, const vec3_t angles )
+{
+	traceWork_t		tw;
+	cbrush_t		brush;
+	cbrushside_t	sides[ 6 ];
+	cplane_t		planes[ 6 ];
+	int				i;
+
+	if( !( contents & brushmask ) ) {
+		return qtrue;
+	}
+
+	// same sides as CM_InitBoxHull
+	Com_Memset( sides, 0, sizeof( sides ) );
+	Com_Memset( planes, 0, sizeof( planes ) );
+
+	for( i = 0; i < 6; i++ ) {
+		planes[ i ].type = ( i & 1 ) ? 3 + ( i >> 1 ) : i >> 1;
+		planes[ i ].normal[ i >> 1 ] = ( i & 1 ) ? -1 : 1;
+		planes[ i ].dist = ( i & 1 ) ? -mins[ i >> 1 ] : maxs[ i >> 1 ];
+		SetPlaneSignbits( &planes[ i ] );
+
+		sides[ i ].plane = &planes[ i ];
+	}
+
+	Com_Memset( &brush, 0, sizeof( brush ) );
+	brush.contents = contents;
+	brush.numsides = 6;
+	brush.sides = sides;
+	VectorCopy( mins, brush.bounds[ 0 ] );
+	VectorCopy( maxs, brush.bounds[ 1 ] );
+
+	CM_InitConcurrentSightTrace( &tw, start, end, brushmask, origin, angles );
+
+	return CM_SightTraceThroughBrush( &tw, &brush );
+}
@@ -388,6 +388,36 @@ static void CM_TraceDeepSuccess( trace_t *results, const vec3_t vStart, const ve
 	results->ent = NULL;
 }
 
+/*
+==================
+CM_GetHitLocationBone
+
+Added in OPM
+Hit location names are searched in the global bone name table
+only once, every deep trace then just maps them to the local bone
+==================
+*/
+static int CM_GetHitLocationBone( dtiki_t *tiki, int iLocation )
+{
+	static int		iHitLocationChannel[ MAX_HITLOCATIONS ];
+	static qboolean	bHitLocationChannel[ MAX_HITLOCATIONS ];
+	int				iChannel;
+
+	if( !bHitLocationChannel[ iLocation ] )
+	{
+		iChannel = skeletor_c::m_boneNames.FindNameLookup( szLocArray[ iLocation ] );
+		if( iChannel < 0 ) {
+			// no model registered this bone yet
+			return -1;
+		}
+
+		iHitLocationChannel[ iLocation ] = iChannel;
+		bHitLocationChannel[ iLocation ] = qtrue;
+	}
+
+	return tiki->m_boneList.LocalChannel( iHitLocationChannel[ iLocation ] );
+}
+
 /*
 ==================
 SV_TraceDeep_DebugDraw
@@ -503,7 +533,7 @@ void SV_TraceDeep( trace_t *results, const vec3_t vStart, const vec3_t vEnd, int
 	for( iLocation = 0; iLocation < MAX_HITLOCATIONS; iLocation++ )
 	{
 		pszTagName = CM_GetHitLocationInfo( iLocation, &fRad, vOffset );
-		iBoneNum = tiki->GetBoneNumFromName( pszTagName );
+		iBoneNum = CM_GetHitLocationBone( tiki, iLocation );
 
 		if( iBoneNum == -1 ) {
 			continue;
@@ -594,7 +624,7 @@ qboolean CL_TraceDeep( trace_t *results, const vec3_t vStart, const vec3_t vEnd,
 	for( iLocation = 0; iLocation < MAX_HITLOCATIONS; iLocation++ )
 	{
 		pszTagName = CM_GetHitLocationInfo( iLocation, &fRad, vOffset );
-		iBoneNum = tiki->GetBoneNumFromName( pszTagName );
+		iBoneNum = CM_GetHitLocationBone( tiki, iLocation );
 
 		if( iBoneNum == -1 ) {
 			continue;
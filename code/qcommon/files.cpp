@@ -33,6 +33,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "qcommon.h"
 #include "unzip.h"
 
+#include <atomic>
+
 #ifndef _WIN32
 #   include <sys/types.h>
 #   include <sys/stat.h>
@@ -258,7 +260,9 @@ static	cvar_t		*fs_microsoftstorepath;
 static	cvar_t		*fs_basepath;
 static	cvar_t		*fs_basegame;
 static	searchpath_t	*fs_searchpaths;
-static	int			fs_readCount;			// total bytes read
+// Added in OPM
+//  Atomic as the stream decode thread reads files as well
+static	std::atomic<int>	fs_readCount;		// total bytes read
 static	int			fs_loadCount;			// total files read
 static	int			fs_loadStack;			// total files in memory
 static	int			fs_packFiles = 0;		// total number of files in packs
@@ -1611,7 +1615,7 @@ size_t FS_Read( void *buffer, size_t len, fileHandle_t f ) {
 	}
 
 	buf = (byte *)buffer;
-	fs_readCount += len;
+	fs_readCount.fetch_add((int)len, std::memory_order_relaxed);
 
 	if (fsh[f].zipFile == qfalse) {
 		remaining = len;
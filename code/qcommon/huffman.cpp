@@ -27,7 +27,9 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "q_shared.h"
 #include "qcommon.h"
 
-static int			bloc = 0;
+// Added in OPM
+//  one cursor per thread, the adaptive coder can be used from several threads
+static thread_local int	bloc = 0;
 
 void	Huff_putBit( int bit, byte *fout, int *offset) {
 	bloc = *offset;
@@ -340,6 +342,171 @@ void Huff_offsetTransmit (huff_t *huff, int ch, byte *fout, int *offset, int max
 	*offset = bloc;
 }
 
+/*
+==================
+Huff_BuildTable
+
+Added in OPM
+Precomputes the code of every symbol and a lookup table decoding
+HUFF_LOOKUP_BITS bits at once. The tree must not be updated afterwards
+==================
+*/
+void Huff_BuildTable(huff_t *huff, huffTable_t *table) {
+	node_t			*node;
+	unsigned int	code;
+	int				length;
+	int				ch;
+	int				i;
+
+	Com_Memset(table, 0, sizeof(*table));
+	table->tree = huff->tree;
+
+	for (ch = 0; ch <= HMAX; ch++) {
+		node = huff->loc[ch];
+		if (!node) {
+			continue;
+		}
+
+		// walk up to the root, the bit nearest to the root is sent first
+		code = 0;
+		length = 0;
+		for (; node->parent; node = node->parent) {
+			if (length == HUFF_MAX_CODE_BITS) {
+				Com_Error(ERR_FATAL, "Huff_BuildTable: code of symbol %i is longer than %i bits", ch, HUFF_MAX_CODE_BITS);
+			}
+			code = (code << 1) | (node->parent->right == node ? 1 : 0);
+			length++;
+		}
+
+		table->code[ch] = code;
+		table->length[ch] = length;
+	}
+
+	for (i = 0; i < (1 << HUFF_LOOKUP_BITS); i++) {
+		node = huff->tree;
+		for (length = 0; length < HUFF_LOOKUP_BITS && node && node->symbol == INTERNAL_NODE; length++) {
+			node = ((i >> length) & 1) ? node->right : node->left;
+		}
+
+		if (node && node->symbol != INTERNAL_NODE) {
+			table->lookup[i] = (unsigned short)(node->symbol | (length << 9));
+		}
+	}
+}
+
+/*
+==================
+Huff_tableReceive
+
+Added in OPM
+Same as Huff_offsetReceive, using the lookup table
+==================
+*/
+void Huff_tableReceive(const huffTable_t *table, int *ch, const byte *fin, int *offset, int maxoffset) {
+	const node_t	*node;
+	int				entry;
+	int				pos;
+
+	pos = *offset;
+
+	if (pos + HUFF_LOOKUP_BITS <= maxoffset) {
+		entry = table->lookup[Huff_getBits(fin, HUFF_LOOKUP_BITS, &pos)];
+		if (entry >> 9) {
+			*ch = entry & 0x1ff;
+			*offset += entry >> 9;
+			return;
+		}
+		pos = *offset;
+	}
+
+	// near the end of the message or a long code
+	node = table->tree;
+	while (node && node->symbol == INTERNAL_NODE) {
+		if (pos >= maxoffset) {
+			*ch = 0;
+			*offset = maxoffset + 1;
+			return;
+		}
+		if ((fin[pos >> 3] >> (pos & 7)) & 1) {
+			node = node->right;
+		} else {
+			node = node->left;
+		}
+		pos++;
+	}
+	if (!node) {
+		*ch = 0;
+		return;
+	}
+	*ch = node->symbol;
+	*offset = pos;
+}
+
+/*
+==================
+Huff_putBits
+
+Added in OPM
+Writes up to 64 bits at once, the first bit in bit 0 of the value.
+Each byte is zeroed when it's first written to, like Huff_putBit
+==================
+*/
+void Huff_putBits(uint64_t value, int bits, byte *fout, int *offset) {
+	uint64_t	acc;
+	int			pos;
+	int			shift;
+	int			n;
+	int			i;
+
+	pos = *offset;
+
+	while (bits > 0) {
+		// keep room for the bits already in the first byte
+		n = bits > 56 ? 56 : bits;
+		shift = pos & 7;
+
+		acc = (fout[pos >> 3] & ((1 << shift) - 1)) | ((value & ((1ULL << n) - 1)) << shift);
+		for (i = 0; i < (shift + n + 7) >> 3; i++) {
+			fout[(pos >> 3) + i] = (byte)(acc >> (i * 8));
+		}
+
+		pos += n;
+		bits -= n;
+		if (bits > 0) {
+			value >>= n;
+		}
+	}
+
+	*offset = pos;
+}
+
+/*
+==================
+Huff_getBits
+
+Added in OPM
+Reads up to 25 bits at once, the first bit in bit 0 of the result.
+Only the bytes holding these bits are read
+==================
+*/
+int Huff_getBits(const byte *fin, int bits, int *offset) {
+	unsigned int	acc;
+	int				pos;
+	int				shift;
+	int				i;
+
+	pos = *offset;
+	shift = pos & 7;
+
+	acc = 0;
+	for (i = 0; i < (shift + bits + 7) >> 3; i++) {
+		acc |= (unsigned int)fin[(pos >> 3) + i] << (i * 8);
+	}
+
+	*offset = pos + bits;
+	return (acc >> shift) & ((1U << bits) - 1);
+}
+
 void Huff_Decompress(msg_t *mbuf, int offset) {
 	int			ch, i, j;
 	size_t		cch;
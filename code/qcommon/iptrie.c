@@ -0,0 +1,360 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// iptrie.c: Longest prefix match of IPv4/IPv6 CIDR ranges
+//
+// Each family has its own path compressed binary trie. A node holds a prefix and
+// branches on the bit that follows it, so a lookup visits at most one node per
+// distinct prefix length on the path: 33 for IPv4 and 129 for IPv6, regardless
+// of the number of ranges. The nodes live in a single growable array and are
+// referenced by index, removed ranges only clear the value of their node, the
+// memory is given back by IPTrie_Clear / IPTrie_Free.
+
+#include "iptrie.h"
+
+static const int iptrie_familyBits[IPTRIE_NUM_FAMILIES] = {32, 128};
+
+/*
+====================
+IPTrie_Bit
+====================
+*/
+static int IPTrie_Bit(const byte *addr, int bit)
+{
+    return (addr[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+/*
+====================
+IPTrie_CommonBits
+
+Number of leading bits shared by both addresses, up to bits
+====================
+*/
+static int IPTrie_CommonBits(const byte *a, const byte *b, int bits)
+{
+    int i;
+    int diff;
+
+    for (i = 0; i < bits; i += 8) {
+        diff = a[i >> 3] ^ b[i >> 3];
+        if (diff) {
+            while (!(diff & 0x80)) {
+                diff <<= 1;
+                i++;
+            }
+
+            return i < bits ? i : bits;
+        }
+    }
+
+    return bits;
+}
+
+/*
+====================
+IPTrie_SetPrefix
+
+Copy the first bits of the address and clear the others
+====================
+*/
+static void IPTrie_SetPrefix(ipTrieNode_t *node, const byte *addr, int bits)
+{
+    int bytes;
+
+    bytes = bits >> 3;
+
+    Com_Memset(node->prefix, 0, sizeof(node->prefix));
+    Com_Memcpy(node->prefix, addr, bytes);
+    if (bits & 7) {
+        node->prefix[bytes] = addr[bytes] & (0xff << (8 - (bits & 7)));
+    }
+
+    node->bits = bits;
+}
+
+/*
+====================
+IPTrie_AllocNode
+====================
+*/
+static int IPTrie_AllocNode(ipTrie_t *trie, const byte *addr, int bits, int value)
+{
+    ipTrieNode_t *node;
+
+    node = &trie->nodes[trie->numNodes];
+    IPTrie_SetPrefix(node, addr, bits);
+    node->child[0] = IPTRIE_NONE;
+    node->child[1] = IPTRIE_NONE;
+    node->value    = value;
+
+    return trie->numNodes++;
+}
+
+/*
+====================
+IPTrie_Reserve
+
+Make room for the nodes an insertion may add, so they can be allocated while walking the trie
+====================
+*/
+static void IPTrie_Reserve(ipTrie_t *trie, int count)
+{
+    ipTrieNode_t *nodes;
+    int           maxNodes;
+
+    if (trie->numNodes + count <= trie->maxNodes) {
+        return;
+    }
+
+    maxNodes = trie->maxNodes ? trie->maxNodes * 2 : 256;
+    nodes    = (ipTrieNode_t *)trie->alloc(maxNodes * sizeof(ipTrieNode_t));
+
+    if (trie->nodes) {
+        Com_Memcpy(nodes, trie->nodes, trie->numNodes * sizeof(ipTrieNode_t));
+        trie->free(trie->nodes);
+    }
+
+    trie->nodes    = nodes;
+    trie->maxNodes = maxNodes;
+}
+
+/*
+====================
+IPTrie_Init
+====================
+*/
+void IPTrie_Init(ipTrie_t *trie, void *(*alloc)(size_t size), void (*free)(void *ptr))
+{
+    Com_Memset(trie, 0, sizeof(*trie));
+
+    trie->alloc             = alloc;
+    trie->free              = free;
+    trie->root[IPTRIE_IPV4] = IPTRIE_NONE;
+    trie->root[IPTRIE_IPV6] = IPTRIE_NONE;
+}
+
+/*
+====================
+IPTrie_Clear
+
+Remove all ranges but keep the nodes allocated for the next ones
+====================
+*/
+void IPTrie_Clear(ipTrie_t *trie)
+{
+    trie->numNodes          = 0;
+    trie->numValues         = 0;
+    trie->root[IPTRIE_IPV4] = IPTRIE_NONE;
+    trie->root[IPTRIE_IPV6] = IPTRIE_NONE;
+}
+
+/*
+====================
+IPTrie_Free
+====================
+*/
+void IPTrie_Free(ipTrie_t *trie)
+{
+    if (trie->nodes) {
+        trie->free(trie->nodes);
+    }
+
+    trie->nodes    = NULL;
+    trie->maxNodes = 0;
+    IPTrie_Clear(trie);
+}
+
+/*
+====================
+IPTrie_Insert
+
+Associate a value to the range made of the first bits of the address.
+The value of an existing range is replaced. Returns qfalse if the prefix
+length is invalid for the family.
+====================
+*/
+qboolean IPTrie_Insert(ipTrie_t *trie, ipTrieFamily_t family, const byte *addr, int bits, int value)
+{
+    ipTrieNode_t *node;
+    int          *link;
+    int           index;
+    int           common;
+    int           branch;
+    int           leaf;
+
+    if (bits < 0 || bits > iptrie_familyBits[family] || value < 0) {
+        return qfalse;
+    }
+
+    // a split adds at most two nodes, reserve them now so the links stay valid
+    IPTrie_Reserve(trie, 2);
+
+    link = &trie->root[family];
+
+    while (*link != IPTRIE_NONE) {
+        index  = *link;
+        node   = &trie->nodes[index];
+        common = IPTrie_CommonBits(node->prefix, addr, bits < node->bits ? bits : node->bits);
+
+        if (common < node->bits) {
+            if (common == bits) {
+                // the new range contains the node
+                branch = IPTrie_AllocNode(trie, addr, bits, value);
+            } else {
+                // the ranges diverge, join them under a branch node
+                branch = IPTrie_AllocNode(trie, addr, common, IPTRIE_NONE);
+                leaf   = IPTrie_AllocNode(trie, addr, bits, value);
+
+                trie->nodes[branch].child[IPTrie_Bit(addr, common)] = leaf;
+            }
+
+            trie->nodes[branch].child[IPTrie_Bit(node->prefix, common)] = index;
+
+            *link = branch;
+            trie->numValues++;
+            return qtrue;
+        }
+
+        if (node->bits == bits) {
+            if (node->value == IPTRIE_NONE) {
+                trie->numValues++;
+            }
+
+            node->value = value;
+            return qtrue;
+        }
+
+        link = &node->child[IPTrie_Bit(addr, node->bits)];
+    }
+
+    *link = IPTrie_AllocNode(trie, addr, bits, value);
+    trie->numValues++;
+
+    return qtrue;
+}
+
+/*
+====================
+IPTrie_FindNode
+====================
+*/
+static ipTrieNode_t *IPTrie_FindNode(const ipTrie_t *trie, ipTrieFamily_t family, const byte *addr, int bits)
+{
+    ipTrieNode_t *node;
+    int           index;
+
+    if (bits < 0 || bits > iptrie_familyBits[family]) {
+        return NULL;
+    }
+
+    for (index = trie->root[family]; index != IPTRIE_NONE; index = node->child[IPTrie_Bit(addr, node->bits)]) {
+        node = &trie->nodes[index];
+
+        if (node->bits > bits || IPTrie_CommonBits(node->prefix, addr, node->bits) < node->bits) {
+            break;
+        }
+
+        if (node->bits == bits) {
+            return node;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+====================
+IPTrie_Remove
+
+Remove the range made of the first bits of the address, the ranges it contains are kept
+====================
+*/
+qboolean IPTrie_Remove(ipTrie_t *trie, ipTrieFamily_t family, const byte *addr, int bits)
+{
+    ipTrieNode_t *node;
+
+    node = IPTrie_FindNode(trie, family, addr, bits);
+    if (!node || node->value == IPTRIE_NONE) {
+        return qfalse;
+    }
+
+    node->value = IPTRIE_NONE;
+    trie->numValues--;
+
+    return qtrue;
+}
+
+/*
+====================
+IPTrie_Find
+
+Value of the exact range, IPTRIE_NONE if it's not in the trie
+====================
+*/
+int IPTrie_Find(const ipTrie_t *trie, ipTrieFamily_t family, const byte *addr, int bits)
+{
+    const ipTrieNode_t *node;
+
+    node = IPTrie_FindNode(trie, family, addr, bits);
+    if (!node) {
+        return IPTRIE_NONE;
+    }
+
+    return node->value;
+}
+
+/*
+====================
+IPTrie_Lookup
+
+Value of the longest range containing the address, IPTRIE_NONE if there is none
+====================
+*/
+int IPTrie_Lookup(const ipTrie_t *trie, ipTrieFamily_t family, const byte *addr)
+{
+    const ipTrieNode_t *node;
+    int                 index;
+    int                 value;
+    int                 bits;
+
+    value = IPTRIE_NONE;
+    bits  = iptrie_familyBits[family];
+
+    for (index = trie->root[family]; index != IPTRIE_NONE; index = node->child[IPTrie_Bit(addr, node->bits)]) {
+        node = &trie->nodes[index];
+
+        if (IPTrie_CommonBits(node->prefix, addr, node->bits) < node->bits) {
+            break;
+        }
+
+        if (node->value != IPTRIE_NONE) {
+            value = node->value;
+        }
+
+        if (node->bits == bits) {
+            break;
+        }
+    }
+
+    return value;
+}
@@ -0,0 +1,73 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// iptrie.h: Longest prefix match of IPv4/IPv6 CIDR ranges
+
+#pragma once
+
+#include "q_shared.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IPTRIE_NONE -1
+
+typedef enum {
+    IPTRIE_IPV4, // 4 bytes, up to 32 bits of prefix
+    IPTRIE_IPV6, // 16 bytes, up to 128 bits of prefix
+    IPTRIE_NUM_FAMILIES
+} ipTrieFamily_t;
+
+//
+// Node of a path compressed binary trie, the children are indexes in the node array
+// and the branch is taken on the first bit after the prefix
+//
+typedef struct ipTrieNode_s {
+    byte prefix[16];
+    int  bits;
+    int  child[2];
+    int  value; // IPTRIE_NONE for branch nodes
+} ipTrieNode_t;
+
+typedef struct ipTrie_s {
+    ipTrieNode_t *nodes;
+    int           numNodes;
+    int           maxNodes;
+    int           numValues;
+    int           root[IPTRIE_NUM_FAMILIES];
+
+    void *(*alloc)(size_t size);
+    void (*free)(void *ptr);
+} ipTrie_t;
+
+void     IPTrie_Init(ipTrie_t *trie, void *(*alloc)(size_t size), void (*free)(void *ptr));
+void     IPTrie_Clear(ipTrie_t *trie);
+void     IPTrie_Free(ipTrie_t *trie);
+qboolean IPTrie_Insert(ipTrie_t *trie, ipTrieFamily_t family, const byte *addr, int bits, int value);
+qboolean IPTrie_Remove(ipTrie_t *trie, ipTrieFamily_t family, const byte *addr, int bits);
+int      IPTrie_Find(const ipTrie_t *trie, ipTrieFamily_t family, const byte *addr, int bits);
+int      IPTrie_Lookup(const ipTrie_t *trie, ipTrieFamily_t family, const byte *addr);
+
+#ifdef __cplusplus
+}
+#endif
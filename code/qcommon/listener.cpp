@@ -448,7 +448,7 @@ void Event::Archive(Archiver& arc)
     arc.ArchiveUnsignedShort(&dataSize);
 
     if (arc.Loading()) {
-        data = new ScriptVariable[dataSize + 1];
+        data = NewData(dataSize + 1);
     }
 
     for (int i = dataSize; i > 0; i--) {
@@ -1104,6 +1104,7 @@ new Event
 */
 void *Event::operator new(size_t size)
 {
+    eventAllocStats.numEvents++;
     return Event_allocator.Alloc();
 }
 
@@ -1119,6 +1120,125 @@ void Event::operator delete(void *ptr)
 
 #endif
 
+// Added in OPM
+//  The argument list is preceded by a header telling how it was allocated.
+struct alignas(ScriptVariable) eventDataHeader_t {
+    unsigned short count;
+    bool           pooled;
+};
+
+struct eventPooledData_t {
+    eventDataHeader_t header;
+    alignas(ScriptVariable) char values[sizeof(ScriptVariable) * EVENT_POOLED_ARGS];
+};
+
+static MEM_BlockAlloc<eventPooledData_t> EventData_allocator;
+
+eventAllocStats_t        eventAllocStats;
+static eventAllocStats_t eventAllocLastFrame;
+static eventAllocStats_t eventAllocTotal;
+static unsigned int      eventAllocNumFrames;
+
+/*
+=======================
+NewData
+
+Allocates an argument list of count values
+=======================
+*/
+ScriptVariable *Event::NewData(int count)
+{
+    eventDataHeader_t *header;
+    ScriptVariable    *values;
+
+    if (count <= EVENT_POOLED_ARGS) {
+        header         = &static_cast<eventPooledData_t *>(EventData_allocator.Alloc())->header;
+        header->pooled = true;
+        eventAllocStats.numPooledData++;
+    } else {
+        header         = static_cast<eventDataHeader_t *>(::operator new(sizeof(eventDataHeader_t) + sizeof(ScriptVariable) * count));
+        header->pooled = false;
+        eventAllocStats.numHeapData++;
+    }
+
+    header->count = count;
+
+    values = reinterpret_cast<ScriptVariable *>(header + 1);
+    for (int i = 0; i < count; i++) {
+        new (&values[i]) ScriptVariable();
+    }
+
+    return values;
+}
+
+/*
+=======================
+DeleteData
+
+Frees an argument list allocated by NewData
+=======================
+*/
+void Event::DeleteData(ScriptVariable *data)
+{
+    eventDataHeader_t *header = reinterpret_cast<eventDataHeader_t *>(data) - 1;
+
+    for (int i = 0; i < header->count; i++) {
+        data[i].~ScriptVariable();
+    }
+
+    if (header->pooled) {
+        EventData_allocator.Free(header);
+    } else {
+        ::operator delete(header);
+    }
+}
+
+/*
+=======================
+L_EndEventAllocFrame
+
+Called once per frame, remembers the allocations done during the frame
+=======================
+*/
+void L_EndEventAllocFrame()
+{
+    eventAllocLastFrame = eventAllocStats;
+
+    eventAllocTotal.numEvents += eventAllocStats.numEvents;
+    eventAllocTotal.numPooledData += eventAllocStats.numPooledData;
+    eventAllocTotal.numHeapData += eventAllocStats.numHeapData;
+    eventAllocNumFrames++;
+
+    memset(&eventAllocStats, 0, sizeof(eventAllocStats));
+}
+
+void L_PrintEventAllocStats()
+{
+    const float numFrames = eventAllocNumFrames ? (float)eventAllocNumFrames : 1.f;
+
+    EVENT_Printf("              events  pooled args  heap args\n");
+    EVENT_Printf(
+        "last frame  %8u     %8u   %8u\n",
+        eventAllocLastFrame.numEvents,
+        eventAllocLastFrame.numPooledData,
+        eventAllocLastFrame.numHeapData
+    );
+    EVENT_Printf(
+        "per frame   %8.1f     %8.1f   %8.1f  (%u frames)\n",
+        eventAllocTotal.numEvents / numFrames,
+        eventAllocTotal.numPooledData / numFrames,
+        eventAllocTotal.numHeapData / numFrames,
+        eventAllocNumFrames
+    );
+}
+
+void L_ResetEventAllocStats()
+{
+    memset(&eventAllocLastFrame, 0, sizeof(eventAllocLastFrame));
+    memset(&eventAllocTotal, 0, sizeof(eventAllocTotal));
+    eventAllocNumFrames = 0;
+}
+
 /*
 =======================
 FindEventNum
@@ -1711,7 +1831,7 @@ Event::Event(const Event& ev)
     maxDataSize = ev.maxDataSize;
 
     if (dataSize) {
-        data = new ScriptVariable[maxDataSize];
+        data = NewData(maxDataSize);
 
         for (int i = 0; i < dataSize; i++) {
             data[i] = ev.data[i];
@@ -1733,13 +1853,13 @@ Event::Event(const Event& ev, int numArgs)
     maxDataSize = ev.maxDataSize;
 
     if (dataSize) {
-        data = new ScriptVariable[maxDataSize];
+        data = NewData(maxDataSize);
 
         for (int i = 0; i < dataSize; i++) {
             data[i] = ev.data[i];
         }
     } else {
-        data        = new ScriptVariable[numArgs];
+        data        = NewData(numArgs);
         dataSize    = 0;
         maxDataSize = numArgs;
     }
@@ -1802,7 +1922,7 @@ Event::Event(int index, int numArgs)
 {
     fromScript  = false;
     eventnum    = index;
-    data        = new ScriptVariable[numArgs];
+    data        = NewData(numArgs);
     dataSize    = 0;
     maxDataSize = numArgs;
 
@@ -1853,7 +1973,7 @@ Event::Event(const char *command, int numArgs)
     maxDataSize = numArgs;
 
     if (numArgs) {
-        data     = new ScriptVariable[numArgs];
+        data     = NewData(numArgs);
         dataSize = 0;
     } else {
         dataSize = 0;
@@ -1884,7 +2004,7 @@ Event& Event::operator=(const Event& ev)
     maxDataSize = ev.maxDataSize;
 
     if (dataSize) {
-        data = new ScriptVariable[dataSize];
+        data = NewData(maxDataSize);
 
         for (int i = 0; i < dataSize; i++) {
             data[i] = ev.data[i];
@@ -2104,7 +2224,7 @@ Clear
 void Event::Clear(void)
 {
     if (data) {
-        delete[] data;
+        DeleteData(data);
 
         data        = NULL;
         dataSize    = 0;
@@ -2271,7 +2391,7 @@ ScriptVariable& Event::GetValue(void)
         // to the first index of the array
         // so there is no reallocation
         if (!data) {
-            data        = new ScriptVariable[1];
+            data        = NewData(1);
             dataSize    = 1;
             maxDataSize = 1;
         }
@@ -2282,14 +2402,14 @@ ScriptVariable& Event::GetValue(void)
         tmp = data;
 
         maxDataSize += 3;
-        data = new ScriptVariable[maxDataSize];
+        data = NewData(maxDataSize);
 
         if (tmp != NULL) {
             for (i = 0; i < dataSize; i++) {
                 data[i] = std::move(tmp[i]);
             }
 
-            delete[] tmp;
+            DeleteData(tmp);
         }
     }
 
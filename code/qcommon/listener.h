@@ -242,6 +242,17 @@ public:
     friend bool operator==(const command_t& cmd1, const command_t& cmd2);
 };
 
+// Added in OPM
+//  argument lists of up to this number of values are allocated from a pool
+#define EVENT_POOLED_ARGS 4
+
+// Added in OPM
+typedef struct {
+    unsigned int numEvents;     // Event objects allocated from the heap allocator
+    unsigned int numPooledData; // argument lists allocated from the pool
+    unsigned int numHeapData;   // argument lists too large for the pool
+} eventAllocStats_t;
+
 class Event : public Class
 {
 public:
@@ -364,6 +375,10 @@ public:
 
     void Clear(void);
 
+    // Added in OPM
+    static ScriptVariable *NewData(int count);
+    static void            DeleteData(ScriptVariable *data);
+
     void CheckPos(int pos) const;
 
     bool GetBoolean(int pos) const;
@@ -681,3 +696,10 @@ void L_ProcessPendingEvents();
 void L_ShutdownEvents(void);
 void L_ArchiveEvents(Archiver& arc);
 void L_UnarchiveEvents(Archiver& arc);
+
+// Added in OPM
+extern eventAllocStats_t eventAllocStats;
+
+void L_EndEventAllocFrame();
+void L_PrintEventAllocStats();
+void L_ResetEventAllocStats();
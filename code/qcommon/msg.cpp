@@ -23,6 +23,10 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "qcommon.h"
 
 huffman_t msgHuff;
+// Added in OPM
+//  msgHuff never changes once initialized, code with static tables
+static huffTable_t msgHuffEncoder;
+static huffTable_t msgHuffDecoder;
 
 qboolean msgInit = qfalse;
 
@@ -296,22 +300,42 @@ void MSG_WriteBits( msg_t *msg, int value, int bits ) {
 				msg->overflowed = qtrue;
 				return;
 			}
-			for(i=0;i<nbits;i++) {
-				Huff_putBit((value&1), msg->data, &msg->bit);
-				value = (value>>1);
-			}
+			Huff_putBits(value & ((1 << nbits) - 1), nbits, msg->data, &msg->bit);
+			value = ((unsigned int)value >> nbits);
 			bits = bits - nbits;
 		}
 		if (bits) {
-			for(i=0;i<bits;i+=8) {
-				Huff_offsetTransmit( &msgHuff.compressor, (value & 0xff), msg->data, &msg->bit, msg->maxsize << 3 );
-				value = (value>>8);
+			uint64_t	acc;
+			int			accbits;
+			int			length;
 
-				if ( msg->bit > msg->maxsize << 3 ) {
-					msg->overflowed = qtrue;
-					return;
+			// Added in OPM
+			//  gather the codes of the bytes and write them at once
+			acc = 0;
+			accbits = 0;
+			for(i=0;i<bits;i+=8) {
+				length = msgHuffEncoder.length[value & 0xff];
+				if (accbits + length > 64) {
+					if ( msg->bit + accbits > msg->maxsize << 3 ) {
+						msg->bit = (msg->maxsize << 3) + 1;
+						msg->overflowed = qtrue;
+						return;
+					}
+					Huff_putBits(acc, accbits, msg->data, &msg->bit);
+					acc = 0;
+					accbits = 0;
 				}
+				acc |= (uint64_t)msgHuffEncoder.code[value & 0xff] << accbits;
+				accbits += length;
+				value = ((unsigned int)value >> 8);
 			}
+
+			if ( msg->bit + accbits > msg->maxsize << 3 ) {
+				msg->bit = (msg->maxsize << 3) + 1;
+				msg->overflowed = qtrue;
+				return;
+			}
+			Huff_putBits(acc, accbits, msg->data, &msg->bit);
 		}
 		msg->cursize = (msg->bit>>3)+1;
 	}
@@ -373,14 +397,12 @@ int MSG_ReadBits( msg_t *msg, int bits ) {
 				msg->readcount = msg->cursize + 1;
 				return 0;
 			}
-			for(i=0;i<nbits;i++) {
-				value |= (Huff_getBit(msg->data, &msg->bit)<<i);
-			}
+			value = Huff_getBits(msg->data, nbits, &msg->bit);
 			bits = bits - nbits;
 		}
 		if (bits) {
 			for(i=0;i<bits;i+=8) {
-				Huff_offsetReceive (msgHuff.decompressor.tree, &get, msg->data, &msg->bit, msg->cursize<<3);
+				Huff_tableReceive (&msgHuffDecoder, &get, msg->data, &msg->bit, msg->cursize<<3);
 				value |= (get<<(i+nbits));
 
 				if (msg->bit > msg->cursize<<3) {
@@ -4111,4 +4133,8 @@ void MSG_initHuffman( void ) {
 			Huff_addRef(&msgHuff.decompressor,	(byte)i);			// Do update
 		}
 	}
+
+	// Added in OPM
+	Huff_BuildTable(&msgHuff.compressor, &msgHuffEncoder);
+	Huff_BuildTable(&msgHuff.decompressor, &msgHuffDecoder);
 }
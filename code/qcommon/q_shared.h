@@ -137,6 +137,13 @@ extern "C" {
 #define Q_EXPORT
 #endif
 
+// each thread gets its own copy of the variable
+#if (defined _MSC_VER)
+#define Q_THREAD_LOCAL __declspec(thread)
+#else
+#define Q_THREAD_LOCAL __thread
+#endif
+
 /**********************************************************************
   VM Considerations
 
@@ -1361,6 +1361,9 @@ void	Sys_Print( const char *msg );
 // Sys_Milliseconds should only be used for profiling purposes,
 // any game related timing information should come from event timestamps
 int		Sys_Milliseconds (void);
+// Added in OPM
+//  monotonic clock in microseconds, for benchmarks
+unsigned long long	Sys_Microseconds (void);
 
 qboolean Sys_RandomBytes( byte *string, int len );
 
@@ -1499,6 +1502,19 @@ typedef struct {
 	huff_t		decompressor;
 } huffman_t;
 
+// Added in OPM
+//  Static tables of a huffman tree that doesn't change anymore.
+//  They don't use the shared bit cursor, so they can be used from several threads
+#define HUFF_LOOKUP_BITS	11
+#define HUFF_MAX_CODE_BITS	32
+
+typedef struct {
+	node_t			*tree;								// walked for codes longer than HUFF_LOOKUP_BITS
+	unsigned int	code[HMAX+1];						// code of each symbol, the first bit sent in bit 0
+	byte			length[HMAX+1];						// code length in bits, 0 if the symbol isn't in the tree
+	unsigned short	lookup[1 << HUFF_LOOKUP_BITS];		// symbol | (length << 9) for the next bits, 0 length for longer codes
+} huffTable_t;
+
 void	Huff_Compress(msg_t *buf, int offset);
 void	Huff_Decompress(msg_t *buf, int offset);
 void	Huff_Init(huffman_t *huff);
@@ -1509,6 +1525,11 @@ void	Huff_offsetReceive (node_t *node, int *ch, byte *fin, int *offset, int maxo
 void	Huff_offsetTransmit (huff_t *huff, int ch, byte *fout, int *offset, int maxoffset);
 void	Huff_putBit( int bit, byte *fout, int *offset);
 int		Huff_getBit( byte *fout, int *offset);
+// Added in OPM
+void	Huff_BuildTable(huff_t *huff, huffTable_t *table);
+void	Huff_tableReceive(const huffTable_t *table, int *ch, const byte *fin, int *offset, int maxoffset);
+void	Huff_putBits(uint64_t value, int bits, byte *fout, int *offset);
+int		Huff_getBits(const byte *fin, int bits, int *offset);
 
 extern huffman_t clientHuffTables;
 
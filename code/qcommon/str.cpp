@@ -24,6 +24,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 //
 
 #include "str.h"
+#include <new>
 #include <stdlib.h>
 #include <ctype.h>
 #include <stdio.h>
@@ -36,6 +37,44 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 static const int STR_ALLOC_GRAN = 20;
 
+size_t str::numHeapAllocs;
+size_t str::numHeapFrees;
+size_t str::numInlineStores;
+
+static size_t STR_RoundAlloc(size_t amount)
+{
+    size_t mod;
+
+    mod = amount % STR_ALLOC_GRAN;
+    if (!mod) {
+        return amount;
+    }
+
+    return amount + STR_ALLOC_GRAN - mod;
+}
+
+strdata *strdata::Alloc(size_t amount)
+{
+    strdata *block;
+
+    block = static_cast<strdata *>(::operator new(offsetof(strdata, data) + amount));
+
+    block->refcount = 0;
+    block->alloced  = amount;
+    block->data[0]  = 0;
+
+    str::numHeapAllocs++;
+
+    return block;
+}
+
+void strdata::Free()
+{
+    str::numHeapFrees++;
+
+    ::operator delete(this);
+}
+
 char *str::tolower(char *s1)
 {
     char *s;
@@ -280,23 +319,23 @@ str& str::operator+=(const unsigned a)
 
 str& str::operator-=(int c)
 {
-    if (!m_data) {
-        return *this;
-    }
+    size_t len;
 
-    if (!m_data->len) {
+    len = length();
+    if (!len) {
         return *this;
     }
 
-    if (m_data->len >= c) {
-        m_data->len -= c;
+    if (len >= (size_t)c) {
+        len -= c;
     } else {
-        m_data->len = 0;
+        len = 0;
     }
 
     EnsureDataWritable();
 
-    m_data->data[m_data->len] = 0;
+    Data()[len] = 0;
+    SetLength(len);
 
     return *this;
 }
@@ -309,141 +348,216 @@ str& str::operator--(int)
 
 void str::CapLength(size_t newlen)
 {
-    assert(m_data);
-
     if (length() <= newlen) {
         return;
     }
 
     EnsureDataWritable();
 
-    m_data->data[newlen] = 0;
-    m_data->len          = newlen;
+    Data()[newlen] = 0;
+    SetLength(newlen);
 }
 
-void str::EnsureDataWritable(void)
+void str::Assign(const char *text, size_t len)
 {
-    strdata *olddata;
-    size_t   len;
+    strdata *block;
+
+    if (len <= STR_INLINE_LENGTH) {
+        char buffer[STR_INLINE_LENGTH];
+
+        // the text may be a part of this string
+        memcpy(buffer, text, len);
+        Release();
 
-    if (!m_data) {
+        memcpy(m_inline, buffer, len);
+        m_inline[len]                 = 0;
+        m_inline[STR_INLINE_SIZE - 1] = (char)len;
+
+        if (len) {
+            numInlineStores++;
+        }
         return;
     }
 
-    if (!m_data->refcount) {
+    if (!IsInline() && !m_heap.block->refcount && len < m_heap.block->alloced) {
+        // reuse our own buffer
+        memmove(m_heap.block->data, text, len);
+        m_heap.block->data[len] = 0;
+        m_heap.len              = len;
         return;
     }
 
-    olddata = m_data;
-    len     = length();
-
-    m_data = new strdata;
+    block = strdata::Alloc(STR_RoundAlloc(len + 1));
+    memcpy(block->data, text, len);
+    block->data[len] = 0;
 
-    EnsureAlloced(len + 1, false);
-    strncpy(m_data->data, olddata->data, len + 1);
-    m_data->len = len;
+    Release();
 
-    olddata->DelRef();
+    m_heap.block                  = block;
+    m_heap.len                    = len;
+    m_inline[STR_INLINE_SIZE - 1] = (char)STR_HEAP_TAG;
 }
 
-void str::EnsureAlloced(size_t amount, bool keepold)
+void str::append(const char *text)
 {
-    if (!m_data) {
-        if (amount > 1) {
-            m_data = new strdata;
+    const char *data;
+    size_t      len;
+    size_t      addlen;
 
-            m_data->data    = new char[amount];
-            m_data->alloced = amount;
+    assert(text);
 
-            m_data->data[0] = '\0';
+    if (!*text) {
+        return;
+    }
 
-            return;
-        }
+    data = c_str();
+    len  = length();
 
-        if (!m_data) {
-            return;
-        }
+    if (text >= data && text <= data + len) {
+        // the buffer may move while growing, append a copy
+        str copy(text);
+
+        append(copy.c_str());
+        return;
     }
 
-    // Now, let's make sure it's writable
-    EnsureDataWritable();
+    addlen = strlen(text);
+    EnsureAlloced(len + addlen + 1);
 
-    char *newbuffer;
-    bool  wasalloced = (m_data->alloced != 0);
+    memcpy(Data() + len, text, addlen + 1);
+    SetLength(len + addlen);
+}
+
+void str::EnsureDataWritable(void)
+{
+    strdata *olddata;
+    size_t   len;
 
-    if (amount < m_data->alloced) {
+    if (IsInline()) {
         return;
     }
 
-    assert(amount);
+    if (!m_heap.block->refcount) {
+        return;
+    }
+
+    olddata = m_heap.block;
+    len     = m_heap.len;
 
-    if (amount == 1) {
-        m_data->alloced = 1;
+    if (len <= STR_INLINE_LENGTH) {
+        // short enough to be stored inline
+        memcpy(m_inline, olddata->data, len + 1);
+        m_inline[STR_INLINE_SIZE - 1] = (char)len;
     } else {
-        size_t newsize, mod;
+        m_heap.block = strdata::Alloc(STR_RoundAlloc(len + 1));
+        memcpy(m_heap.block->data, olddata->data, len + 1);
+    }
+
+    olddata->DelRef();
+}
 
-        mod = amount % STR_ALLOC_GRAN;
+void str::EnsureAlloced(size_t amount, bool keepold)
+{
+    strdata *block;
+    size_t   len;
+    size_t   newsize;
 
-        if (!mod) {
-            newsize = amount;
-        } else {
-            newsize = amount + STR_ALLOC_GRAN - mod;
+    if (IsInline()) {
+        if (amount <= STR_INLINE_LENGTH + 1) {
+            if (!keepold) {
+                SetEmpty();
+            }
+            return;
         }
 
-        m_data->alloced = newsize;
+        len   = keepold ? length() : 0;
+        block = strdata::Alloc(STR_RoundAlloc(amount));
+        memcpy(block->data, m_inline, len);
+        block->data[len] = 0;
+
+        m_heap.block                  = block;
+        m_heap.len                    = len;
+        m_inline[STR_INLINE_SIZE - 1] = (char)STR_HEAP_TAG;
+        return;
     }
 
-    newbuffer = new char[m_data->alloced];
+    // Now, let's make sure it's writable
+    EnsureDataWritable();
+
+    if (IsInline()) {
+        EnsureAlloced(amount, keepold);
+        return;
+    }
 
-    if (wasalloced && keepold) {
-        strcpy(newbuffer, m_data->data);
+    if (amount <= m_heap.block->alloced) {
+        if (!keepold) {
+            m_heap.block->data[0] = 0;
+            m_heap.len            = 0;
+        }
+        return;
     }
 
-    if (m_data->data) {
-        delete[] m_data->data;
+    // grow by at least half so that appending in a loop doesn't reallocate every time
+    newsize = m_heap.block->alloced + m_heap.block->alloced / 2;
+    if (newsize < amount) {
+        newsize = amount;
     }
 
-    m_data->data = newbuffer;
+    len   = keepold ? m_heap.len : 0;
+    block = strdata::Alloc(STR_RoundAlloc(newsize));
+    memcpy(block->data, m_heap.block->data, len);
+    block->data[len] = 0;
+
+    m_heap.block->DelRef();
+    m_heap.block = block;
+    m_heap.len   = len;
 }
 
 void str::BackSlashesToSlashes(void)
 {
+    char  *data;
     size_t i;
 
     EnsureDataWritable();
 
-    for (i = 0; i < m_data->len; i++) {
-        if (m_data->data[i] == '\\') {
-            m_data->data[i] = '/';
+    data = Data();
+    for (i = 0; i < length(); i++) {
+        if (data[i] == '\\') {
+            data[i] = '/';
         }
     }
 }
 
 void str::SlashesToBackSlashes(void)
 {
+    char  *data;
     size_t i;
 
     EnsureDataWritable();
 
-    for (i = 0; i < m_data->len; i++) {
-        if (m_data->data[i] == '/') {
-            m_data->data[i] = '\\';
+    data = Data();
+    for (i = 0; i < length(); i++) {
+        if (data[i] == '/') {
+            data[i] = '\\';
         }
     }
 }
 
 void str::DefaultExtension(const char *extension)
 {
-    EnsureDataWritable();
+    const char *data = c_str();
+    const char *src;
 
-    const char *src = m_data->data + m_data->len - 1;
+    if (length()) {
+        src = data + length() - 1;
 
-    while (*src != '/' && src != m_data->data) {
-        if (*src == '.') {
-            // it has an extension
-            return;
+        while (*src != '/' && src != data) {
+            if (*src == '.') {
+                // it has an extension
+                return;
+            }
+            src--;
         }
-        src--;
     }
 
     append(".");
@@ -452,62 +566,66 @@ void str::DefaultExtension(const char *extension)
 
 const char *str::GetExtension() const
 {
-    size_t length, i;
+    const char *data = c_str();
+    size_t      i;
+
+    if (!length()) {
+        return ""; // no extension
+    }
 
-    length = m_data->len - 1;
-    i      = length;
+    i = length() - 1;
 
-    while (m_data->data[i] != '.') {
+    while (data[i] != '.') {
         i--;
-        if (m_data->data[i] == '/' || i == 0) {
+        if (data[i] == '/' || i == 0) {
             return ""; // no extension
         }
     }
 
-    return &m_data->data[i + 1];
+    return &data[i + 1];
 }
 
 void str::StripExtension()
 {
-    EnsureDataWritable();
+    const char *data = c_str();
+    size_t      i    = length();
 
-    size_t i = m_data->len;
-    while (i > 0 && m_data->data[i] != '.') {
+    while (i > 0 && data[i] != '.') {
         i--;
-        if (m_data->data[i] == '/') {
+        if (data[i] == '/') {
             return; // no extension
         }
     }
     if (i) {
-        m_data->len               = i;
-        m_data->data[m_data->len] = 0;
-
         EnsureDataWritable();
+
+        Data()[i] = 0;
+        SetLength(i);
     }
 }
 
 void str::SkipFile()
 {
-    EnsureDataWritable();
+    const char *data = c_str();
+    size_t      i    = length();
 
-    size_t i = m_data->len;
-    while (i > 0 && m_data->data[i] != '/' && m_data->data[i] != '\\') {
+    while (i > 0 && data[i] != '/' && data[i] != '\\') {
         i--;
     }
-    m_data->len               = i;
-    m_data->data[m_data->len] = 0;
 
     EnsureDataWritable();
+
+    Data()[i] = 0;
+    SetLength(i);
 }
 
 void str::SkipPath()
 {
-    EnsureDataWritable();
-
-    const char *pathname = m_data->data;
+    const char *data     = c_str();
+    const char *pathname = data;
     const char *last;
 
-    last = m_data->data;
+    last = data;
     while (*pathname) {
         if (*pathname == '/' || *pathname == '\\') {
             last = pathname + 1;
@@ -515,17 +633,18 @@ void str::SkipPath()
         pathname++;
     }
 
-    size_t lastpos = last - m_data->data;
+    size_t lastpos = last - data;
     if (lastpos > 0) {
-        size_t length = m_data->len - lastpos;
-        for (size_t i = 0; i < length; i++) {
-            m_data->data[i] = last[i];
-        }
-
-        m_data->len          = length;
-        m_data->data[length] = 0;
+        size_t length = this->length() - lastpos;
+        char  *dest;
 
         EnsureDataWritable();
+
+        dest = Data();
+        memmove(dest, dest + lastpos, length);
+        dest[length] = 0;
+
+        SetLength(length);
     }
 }
 
@@ -544,19 +663,24 @@ void str::snprintf(char *dst, int size, const char *fmt, ...)
 
 void str::strip(void)
 {
-    char  *last;
-    char  *s;
-    size_t i;
+    const char *data;
+    const char *last;
+    const char *s;
+    size_t      len;
+    char       *dest;
 
-    if (m_data == NULL || m_data->data == NULL) {
+    len = length();
+    if (!len) {
         return;
     }
-    s = m_data->data;
+
+    data = c_str();
+    s    = data;
     while (isspace((int)*s) && *s) {
         s++;
     }
 
-    last = s + m_data->len - (s - m_data->data);
+    last = data + len;
     while (last > s) {
         if (!isspace((int)*(last - 1))) {
             break;
@@ -564,14 +688,20 @@ void str::strip(void)
         last--;
     }
 
-    *last = '\0';
-
-    m_data->len = last - s;
-    for (i = 0; i < m_data->len + 1; i++) {
-        m_data->data[i] = s[i];
+    if (s == data && last == data + len) {
+        // nothing to strip
+        return;
     }
 
+    len = last - s;
+
     EnsureDataWritable();
+
+    dest = Data();
+    memmove(dest, dest + (s - data), len);
+    dest[len] = 0;
+
+    SetLength(len);
 }
 
 char *strstrip(char *string)
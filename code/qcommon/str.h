@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #pragma once
 
 #include <cassert>
+#include <cstddef>
 #include <cstring>
 #include <cstdio>
 #include <cstdint>
@@ -37,22 +38,14 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 void TestStringClass();
 
+// Added in OPM
+//  Heap storage of a str, the header and the characters share one allocation.
+//  The block is shared between copies until one of them is modified
 class strdata
 {
 public:
-    strdata()
-        : len(0)
-        , refcount(0)
-        , data(NULL)
-        , alloced(0)
-    {}
-
-    ~strdata()
-    {
-        if (data) {
-            delete[] data;
-        }
-    }
+    static strdata *Alloc(size_t amount);
+    void            Free();
 
     void AddRef() { refcount++; }
 
@@ -60,26 +53,57 @@ public:
     {
         refcount--;
         if (refcount < 0) {
-            delete this;
+            Free();
             return true;
         }
 
         return false;
     }
 
-    char  *data;
     int    refcount;
     size_t alloced;
-    size_t len;
+    char   data[1];
 };
 
 class str
 {
 protected:
     friend class Archiver;
-    strdata *m_data;
-    void     EnsureAlloced(size_t, bool keepold = true);
-    void     EnsureDataWritable();
+
+    // Added in OPM
+    //  Strings up to STR_INLINE_LENGTH characters are stored in the object itself.
+    //  The last byte holds the inline length, or STR_HEAP_TAG when the characters
+    //  are in m_heap.block. A zero-filled str is a valid empty string
+    enum {
+        STR_INLINE_SIZE   = 24,
+        STR_INLINE_LENGTH = STR_INLINE_SIZE - 2,
+        STR_HEAP_TAG      = 0xFF
+    };
+
+    union {
+        struct {
+            strdata *block;
+            size_t   len;
+        } m_heap;
+        char m_inline[STR_INLINE_SIZE];
+    };
+
+    bool        IsInline() const;
+    char       *Data();
+    const char *Data() const;
+    void        SetLength(size_t len);
+    void        SetEmpty();
+    void        Release();
+    void        Assign(const char *text, size_t len);
+    void        EnsureAlloced(size_t, bool keepold = true);
+    void        EnsureDataWritable();
+
+public:
+    // Added in OPM
+    //  Heap block counters of this module, see the strallocs command
+    static size_t numHeapAllocs;
+    static size_t numHeapFrees;
+    static size_t numInlineStores;
 
 public:
     ~str();
@@ -180,80 +204,102 @@ public:
 char *strstrip(char *string);
 char *strlwc(char *string);
 
-inline char str::operator[](intptr_t index) const
+inline bool str::IsInline() const
 {
-    assert(m_data);
+    return (unsigned char)m_inline[STR_INLINE_SIZE - 1] != STR_HEAP_TAG;
+}
 
-    if (!m_data) {
-        return 0;
+inline char *str::Data()
+{
+    return IsInline() ? m_inline : m_heap.block->data;
+}
+
+inline const char *str::Data() const
+{
+    return IsInline() ? m_inline : m_heap.block->data;
+}
+
+inline void str::SetLength(size_t len)
+{
+    if (IsInline()) {
+        assert(len <= STR_INLINE_LENGTH);
+        m_inline[STR_INLINE_SIZE - 1] = (char)len;
+    } else {
+        m_heap.len = len;
     }
+}
 
+inline void str::SetEmpty()
+{
+    m_inline[0]                   = 0;
+    m_inline[STR_INLINE_SIZE - 1] = 0;
+}
+
+inline void str::Release()
+{
+    if (!IsInline()) {
+        m_heap.block->DelRef();
+    }
+
+    SetEmpty();
+}
+
+inline char str::operator[](intptr_t index) const
+{
     // don't include the '/0' in the test, because technically, it's out of bounds
-    assert((index >= 0) && (index < (int)m_data->len));
+    assert((index >= 0) && (index < (intptr_t)length()));
 
     // In release mode, give them a null character
     // don't include the '/0' in the test, because technically, it's out of bounds
-    if ((index < 0) || (index >= (int)m_data->len)) {
+    if ((index < 0) || (index >= (intptr_t)length())) {
         return 0;
     }
 
-    return m_data->data[index];
+    return Data()[index];
 }
 
 inline size_t str::length(void) const
 {
-    return (m_data != NULL) ? m_data->len : 0;
+    return IsInline() ? (unsigned char)m_inline[STR_INLINE_SIZE - 1] : m_heap.len;
 }
 
 inline str::~str()
 {
-    if (m_data) {
-        m_data->DelRef();
-        m_data = NULL;
+    if (!IsInline()) {
+        m_heap.block->DelRef();
     }
 }
 
 inline str::str()
-    : m_data(NULL)
-{}
+{
+    SetEmpty();
+}
 
 inline str::str(const char *text)
-    : m_data(NULL)
 {
-    size_t len;
+    SetEmpty();
 
     assert(text);
     if (*text) {
-        len = strlen(text);
-
-        if (len) {
-            EnsureAlloced(len + 1);
-            strcpy(m_data->data, text);
-            m_data->len = len;
-        }
+        Assign(text, strlen(text));
     }
 }
 
 inline str::str(const str& text)
-    : m_data(NULL)
 {
-    if (text.m_data) {
-        text.m_data->AddRef();
-    }
+    memcpy(m_inline, text.m_inline, sizeof(m_inline));
 
-    if (m_data) {
-        m_data->DelRef();
+    if (!IsInline()) {
+        m_heap.block->AddRef();
     }
-
-    m_data = text.m_data;
 }
 
 inline str::str(const str& text, size_t start, size_t end)
-    : m_data(NULL)
 {
-    size_t i;
     size_t len;
 
+    SetEmpty();
+
     if (end > text.length()) {
         end = text.length();
     }
@@ -269,161 +315,102 @@ inline str::str(const str& text, size_t start, size_t end)
     }
 
     if (len > 0) {
-        EnsureAlloced(len + 1);
-
-        for (i = 0; i < len; i++) {
-            m_data->data[i] = text[start + i];
-        }
-
-        m_data->data[len] = 0;
-        m_data->len       = len;
+        Assign(text.c_str() + start, len);
     }
 }
 
 inline str::str(const char ch)
-    : m_data(NULL)
 {
-    EnsureAlloced(2);
-
-    m_data->data[0] = ch;
-    m_data->data[1] = 0;
-    m_data->len     = 1;
+    SetEmpty();
+    Assign(&ch, 1);
 }
 
 inline str::str(const float num)
-    : m_data(NULL)
 {
-    char   text[32];
-    size_t len;
+    char text[32];
 
+    SetEmpty();
     snprintf(text, sizeof(text), "%.3f", num);
-    len = strlen(text);
-    EnsureAlloced(len + 1);
-    strcpy(m_data->data, text);
-    m_data->len = len;
+    Assign(text, strlen(text));
 }
 
 inline str::str(const int num)
-    : m_data(NULL)
 {
-    char   text[32];
-    size_t len;
+    char text[32];
 
+    SetEmpty();
     snprintf(text, sizeof(text), "%d", num);
-    len = strlen(text);
-    EnsureAlloced(len + 1);
-    strcpy(m_data->data, text);
-    m_data->len = len;
+    Assign(text, strlen(text));
 }
 
 inline str::str(const unsigned int num)
-    : m_data(NULL)
 {
-    char   text[32];
-    size_t len;
+    char text[32];
 
+    SetEmpty();
     snprintf(text, sizeof(text), "%u", num);
-    len = strlen(text);
-    EnsureAlloced(len + 1);
-    strcpy(m_data->data, text);
-    m_data->len = len;
+    Assign(text, strlen(text));
 }
 
 inline str::str(const long num)
-    : m_data(NULL)
 {
-    char   text[64];
-    size_t len;
+    char text[64];
 
+    SetEmpty();
     snprintf(text, sizeof(text), "%ld", num);
-    len = strlen(text);
-    EnsureAlloced(len + 1);
-    strcpy(m_data->data, text);
-    m_data->len = len;
+    Assign(text, strlen(text));
 }
 
 inline str::str(const unsigned long num)
-    : m_data(NULL)
 {
-    char   text[64];
-    size_t len;
+    char text[64];
 
+    SetEmpty();
     snprintf(text, sizeof(text), "%lu", num);
-    len = strlen(text);
-    EnsureAlloced(len + 1);
-    strcpy(m_data->data, text);
-    m_data->len = len;
+    Assign(text, strlen(text));
 }
 
 inline str::str(const long long num)
-    : m_data(NULL)
 {
-    char   text[64];
-    size_t len;
+    char text[64];
 
+    SetEmpty();
     snprintf(text, sizeof(text), "%lld", num);
-    len = strlen(text);
-    EnsureAlloced(len + 1);
-    strcpy(m_data->data, text);
-    m_data->len = len;
+    Assign(text, strlen(text));
 }
 
 inline str::str(const unsigned long long num)
-    : m_data(NULL)
 {
-    char   text[64];
-    size_t len;
+    char text[64];
 
+    SetEmpty();
     snprintf(text, sizeof(text), "%llu", num);
-    len = strlen(text);
-    EnsureAlloced(len + 1);
-    strcpy(m_data->data, text);
-    m_data->len = len;
+    Assign(text, strlen(text));
 }
 
 inline const char *str::c_str(void) const
 {
-    if (m_data) {
-        return m_data->data;
-    } else {
-        return "";
-    }
+    return Data();
 }
 
 inline str::str(str&& string)
-    : m_data(string.m_data)
 {
-    string.m_data = NULL;
+    memcpy(m_inline, string.m_inline, sizeof(m_inline));
+    string.SetEmpty();
 }
 
 inline str& str::operator=(str&& string)
 {
-    if (m_data) {
-        m_data->DelRef();
-    }
+    if (this != &string) {
+        Release();
 
-    m_data        = string.m_data;
-    string.m_data = NULL;
+        memcpy(m_inline, string.m_inline, sizeof(m_inline));
+        string.SetEmpty();
+    }
 
     return *this;
 }
 
-inline void str::append(const char *text)
-{
-    size_t len;
-
-    assert(text);
-
-    if (*text) {
-        len = length();
-        len += strlen(text);
-        EnsureAlloced(len + 1);
-
-        strcat(m_data->data, text);
-        m_data->len = len;
-    }
-}
-
 inline void str::append(const str& text)
 {
     append(text.c_str());
@@ -433,67 +420,51 @@ inline char& str::operator[](intptr_t index)
 {
     // Used for result for invalid indices
     static char dummy = 0;
-    assert(m_data);
 
     // We don't know if they'll write to it or not
     // if it's not a const object
     EnsureDataWritable();
 
-    if (!m_data) {
-        return dummy;
-    }
-
     // don't include the '/0' in the test, because technically, it's out of bounds
-    assert((index >= 0) && (index < (int)m_data->len));
+    assert((index >= 0) && (index < (intptr_t)length()));
 
     // In release mode, let them change a safe variable
     // don't include the '/0' in the test, because technically, it's out of bounds
-    if ((index < 0) || (index >= (int)m_data->len)) {
+    if ((index < 0) || (index >= (intptr_t)length())) {
         return dummy;
     }
 
-    return m_data->data[index];
+    return Data()[index];
 }
 
 inline void str::operator=(const str& text)
 {
+    if (this == &text) {
+        return;
+    }
+
     // adding the reference before deleting our current reference prevents
     // us from deleting our string if we are copying from ourself
-    if (text.m_data) {
-        text.m_data->AddRef();
+    if (!text.IsInline()) {
+        text.m_heap.block->AddRef();
     }
 
-    if (m_data) {
-        m_data->DelRef();
+    if (!IsInline()) {
+        m_heap.block->DelRef();
     }
 
-    m_data = text.m_data;
+    memcpy(m_inline, text.m_inline, sizeof(m_inline));
 }
 
 inline void str::operator=(const char *text)
 {
-    size_t len;
-
     assert(text);
 
-    if (m_data) {
-        if (text == m_data->data) {
-            return; // Copying same thing.  Punt.
-        }
-
-        m_data->DelRef();
-        m_data = NULL;
+    if (text == Data()) {
+        return; // Copying same thing.  Punt.
     }
 
-    if (*text) {
-        len = strlen(text);
-
-        m_data          = new strdata;
-        m_data->len     = len;
-        m_data->alloced = len + 1;
-        m_data->data    = new char[len + 1];
-        strcpy(m_data->data, text);
-    }
+    Assign(text, strlen(text));
 }
 
 inline str operator+(const str& a, const str& b)
@@ -573,6 +544,10 @@ inline str& str::operator+=(const bool a)
 
 inline bool operator==(const str& a, const str& b)
 {
+    if (a.length() != b.length()) {
+        return false;
+    }
+
     return (!strcmp(a.c_str(), b.c_str()));
 }
 
@@ -647,26 +622,25 @@ inline int str::cmpn(const str& text, size_t n) const
 
 inline void str::tolower(void)
 {
-    if (m_data) {
+    if (length()) {
         EnsureDataWritable();
 
-        str::tolower(m_data->data);
+        str::tolower(Data());
     }
 }
 
 inline void str::toupper(void)
 {
-    if (m_data) {
+    if (length()) {
         EnsureDataWritable();
 
-        str::toupper(m_data->data);
+        str::toupper(Data());
     }
 }
 
 inline bool str::isNumeric(void) const
 {
-    assert(m_data);
-    return str::isNumeric(m_data->data);
+    return str::isNumeric(c_str());
 }
 
 inline str::operator const char *(void) const
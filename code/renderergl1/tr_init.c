@@ -61,11 +61,14 @@ cvar_t	*r_lodscale;
 cvar_t	*r_norefresh;
 cvar_t	*r_drawentities;
 cvar_t	*r_drawentitypoly;
+cvar_t	*r_skinning;
 cvar_t	*r_drawstaticmodels;
+cvar_t	*r_staticmodelpvs;
 cvar_t	*r_drawstaticmodelpoly;
 cvar_t	*r_drawbrushes;
 cvar_t	*r_drawbrushmodels;
 cvar_t	*r_drawstaticdecals;
+cvar_t	*r_frontendthreads;
 cvar_t	*r_drawterrain;
 cvar_t	*r_drawsprites;
 cvar_t	*r_drawspherelights;
@@ -1584,8 +1587,15 @@ void R_Register( void )
     r_showSkeleton = ri.Cvar_Get("r_showSkeleton", "0", CVAR_CHEAT);
 	r_aviMotionJpegQuality = ri.Cvar_Get("r_aviMotionJpegQuality", "90", CVAR_ARCHIVE);
     r_screenshotJpegQuality = ri.Cvar_Get("r_screenshotJpegQuality", "90", CVAR_ARCHIVE);
+	r_staticmodelpvs = ri.Cvar_Get("r_staticmodelpvs", "1", 0);
+	r_skinning = ri.Cvar_Get("r_skinning", "1", 0);
+	r_frontendthreads = ri.Cvar_Get("r_frontendthreads", "1", CVAR_ARCHIVE);
 
 	ri.Cmd_AddCommand( "ter_crater", R_TerrainCrater_f );
+	ri.Cmd_AddCommand( "r_staticmodelcullbench", R_StaticModelCullBench_f );
+	ri.Cmd_AddCommand( "r_skinbench", R_SkinBench_f );
+	ri.Cmd_AddCommand( "r_recordviews", R_RecordViews_f );
+	ri.Cmd_AddCommand( "r_frontendbench", R_FrontEndBench_f );
 }
 
 void R_InitExtensions() {
@@ -1731,6 +1741,10 @@ void RE_Shutdown( qboolean destroyWindow ) {
 	ri.Cmd_RemoveCommand ("skinlist");
 	ri.Cmd_RemoveCommand ("gfxinfo");
 	ri.Cmd_RemoveCommand( "modelist" );
+	ri.Cmd_RemoveCommand( "r_staticmodelcullbench" );
+	ri.Cmd_RemoveCommand( "r_skinbench" );
+	ri.Cmd_RemoveCommand( "r_recordviews" );
+	ri.Cmd_RemoveCommand( "r_frontendbench" );
 	ri.Cmd_RemoveCommand( "shaderstate" );
 
 
@@ -1756,6 +1770,11 @@ void RE_Shutdown( qboolean destroyWindow ) {
 
 	R_ShutdownTerrain();
 
+	R_ShutdownFrontEndBench();
+
+	R_ShutdownWorldJobs();
+	R_ShutdownFrontEndJobs();
+
 	tr.registered = qfalse;
 }
 
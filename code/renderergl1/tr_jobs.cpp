@@ -0,0 +1,204 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// tr_jobs.cpp: Worker threads running the front-end jobs
+//
+// The main thread takes part in every run as thread 0, the workers are
+// numbered from 1. Tasks are handed out one at a time so the threads
+// balance themselves, and a run returns once all of its tasks are done.
+// The jobs must not allocate memory nor write anything another job reads,
+// the main thread does the shared work once the run is over.
+//
+
+#include "tr_local.h"
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+struct frontEndJobs_t {
+    std::mutex              mutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable workersDone;
+    std::thread             workers[MAX_FRONTEND_THREADS - 1];
+    int                     numWorkers;
+    bool                    running;
+    int                     generation; // incremented for each run
+    int                     numBusy;    // workers that haven't finished the current run
+
+    frontEndJobFunc_t func;
+    void             *data;
+    int               numTasks;
+    std::atomic<int>  nextTask;
+};
+
+// allocated on first use so no thread is left to destroy at exit
+static frontEndJobs_t *r_frontEndJobs;
+
+/*
+==============
+R_FrontEndJobs_RunTasks
+==============
+*/
+static void R_FrontEndJobs_RunTasks(frontEndJobs_t *jobs, int thread)
+{
+    int task;
+
+    while ((task = jobs->nextTask.fetch_add(1, std::memory_order_relaxed)) < jobs->numTasks) {
+        jobs->func(task, thread, jobs->data);
+    }
+}
+
+/*
+==============
+R_FrontEndJobs_Worker
+==============
+*/
+static void R_FrontEndJobs_Worker(frontEndJobs_t *jobs, int thread, int generation)
+{
+    std::unique_lock<std::mutex> lock(jobs->mutex);
+
+    for (;;) {
+        jobs->wakeWorkers.wait(lock, [&] { return !jobs->running || jobs->generation != generation; });
+        if (!jobs->running) {
+            return;
+        }
+
+        generation = jobs->generation;
+
+        lock.unlock();
+        R_FrontEndJobs_RunTasks(jobs, thread);
+        lock.lock();
+
+        if (!--jobs->numBusy) {
+            jobs->workersDone.notify_one();
+        }
+    }
+}
+
+/*
+==============
+R_ShutdownFrontEndJobs
+==============
+*/
+void R_ShutdownFrontEndJobs(void)
+{
+    int i;
+
+    if (!r_frontEndJobs) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(r_frontEndJobs->mutex);
+        r_frontEndJobs->running = false;
+    }
+
+    r_frontEndJobs->wakeWorkers.notify_all();
+
+    for (i = 0; i < r_frontEndJobs->numWorkers; i++) {
+        r_frontEndJobs->workers[i].join();
+    }
+
+    delete r_frontEndJobs;
+    r_frontEndJobs = NULL;
+}
+
+/*
+==============
+R_FrontEndJobThreads
+
+Starts or stops workers to match r_frontendthreads,
+returns the number of threads a run will use
+==============
+*/
+int R_FrontEndJobThreads(void)
+{
+    int numThreads;
+    int i;
+
+    numThreads = Q_clamp_int(r_frontendthreads->integer, 1, MAX_FRONTEND_THREADS);
+
+    if (r_frontEndJobs && r_frontEndJobs->numWorkers == numThreads - 1) {
+        return numThreads;
+    }
+
+    R_ShutdownFrontEndJobs();
+
+    if (numThreads == 1) {
+        return numThreads;
+    }
+
+    r_frontEndJobs             = new frontEndJobs_t;
+    r_frontEndJobs->numWorkers = numThreads - 1;
+    r_frontEndJobs->running    = true;
+    r_frontEndJobs->generation = 0;
+    r_frontEndJobs->numBusy    = 0;
+    r_frontEndJobs->func       = NULL;
+    r_frontEndJobs->data       = NULL;
+    r_frontEndJobs->numTasks   = 0;
+    r_frontEndJobs->nextTask   = 0;
+
+    for (i = 0; i < r_frontEndJobs->numWorkers; i++) {
+        r_frontEndJobs->workers[i] = std::thread(R_FrontEndJobs_Worker, r_frontEndJobs, i + 1, 0);
+    }
+
+    return numThreads;
+}
+
+/*
+==============
+R_RunFrontEndJobs
+
+Calls func for each task, spread across the front-end threads
+==============
+*/
+void R_RunFrontEndJobs(frontEndJobFunc_t func, void *data, int numTasks)
+{
+    int task;
+
+    if (!r_frontEndJobs || numTasks < 2) {
+        for (task = 0; task < numTasks; task++) {
+            func(task, 0, data);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(r_frontEndJobs->mutex);
+
+        r_frontEndJobs->func     = func;
+        r_frontEndJobs->data     = data;
+        r_frontEndJobs->numTasks = numTasks;
+        r_frontEndJobs->nextTask = 0;
+        r_frontEndJobs->numBusy  = r_frontEndJobs->numWorkers;
+        r_frontEndJobs->generation++;
+    }
+
+    r_frontEndJobs->wakeWorkers.notify_all();
+
+    R_FrontEndJobs_RunTasks(r_frontEndJobs, 0);
+
+    std::unique_lock<std::mutex> lock(r_frontEndJobs->mutex);
+    r_frontEndJobs->workersDone.wait(lock, [] { return !r_frontEndJobs->numBusy; });
+}
@@ -956,6 +956,7 @@ typedef struct cTerraPatchUnpacked_s {
     int visCountDraw;
     int frameCount;
     unsigned int uiDistRecalc;
+    unsigned int uiMorphRecalc; // added in OPM
     float s;
     float t;
     vec2_t texCoord[2][2];
@@ -1128,6 +1129,11 @@ typedef struct {
     int numVisStaticModels;
     cStaticModelUnpacked_t** visStaticModels;
 
+    // added in OPM
+    //  world-space culling spheres of static models, as separate arrays for batch culling
+    float* staticModelCullOrigin[3];
+    float* staticModelCullRadius;
+
 	int			numClusters;
 	int			clusterBytes;
 	const byte	*vis;			// may be passed in by CM_LoadMap to save space
@@ -1461,11 +1467,14 @@ extern cvar_t	*r_dlightBacks;			// dlight non-facing surfaces for continuity
 extern	cvar_t	*r_norefresh;			// bypasses the ref rendering
 extern	cvar_t	*r_drawentities;		// disable/enable entity rendering
 extern	cvar_t	*r_drawentitypoly;
+extern	cvar_t	*r_skinning;
 extern	cvar_t	*r_drawstaticmodels;
+extern	cvar_t	*r_staticmodelpvs;
 extern	cvar_t	*r_drawstaticmodelpoly;
 extern	cvar_t	*r_drawbrushes;
 extern	cvar_t	*r_drawbrushmodels;
 extern	cvar_t	*r_drawstaticdecals;
+extern	cvar_t	*r_frontendthreads;
 extern	cvar_t	*r_drawterrain;
 extern	cvar_t	*r_drawsprites;
 extern	cvar_t	*r_drawspherelights;
@@ -1653,6 +1662,13 @@ void  R_NoiseInit( void );
 
 void R_RenderView( viewParms_t *parms );
 
+// added in OPM
+extern qboolean r_recordViews;
+void R_RecordView(const viewParms_t *parms);
+void R_RecordViews_f(void);
+void R_FrontEndBench_f(void);
+void R_ShutdownFrontEndBench(void);
+
 qboolean SurfIsOffscreen(const srfSurfaceFace_t* surface, shader_t* shader, int entityNum);
 
 void R_AddMD3Surfaces( trRefEntity_t *e );
@@ -1946,6 +1962,19 @@ mnode_t* R_PointInLeaf(const vec3_t p);
 int R_DlightTerrain(cTerraPatchUnpacked_t* surf, int dlightBits);
 int R_CheckDlightTerrain(cTerraPatchUnpacked_t* surf, int dlightBits);
 void R_AddWorldSurfaces( void );
+void R_ShutdownWorldJobs( void );
+
+//
+// tr_jobs.cpp
+//
+// added in OPM
+#define MAX_FRONTEND_THREADS 16
+
+typedef void (*frontEndJobFunc_t)(int task, int thread, void *data);
+
+int R_FrontEndJobThreads(void);
+void R_RunFrontEndJobs(frontEndJobFunc_t func, void *data, int numTasks);
+void R_ShutdownFrontEndJobs(void);
 qboolean R_inPVS( const vec3_t p1, const vec3_t p2 );
 
 
@@ -2189,6 +2218,7 @@ qboolean R_TerrainHeightForPoly(cTerraPatchUnpacked_t* pPatch, polyVert_t* pVert
 void R_SwapTerraPatch(cTerraPatch_t* pPatch);
 
 void R_TerrainCrater_f(void);
+void R_TerrainBenchmark_f(void);
 
 /*
 =============================================================
@@ -2217,9 +2247,11 @@ void RE_ForceUpdatePose(refEntity_t* model);
 void RE_SetFrameNumber(int frameNumber);
 void R_UpdatePoseInternal(refEntity_t* model);
 void RB_SkelMesh(skelSurfaceGame_t* sf);
+void R_SkinBench_f(void);
 void RB_StaticMesh(staticSurface_t* staticSurf);
 void RB_Static_BuildDLights();
 void R_InfoStaticModels_f(void);
+void R_StaticModelCullBench_f(void);
 void R_PrintInfoStaticModels();
 void R_AddSkelSurfaces(trRefEntity_t* ent);
 void R_AddStaticModelSurfaces(void);
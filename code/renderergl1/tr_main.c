@@ -1755,6 +1755,183 @@ void R_DrawDebugStrings(void) {
 	}
 }
 
+/*
+==============================================================================
+
+FRONT-END BENCHMARK
+
+Added in OPM
+  The main views are recorded, then replayed through the world front-end
+  (BSP walk, terrain tessellation and static models) without sending anything to the backend.
+  The BSP walk is split across r_frontendthreads threads, so the settings can be compared
+  Entities and scene polys aren't part of the replay as they only exist for the frame they were added in
+
+==============================================================================
+*/
+
+#define MAX_RECORDED_VIEWS 8192
+
+typedef struct recordedView_s {
+	viewParms_t	parms;
+	vec3_t		vieworg;
+	vec3_t		viewaxis[3];
+	float		fov_x, fov_y;
+	int			rdflags;
+	qboolean	render_terrain;
+	byte		areamask[MAX_MAP_AREA_BYTES];
+} recordedView_t;
+
+qboolean				r_recordViews;
+static recordedView_t	*r_recordedViews;
+static int				r_numRecordedViews;
+
+/*
+================
+R_RecordView
+================
+*/
+void R_RecordView(const viewParms_t *parms) {
+	recordedView_t *view;
+
+	if (r_numRecordedViews >= MAX_RECORDED_VIEWS) {
+		ri.Printf(PRINT_ALL, "R_RecordView: MAX_RECORDED_VIEWS reached, stopping the recording\n");
+		r_recordViews = qfalse;
+		return;
+	}
+
+	view = &r_recordedViews[r_numRecordedViews++];
+	view->parms = *parms;
+	VectorCopy(tr.refdef.vieworg, view->vieworg);
+	AxisCopy(tr.refdef.viewaxis, view->viewaxis);
+	view->fov_x = tr.refdef.fov_x;
+	view->fov_y = tr.refdef.fov_y;
+	view->rdflags = tr.refdef.rdflags;
+	view->render_terrain = tr.refdef.render_terrain;
+	Com_Memcpy(view->areamask, tr.refdef.areamask, sizeof(view->areamask));
+}
+
+/*
+================
+R_RecordViews_f
+================
+*/
+void R_RecordViews_f(void) {
+	if (r_recordViews) {
+		r_recordViews = qfalse;
+		ri.Printf(PRINT_ALL, "Recorded %d views\n", r_numRecordedViews);
+		return;
+	}
+
+	if (!r_recordedViews) {
+		r_recordedViews = ri.Malloc(sizeof(recordedView_t) * MAX_RECORDED_VIEWS);
+	}
+
+	r_numRecordedViews = 0;
+	r_recordViews = qtrue;
+	ri.Printf(PRINT_ALL, "Recording views, use r_recordviews again to stop\n");
+}
+
+/*
+================
+R_FrontEndBench_f
+================
+*/
+void R_FrontEndBench_f(void) {
+	trRefdef_t		savedRefdef;
+	viewParms_t		savedViewParms;
+	orientationr_t	savedOri;
+	int				numIterations;
+	int				startTime, totalTime;
+	int				numDrawSurfs;
+	int				i, n;
+
+	if (!tr.world) {
+		ri.Printf(PRINT_ALL, "No world loaded\n");
+		return;
+	}
+
+	if (r_recordViews || !r_numRecordedViews) {
+		ri.Printf(PRINT_ALL, "Record some views first with r_recordviews\n");
+		return;
+	}
+
+	numIterations = 1;
+	if (ri.Cmd_Argc() > 1) {
+		numIterations = Q_max(atoi(ri.Cmd_Argv(1)), 1);
+	}
+
+	R_IssuePendingRenderCommands();
+
+	savedRefdef = tr.refdef;
+	savedViewParms = tr.viewParms;
+	savedOri = tr.ori;
+
+	tr.refdef.num_dlights = 0;
+	numDrawSurfs = 0;
+	totalTime = 0;
+
+	for (n = 0; n < numIterations; n++) {
+		for (i = 0; i < r_numRecordedViews; i++) {
+			const recordedView_t *view = &r_recordedViews[i];
+
+			VectorCopy(view->vieworg, tr.refdef.vieworg);
+			AxisCopy(view->viewaxis, tr.refdef.viewaxis);
+			tr.refdef.fov_x = view->fov_x;
+			tr.refdef.fov_y = view->fov_y;
+			tr.refdef.rdflags = view->rdflags;
+			tr.refdef.render_terrain = view->render_terrain;
+			Com_Memcpy(tr.refdef.areamask, view->areamask, sizeof(tr.refdef.areamask));
+			tr.refdef.numDrawSurfs = 0;
+			g_nStaticSurfaces = 0;
+
+			startTime = ri.Milliseconds();
+
+			tr.viewCount++;
+			tr.viewParms = view->parms;
+			tr.viewCount++;
+
+			R_RotateForViewer();
+			R_SetupFrustum();
+			R_AddWorldSurfaces();
+
+			totalTime += ri.Milliseconds() - startTime;
+			numDrawSurfs += tr.refdef.numDrawSurfs;
+		}
+	}
+
+	tr.refdef = savedRefdef;
+	tr.viewParms = savedViewParms;
+	tr.ori = savedOri;
+	// the static surfaces of the current frame were already sent
+	g_nStaticSurfaces = 0;
+
+	ri.Printf(
+		PRINT_ALL,
+		"%d views x %d, %d threads: %d ms total, %.3f ms per view, %.1f draw surfs per view\n",
+		r_numRecordedViews,
+		numIterations,
+		R_FrontEndJobThreads(),
+		totalTime,
+		(float)totalTime / (r_numRecordedViews * numIterations),
+		(float)numDrawSurfs / (r_numRecordedViews * numIterations)
+	);
+}
+
+/*
+================
+R_ShutdownFrontEndBench
+================
+*/
+void R_ShutdownFrontEndBench(void) {
+	r_recordViews = qfalse;
+	r_numRecordedViews = 0;
+
+	if (r_recordedViews) {
+		ri.Free(r_recordedViews);
+		r_recordedViews = NULL;
+	}
+}
+
 /*
 ================
 R_RenderView
@@ -1771,6 +1948,10 @@ void R_RenderView (viewParms_t *parms) {
 		return;
 	}
 
+	if (r_recordViews && !parms->isPortal && !parms->isPortalSky && !(tr.refdef.rdflags & RDF_NOWORLDMODEL)) {
+		R_RecordView(parms);
+	}
+
 	tr.viewCount++;
 
 	tr.viewParms = *parms;
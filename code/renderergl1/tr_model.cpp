@@ -26,6 +26,11 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "tiki.h"
 #include <vector.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define USE_SSE2_SKINNING 1
+#    include <emmintrin.h>
+#endif
+
 #define LL(x) x = LittleLong(x)
 
 qboolean   g_bInfoworldtris = qfalse;
@@ -1014,6 +1019,318 @@ inline static void SkelWeightMorphGetXyz(skelWeight_t *weight, skelBoneCache_t *
             * weight->boneWeight;
 }
 
+/*
+=============
+R_PackSkelSurface
+
+Added in OPM
+  Repacks the vertex weights of the surface into a contiguous stream,
+  so the skinning doesn't have to step over the morphs of each vertex.
+  Surfaces with a vertex without any weight are left unpacked
+=============
+*/
+static skelPackedSurface_t *R_PackSkelSurface(skelSurfaceGame_t *sf)
+{
+    skelPackedSurface_t *packed;
+    skeletorVertex_t    *vert;
+    skelWeight_t        *weight;
+    byte                *buf;
+    int                  numWeights;
+    int                  i, j, k;
+
+    numWeights = 0;
+    vert       = sf->pVerts;
+    for (i = 0; i < sf->numVerts; i++) {
+        if (vert->numWeights <= 0) {
+            // can't be packed
+            packed = (skelPackedSurface_t *)ri.TIKI_Alloc(sizeof(skelPackedSurface_t));
+            memset(packed, 0, sizeof(skelPackedSurface_t));
+            sf->pPacked = packed;
+            return packed;
+        }
+
+        numWeights += vert->numWeights;
+        vert = (skeletorVertex_t *)((byte *)vert + sizeof(skeletorVertex_t) + sizeof(skeletorMorph_t) * vert->numMorphs
+                                    + sizeof(skelWeight_t) * vert->numWeights);
+    }
+
+    buf = (byte *)ri.TIKI_Alloc(
+        sizeof(skelPackedSurface_t) + sizeof(skelPackedWeight_t) * numWeights + sizeof(int) * numWeights
+        + sizeof(skelPackedVert_t) * sf->numVerts
+    );
+
+    packed = (skelPackedSurface_t *)buf;
+    buf += sizeof(skelPackedSurface_t);
+    packed->pWeights = (skelPackedWeight_t *)buf;
+    buf += sizeof(skelPackedWeight_t) * numWeights;
+    packed->pBoneIndexes = (int *)buf;
+    buf += sizeof(int) * numWeights;
+    packed->pVerts = (skelPackedVert_t *)buf;
+
+    packed->numVerts   = sf->numVerts;
+    packed->numWeights = numWeights;
+
+    k    = 0;
+    vert = sf->pVerts;
+    for (i = 0; i < sf->numVerts; i++) {
+        VectorCopy(vert->normal, packed->pVerts[i].normal);
+        packed->pVerts[i].texCoords[0] = vert->texCoords[0];
+        packed->pVerts[i].texCoords[1] = vert->texCoords[1];
+        packed->pVerts[i].numWeights   = vert->numWeights;
+
+        weight = (skelWeight_t *)((byte *)vert + sizeof(skeletorVertex_t) + sizeof(skeletorMorph_t) * vert->numMorphs);
+        for (j = 0; j < vert->numWeights; j++, k++) {
+            VectorCopy(weight[j].offset, packed->pWeights[k].offset);
+            packed->pWeights[k].boneWeight = weight[j].boneWeight;
+            packed->pBoneIndexes[k]        = weight[j].boneIndex;
+        }
+
+        vert = (skeletorVertex_t *)((byte *)vert + sizeof(skeletorVertex_t) + sizeof(skeletorMorph_t) * vert->numMorphs
+                                    + sizeof(skelWeight_t) * vert->numWeights);
+    }
+
+    sf->pPacked = packed;
+    return packed;
+}
+
+/*
+=============
+R_SkinPackedVerts_scalar
+=============
+*/
+static void R_SkinPackedVerts_scalar(
+    const skelPackedSurface_t *packed,
+    const skelBoneCache_t     *bones,
+    const int                 *boneRemap,
+    int                        numVerts,
+    float                      scale,
+    float                     *outXyz,
+    vec4_t                    *outNormal,
+    vec2_t (*outTexCoords)[2]
+)
+{
+    const skelPackedVert_t   *vert   = packed->pVerts;
+    const skelPackedWeight_t *weight = packed->pWeights;
+    const int                *index  = packed->pBoneIndexes;
+    const skelBoneCache_t    *bone;
+    int                       vertNum, weightNum;
+
+    for (vertNum = 0; vertNum < numVerts; vertNum++, vert++) {
+        vec3_t out;
+
+        VectorClear(out);
+
+        bone = &bones[boneRemap ? boneRemap[*index] : *index];
+
+        (*outNormal)[0] = vert->normal[0] * bone->matrix[0][0] + vert->normal[1] * bone->matrix[1][0]
+                        + vert->normal[2] * bone->matrix[2][0];
+        (*outNormal)[1] = vert->normal[0] * bone->matrix[0][1] + vert->normal[1] * bone->matrix[1][1]
+                        + vert->normal[2] * bone->matrix[2][1];
+        (*outNormal)[2] = vert->normal[0] * bone->matrix[0][2] + vert->normal[1] * bone->matrix[1][2]
+                        + vert->normal[2] * bone->matrix[2][2];
+
+        for (weightNum = 0; weightNum < vert->numWeights; weightNum++, weight++, index++) {
+            bone = &bones[boneRemap ? boneRemap[*index] : *index];
+
+            out[0] += ((weight->offset[0] * bone->matrix[0][0] + weight->offset[1] * bone->matrix[1][0]
+                        + weight->offset[2] * bone->matrix[2][0])
+                       + bone->offset[0])
+                    * weight->boneWeight;
+            out[1] += ((weight->offset[0] * bone->matrix[0][1] + weight->offset[1] * bone->matrix[1][1]
+                        + weight->offset[2] * bone->matrix[2][1])
+                       + bone->offset[1])
+                    * weight->boneWeight;
+            out[2] += ((weight->offset[0] * bone->matrix[0][2] + weight->offset[1] * bone->matrix[1][2]
+                        + weight->offset[2] * bone->matrix[2][2])
+                       + bone->offset[2])
+                    * weight->boneWeight;
+        }
+
+        VectorScale(out, scale, outXyz);
+
+        outTexCoords[vertNum][0][0] = vert->texCoords[0];
+        outTexCoords[vertNum][0][1] = vert->texCoords[1];
+
+        outXyz += 4;
+        outNormal++;
+    }
+}
+
+#if USE_SSE2_SKINNING
+/*
+=============
+R_SkinPackedVerts_sse2
+
+Same as R_SkinPackedVerts_scalar, but each bone row is transformed in one register.
+The operations are done in the same order so the result is identical.
+The 4th component of the output is left untouched
+=============
+*/
+static void R_SkinPackedVerts_sse2(
+    const skelPackedSurface_t *packed,
+    const skelBoneCache_t     *bones,
+    const int                 *boneRemap,
+    int                        numVerts,
+    float                      scale,
+    float                     *outXyz,
+    vec4_t                    *outNormal,
+    vec2_t (*outTexCoords)[2]
+)
+{
+    const skelPackedVert_t   *vert   = packed->pVerts;
+    const skelPackedWeight_t *weight = packed->pWeights;
+    const int                *index  = packed->pBoneIndexes;
+    const skelBoneCache_t    *bone;
+    const __m128              vScale = _mm_set1_ps(scale);
+    int                       vertNum, weightNum;
+
+    for (vertNum = 0; vertNum < numVerts; vertNum++, vert++) {
+        __m128 out, normal;
+
+        bone = &bones[boneRemap ? boneRemap[*index] : *index];
+
+        normal = _mm_add_ps(
+            _mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(vert->normal[0]), _mm_loadu_ps(bone->matrix[0])),
+                _mm_mul_ps(_mm_set1_ps(vert->normal[1]), _mm_loadu_ps(bone->matrix[1]))
+            ),
+            _mm_mul_ps(_mm_set1_ps(vert->normal[2]), _mm_loadu_ps(bone->matrix[2]))
+        );
+
+        out = _mm_setzero_ps();
+        for (weightNum = 0; weightNum < vert->numWeights; weightNum++, weight++, index++) {
+            const __m128 w = _mm_loadu_ps(weight->offset);
+            __m128       p;
+
+            bone = &bones[boneRemap ? boneRemap[*index] : *index];
+
+            p = _mm_add_ps(
+                _mm_mul_ps(_mm_shuffle_ps(w, w, _MM_SHUFFLE(0, 0, 0, 0)), _mm_loadu_ps(bone->matrix[0])),
+                _mm_mul_ps(_mm_shuffle_ps(w, w, _MM_SHUFFLE(1, 1, 1, 1)), _mm_loadu_ps(bone->matrix[1]))
+            );
+            p = _mm_add_ps(p, _mm_mul_ps(_mm_shuffle_ps(w, w, _MM_SHUFFLE(2, 2, 2, 2)), _mm_loadu_ps(bone->matrix[2])));
+            p = _mm_add_ps(p, _mm_loadu_ps(bone->offset));
+
+            out = _mm_add_ps(out, _mm_mul_ps(p, _mm_shuffle_ps(w, w, _MM_SHUFFLE(3, 3, 3, 3))));
+        }
+
+        out = _mm_mul_ps(out, vScale);
+
+        // store xyz only
+        _mm_storel_pi((__m64 *)outXyz, out);
+        _mm_store_ss(outXyz + 2, _mm_movehl_ps(out, out));
+        _mm_storel_pi((__m64 *)*outNormal, normal);
+        _mm_store_ss(*outNormal + 2, _mm_movehl_ps(normal, normal));
+
+        outTexCoords[vertNum][0][0] = vert->texCoords[0];
+        outTexCoords[vertNum][0][1] = vert->texCoords[1];
+
+        outXyz += 4;
+        outNormal++;
+    }
+}
+#endif
+
+/*
+=============
+R_SkinPackedVerts
+=============
+*/
+static void R_SkinPackedVerts(
+    const skelPackedSurface_t *packed,
+    const skelBoneCache_t     *bones,
+    const int                 *boneRemap,
+    int                        numVerts,
+    float                      scale,
+    float                     *outXyz,
+    vec4_t                    *outNormal,
+    vec2_t (*outTexCoords)[2]
+)
+{
+#if USE_SSE2_SKINNING
+    if (r_skinning->integer == 1) {
+        R_SkinPackedVerts_sse2(packed, bones, boneRemap, numVerts, scale, outXyz, outNormal, outTexCoords);
+        return;
+    }
+#endif
+
+    R_SkinPackedVerts_scalar(packed, bones, boneRemap, numVerts, scale, outXyz, outNormal, outTexCoords);
+}
+
+/*
+=============
+R_SkinVerts
+
+Skins the vertices the original way, walking the weights stored after each vertex.
+Used for morphed models and as a reference for the packed skinning
+=============
+*/
+static void R_SkinVerts(
+    skelSurfaceGame_t     *sf,
+    const skelBoneCache_t *bones,
+    const int             *boneRemap,
+    int                    numVerts,
+    float                  scale,
+    float                 *outXyz,
+    vec4_t                *outNormal,
+    vec2_t (*outTexCoords)[2]
+)
+{
+    skeletorVertex_t *newVerts = sf->pVerts;
+    skelWeight_t     *weight;
+    skelBoneCache_t  *bone;
+    int               vertNum, weightNum;
+
+    for (vertNum = 0; vertNum < numVerts; vertNum++) {
+        vec3_t normal;
+        vec3_t out;
+
+        VectorClear(out);
+
+        weight = (skelWeight_t *)((byte *)newVerts + sizeof(skeletorVertex_t)
+                                  + sizeof(skeletorMorph_t) * newVerts->numMorphs);
+
+        bone = (skelBoneCache_t *)&bones[boneRemap ? boneRemap[weight->boneIndex] : weight->boneIndex];
+        SkelVertGetNormal(newVerts, bone, normal);
+
+        for (weightNum = 0; weightNum < newVerts->numWeights; weightNum++) {
+            bone = (skelBoneCache_t *)&bones[boneRemap ? boneRemap[weight->boneIndex] : weight->boneIndex];
+
+            SkelWeightGetXyz(weight, bone, out);
+
+            weight++;
+        }
+
+        VectorCopy(normal, *outNormal);
+        VectorScale(out, scale, outXyz);
+
+        outTexCoords[vertNum][0][0] = newVerts->texCoords[0];
+        outTexCoords[vertNum][0][1] = newVerts->texCoords[1];
+
+        newVerts = (skeletorVertex_t *)((byte *)newVerts + sizeof(skeletorVertex_t)
+                                        + sizeof(skeletorMorph_t) * newVerts->numMorphs
+                                        + sizeof(skelWeight_t) * newVerts->numWeights);
+        outXyz += 4;
+        outNormal++;
+    }
+}
+
+/*
+=============
+R_GetSkelBoneRemap
+
+Maps the bones of a mesh to the bones of the tiki, for meshes other than the first one
+=============
+*/
+static void R_GetSkelBoneRemap(dtiki_t *tiki, skelHeaderGame_t *skelmodel, int *boneRemap)
+{
+    int i;
+
+    for (i = 0; i < skelmodel->numBones; i++) {
+        boneRemap[i] = ri.TIKI_GetLocalChannel(tiki, skelmodel->pBones[i].channel);
+    }
+}
+
 /*
 =============
 RB_SkelMesh
@@ -1317,6 +1634,28 @@ void RB_SkelMesh(skelSurfaceGame_t *sf)
                 outNormal++;
             }
         }
+    } else if (r_skinning->integer && (mesh == 0 || skelmodel->numBones <= TIKI_MAX_BONES)
+               && (sf->pPacked || R_PackSkelSurface(sf)) && sf->pPacked->numVerts) {
+        //
+        // Added in OPM
+        //  Skin from the packed weights
+        //
+        int boneRemap[TIKI_MAX_BONES];
+
+        if (mesh > 0) {
+            R_GetSkelBoneRemap(tiki, skelmodel, boneRemap);
+        }
+
+        R_SkinPackedVerts(
+            sf->pPacked,
+            bones,
+            mesh > 0 ? boneRemap : NULL,
+            render_count,
+            scale,
+            outXyz,
+            outNormal,
+            &tess.texCoords[baseVertex]
+        );
     } else {
         if (mesh > 0) {
             for (vertNum = 0; vertNum < render_count; vertNum++) {
@@ -2006,4 +2345,155 @@ int R_LerpTag(orientation_t *tag, qhandle_t handle, int startFrame, int endFrame
 {
     // stub
     return 0;
-}
\ No newline at end of file
+}
+
+/*
+=============
+R_SkinBench_f
+
+Added in OPM
+  Skins all the surfaces of a model in its first frame
+  with the original and the packed skinning,
+  then compares the results and prints the throughput
+=============
+*/
+void R_SkinBench_f(void)
+{
+    char             szTemp[MAX_QPATH];
+    dtiki_t         *tiki;
+    skelBoneCache_t  bones[TIKI_MAX_BONES];
+    int              boneRemap[TIKI_MAX_BONES];
+    float            radius;
+    vec3_t           mins, maxs;
+    vec4_t          *refXyz, *refNormal;
+    vec4_t          *xyz, *normal;
+    vec2_t (*texCoords)[2];
+    int              numIterations;
+    int              numVerts;
+    int              refTime, packedTime;
+    int              startTime;
+    int              mesh, surf;
+    int              i, j, n;
+    float            maxError;
+
+    if (ri.Cmd_Argc() < 2) {
+        ri.Printf(PRINT_ALL, "Usage: r_skinbench <tiki> [iterations]\n");
+        return;
+    }
+
+    if (!strnicmp(ri.Cmd_Argv(1), "models", 6)) {
+        Q_strncpyz(szTemp, ri.Cmd_Argv(1), sizeof(szTemp));
+    } else {
+        Com_sprintf(szTemp, sizeof(szTemp), "models/%s", ri.Cmd_Argv(1));
+    }
+
+    tiki = ri.TIKI_RegisterTikiFlags(szTemp, qfalse);
+    if (!tiki) {
+        ri.Printf(PRINT_ALL, "Couldn't load %s\n", szTemp);
+        return;
+    }
+
+    numIterations = 1000;
+    if (ri.Cmd_Argc() > 2) {
+        numIterations = Q_max(atoi(ri.Cmd_Argv(2)), 1);
+    }
+
+    ri.TIKI_GetSkelAnimFrame(tiki, bones, &radius, &mins, &maxs);
+
+    refXyz    = (vec4_t *)ri.Malloc(sizeof(vec4_t) * TIKI_MAX_VERTEXES);
+    refNormal = (vec4_t *)ri.Malloc(sizeof(vec4_t) * TIKI_MAX_VERTEXES);
+    xyz       = (vec4_t *)ri.Malloc(sizeof(vec4_t) * TIKI_MAX_VERTEXES);
+    normal    = (vec4_t *)ri.Malloc(sizeof(vec4_t) * TIKI_MAX_VERTEXES);
+    texCoords = (vec2_t(*)[2])ri.Malloc(sizeof(vec2_t) * 2 * TIKI_MAX_VERTEXES);
+
+    numVerts   = 0;
+    refTime    = 0;
+    packedTime = 0;
+    maxError   = 0;
+
+    for (mesh = 0; mesh < tiki->numMeshes; mesh++) {
+        skelHeaderGame_t  *skelmodel = ri.TIKI_GetSkel(tiki->mesh[mesh]);
+        skelSurfaceGame_t *sf;
+        int               *remap;
+
+        if (!skelmodel) {
+            continue;
+        }
+
+        remap = NULL;
+        if (mesh > 0) {
+            if (skelmodel->numBones > TIKI_MAX_BONES) {
+                continue;
+            }
+
+            R_GetSkelBoneRemap(tiki, skelmodel, boneRemap);
+            remap = boneRemap;
+        }
+
+        sf = skelmodel->pSurfaces;
+        for (surf = 0; surf < skelmodel->numSurfaces; surf++, sf = sf->pNext) {
+            if (sf->numVerts > TIKI_MAX_VERTEXES) {
+                continue;
+            }
+
+            if (!sf->pPacked) {
+                R_PackSkelSurface(sf);
+            }
+
+            if (!sf->pPacked->numVerts) {
+                continue;
+            }
+
+            startTime = ri.Milliseconds();
+            for (n = 0; n < numIterations; n++) {
+                R_SkinVerts(sf, bones, remap, sf->numVerts, tiki->load_scale, refXyz[0], refNormal, texCoords);
+            }
+            refTime += ri.Milliseconds() - startTime;
+
+            startTime = ri.Milliseconds();
+            for (n = 0; n < numIterations; n++) {
+                R_SkinPackedVerts(sf->pPacked, bones, remap, sf->numVerts, tiki->load_scale, xyz[0], normal, texCoords);
+            }
+            packedTime += ri.Milliseconds() - startTime;
+
+            for (i = 0; i < sf->numVerts; i++) {
+                for (j = 0; j < 3; j++) {
+                    maxError = Q_max(maxError, fabs(xyz[i][j] - refXyz[i][j]));
+                    maxError = Q_max(maxError, fabs(normal[i][j] - refNormal[i][j]));
+                }
+            }
+
+            numVerts += sf->numVerts;
+        }
+    }
+
+    ri.Free(refXyz);
+    ri.Free(refNormal);
+    ri.Free(xyz);
+    ri.Free(normal);
+    ri.Free(texCoords);
+
+    if (!numVerts) {
+        ri.Printf(PRINT_ALL, "No skinnable surface in %s\n", szTemp);
+        return;
+    }
+
+    ri.Printf(
+        PRINT_ALL,
+        "%d vertices, %d iterations, max error %f\n"
+        "original: %d ms (%.0f verts/sec)\n"
+        "packed%s: %d ms (%.0f verts/sec)\n",
+        numVerts,
+        numIterations,
+        maxError,
+        refTime,
+        refTime ? (double)numVerts * numIterations * 1000.0 / refTime : 0.0,
+#if USE_SSE2_SKINNING
+        r_skinning->integer == 1 ? " (sse2)" : "",
+#else
+        "",
+#endif
+        packedTime,
+        packedTime ? (double)numVerts * numIterations * 1000.0 / packedTime : 0.0
+    );
+}
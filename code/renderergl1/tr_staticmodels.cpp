@@ -32,6 +32,67 @@ int             g_nStaticSurfaces;
 staticSurface_t g_staticSurfaces[MAX_STATIC_MODELS_SURFS];
 qboolean        g_bInfostaticmodels = qfalse;
 
+//
+// Added in OPM
+//  Scratch buffers for the batched culling, allocated with the world
+//
+static int   *g_pStaticCullIndexes;
+static float *g_pStaticCullOrigin[3];
+static float *g_pStaticCullRadius;
+static byte  *g_pStaticCullResults;
+
+/*
+==============
+R_InitStaticModelCull
+
+Precomputes the world-space culling sphere of each static model
+==============
+*/
+static void R_InitStaticModelCull(void)
+{
+    cStaticModelUnpacked_t *pSM;
+    vec3_t                  localOrigin;
+    float                   tiki_scale;
+    int                     numModels;
+    int                     i, j;
+
+    numModels = tr.world->numStaticModels;
+    if (!numModels) {
+        return;
+    }
+
+    for (i = 0; i < 3; i++) {
+        tr.world->staticModelCullOrigin[i] = (float *)ri.Hunk_Alloc(numModels * sizeof(float), h_dontcare);
+        g_pStaticCullOrigin[i]             = (float *)ri.Hunk_Alloc(numModels * sizeof(float), h_dontcare);
+    }
+    tr.world->staticModelCullRadius = (float *)ri.Hunk_Alloc(numModels * sizeof(float), h_dontcare);
+    g_pStaticCullRadius             = (float *)ri.Hunk_Alloc(numModels * sizeof(float), h_dontcare);
+    g_pStaticCullIndexes            = (int *)ri.Hunk_Alloc(numModels * sizeof(int), h_dontcare);
+    g_pStaticCullResults            = (byte *)ri.Hunk_Alloc(numModels * sizeof(byte), h_dontcare);
+
+    for (i = 0; i < numModels; i++) {
+        pSM = &tr.world->staticModels[i];
+
+        if (!pSM->tiki) {
+            for (j = 0; j < 3; j++) {
+                tr.world->staticModelCullOrigin[j][i] = pSM->origin[j];
+            }
+            tr.world->staticModelCullRadius[i] = 0;
+            continue;
+        }
+
+        tiki_scale = pSM->tiki->load_scale * pSM->scale;
+        VectorScale(pSM->tiki->load_origin, tiki_scale, localOrigin);
+
+        for (j = 0; j < 3; j++) {
+            tr.world->staticModelCullOrigin[j][i] = pSM->origin[j] + localOrigin[0] * pSM->axis[0][j]
+                                                  + localOrigin[1] * pSM->axis[1][j]
+                                                  + localOrigin[2] * pSM->axis[2][j];
+        }
+        tr.world->staticModelCullRadius[i] = pSM->cull_radius;
+    }
+}
+
 /*
 ==============
 R_InitStaticModels
@@ -216,6 +277,8 @@ void R_InitStaticModels(void)
         }
     }
 
+    R_InitStaticModelCull();
+
     tr.refdef.numStaticModels    = tr.world->numStaticModels;
     tr.refdef.staticModels       = tr.world->staticModels;
     tr.refdef.numStaticModelData = tr.world->numStaticModelData;
@@ -287,6 +350,92 @@ static int R_CullStaticModel(dtiki_t *tiki, float fScale, const vec3_t vLocalOrg
     return cull;
 }
 
+/*
+==============
+R_GatherStaticModelCandidates
+
+Collects the static models that are in a visible leaf
+and copies their culling spheres into contiguous arrays
+==============
+*/
+static int R_GatherStaticModelCandidates(void)
+{
+    const cStaticModelUnpacked_t *SM;
+    qboolean                      usePVS;
+    int                           numCandidates;
+    int                           i;
+
+    // the leaf marks are only valid if the world was traversed for this view
+    usePVS = r_staticmodelpvs->integer && r_drawworld->integer && !(tr.refdef.rdflags & RDF_NOWORLDMODEL)
+          && !r_nocull->integer;
+
+    numCandidates = 0;
+    for (i = 0; i < tr.world->numStaticModels; i++) {
+        SM = &tr.world->staticModels[i];
+
+        if (!SM->tiki) {
+            continue;
+        }
+
+        if (usePVS && SM->visCount != tr.visCount) {
+            continue;
+        }
+
+        g_pStaticCullIndexes[numCandidates]   = i;
+        g_pStaticCullOrigin[0][numCandidates] = tr.world->staticModelCullOrigin[0][i];
+        g_pStaticCullOrigin[1][numCandidates] = tr.world->staticModelCullOrigin[1][i];
+        g_pStaticCullOrigin[2][numCandidates] = tr.world->staticModelCullOrigin[2][i];
+        g_pStaticCullRadius[numCandidates]    = tr.world->staticModelCullRadius[i];
+        numCandidates++;
+    }
+
+    return numCandidates;
+}
+
+/*
+==============
+R_CullStaticModelSpheres
+
+Same as R_CullPointAndRadius, but tests all the gathered spheres one plane at a time.
+The inner loop is branchless so it gets vectorized by the compiler
+==============
+*/
+static void R_CullStaticModelSpheres(int numCandidates)
+{
+    const float *x       = g_pStaticCullOrigin[0];
+    const float *y       = g_pStaticCullOrigin[1];
+    const float *z       = g_pStaticCullOrigin[2];
+    const float *r       = g_pStaticCullRadius;
+    byte        *results = g_pStaticCullResults;
+    int          i, j;
+
+    if (r_nocull->integer) {
+        memset(results, CULL_CLIP, numCandidates);
+        return;
+    }
+
+    memset(results, CULL_IN, numCandidates);
+
+    for (i = 0; i < tr.viewParms.fog.extrafrustums + 4; i++) {
+        const cplane_t *frust = &tr.viewParms.frustum[i];
+        const float     nx    = frust->normal[0];
+        const float     ny    = frust->normal[1];
+        const float     nz    = frust->normal[2];
+        const float     d     = frust->dist;
+
+        for (j = 0; j < numCandidates; j++) {
+            const float dist = x[j] * nx + y[j] * ny + z[j] * nz - d;
+
+            results[j] |= ((dist < -r[j]) << 1) | (dist <= r[j]);
+        }
+    }
+
+    for (j = 0; j < numCandidates; j++) {
+        // outside of any plane takes precedence over clipping
+        results[j] = (results[j] & CULL_OUT) ? CULL_OUT : results[j];
+    }
+}
+
 /*
 ==============
 R_AddStaticModelSurfaces
@@ -295,7 +444,8 @@ R_AddStaticModelSurfaces
 void R_AddStaticModelSurfaces(void)
 {
     cStaticModelUnpacked_t *SM;
-    int                     i, j, k;
+    int                     i, j, k, n;
+    int                     numCandidates;
     int                     ofsStaticData;
     int                     iRadiusCull;
     dtiki_t                *tiki;
@@ -309,16 +459,36 @@ void R_AddStaticModelSurfaces(void)
 
     tr.shiftedIsStatic = (1 << QSORT_STATICMODEL_SHIFT);
 
-    for (i = 0; i < tr.world->numStaticModels; i++) {
-        SM = &tr.world->staticModels[i];
+    //
+    // Added in OPM
+    //  Filter by the leaves marked in R_RecursiveWorldNode,
+    //  then test the remaining bounding spheres in batch
+    //
+    numCandidates = R_GatherStaticModelCandidates();
+    R_CullStaticModelSpheres(numCandidates);
 
-        //if( SM->visCount != tr.visCounts[ tr.visIndex ] ) {
-        //	continue;
-        //}
+    for (n = 0; n < numCandidates; n++) {
+        i           = g_pStaticCullIndexes[n];
+        SM          = &tr.world->staticModels[i];
+        tiki        = SM->tiki;
+        iRadiusCull = g_pStaticCullResults[n];
 
-        tiki = SM->tiki;
+        tiki_worldorigin[0] = g_pStaticCullOrigin[0][n];
+        tiki_worldorigin[1] = g_pStaticCullOrigin[1][n];
+        tiki_worldorigin[2] = g_pStaticCullOrigin[2][n];
 
-        if (!tiki) {
+        if (r_showcull->integer & 8) {
+            switch (iRadiusCull) {
+            case CULL_IN:
+                R_DebugCircle(tiki_worldorigin, SM->cull_radius * 1.2, 0.0, 1.0, 0.0, 0.5, 0);
+                break;
+            case CULL_OUT:
+                R_DebugCircle(tiki_worldorigin, SM->cull_radius * 1.4 + 16.0, 1.0, 0.2, 0.2, 0.5, 0);
+                break;
+            }
+        }
+
+        if (iRadiusCull == CULL_OUT) {
             continue;
         }
 
@@ -329,26 +499,10 @@ void R_AddStaticModelSurfaces(void)
 
         ofsStaticData = 0;
 
-        // get the world position
         tiki_scale = tiki->load_scale * SM->scale;
         VectorScale(tiki->load_origin, tiki_scale, tiki_localorigin);
-        R_LocalPointToWorld(tiki_localorigin, tiki_worldorigin);
-
-        iRadiusCull = R_CullPointAndRadius(tiki_worldorigin, SM->cull_radius);
-
-        if (r_showcull->integer & 8) {
-            switch (iRadiusCull) {
-            case CULL_IN:
-                R_DebugCircle(tiki_worldorigin, SM->cull_radius * 1.2, 0.0, 1.0, 0.0, 0.5, 0);
-                break;
-            case CULL_OUT:
-                R_DebugCircle(tiki_worldorigin, SM->cull_radius * 1.4 + 16.0, 1.0, 0.2, 0.2, 0.5, 0);
-                break;
-            }
-        }
 
-        if (iRadiusCull != CULL_OUT
-            && (iRadiusCull != CULL_CLIP || R_CullStaticModel(SM->tiki, tiki_scale, tiki_localorigin) != CULL_OUT)) {
+        if (iRadiusCull != CULL_CLIP || R_CullStaticModel(SM->tiki, tiki_scale, tiki_localorigin) != CULL_OUT) {
             dtikisurface_t *dsurf;
 
             if (tr.viewParms.isPortal) {
@@ -510,6 +664,100 @@ void R_InfoStaticModels_f(void)
     g_bInfostaticmodels = qtrue;
 }
 
+/*
+==============
+R_StaticModelCullBench_f
+
+Added in OPM
+  Times the static model culling against the last rendered view,
+  once with the per-model path and once with the batched path.
+  This only runs the culling on the CPU, no surface is added
+==============
+*/
+void R_StaticModelCullBench_f(void)
+{
+    cStaticModelUnpacked_t *SM;
+    orientationr_t          savedOri;
+    vec3_t                  tiki_localorigin;
+    vec3_t                  tiki_worldorigin;
+    float                   tiki_scale;
+    int                     numIterations;
+    int                     numVisible;
+    int                     numCandidates;
+    int                     startTime;
+    int                     legacyTime, batchTime;
+    int                     i, n;
+
+    if (!tr.world || !tr.world->numStaticModels) {
+        ri.Printf(PRINT_ALL, "No static models loaded\n");
+        return;
+    }
+
+    numIterations = 100;
+    if (ri.Cmd_Argc() > 1) {
+        numIterations = Q_max(atoi(ri.Cmd_Argv(1)), 1);
+    }
+
+    savedOri = tr.ori;
+
+    numVisible = 0;
+    startTime  = ri.Milliseconds();
+    for (n = 0; n < numIterations; n++) {
+        numVisible = 0;
+        for (i = 0; i < tr.world->numStaticModels; i++) {
+            SM = &tr.world->staticModels[i];
+            if (!SM->tiki) {
+                continue;
+            }
+
+            R_RotateForStaticModel(SM, &tr.viewParms, &tr.ori);
+
+            tiki_scale = SM->tiki->load_scale * SM->scale;
+            VectorScale(SM->tiki->load_origin, tiki_scale, tiki_localorigin);
+            R_LocalPointToWorld(tiki_localorigin, tiki_worldorigin);
+
+            if (R_CullPointAndRadius(tiki_worldorigin, SM->cull_radius) != CULL_OUT) {
+                numVisible++;
+            }
+        }
+    }
+    legacyTime = ri.Milliseconds() - startTime;
+
+    tr.ori = savedOri;
+
+    ri.Printf(
+        PRINT_ALL,
+        "per-model: %d models, %d visible, %d ms for %d iterations\n",
+        tr.world->numStaticModels,
+        numVisible,
+        legacyTime,
+        numIterations
+    );
+
+    numVisible    = 0;
+    numCandidates = 0;
+    startTime     = ri.Milliseconds();
+    for (n = 0; n < numIterations; n++) {
+        numCandidates = R_GatherStaticModelCandidates();
+        R_CullStaticModelSpheres(numCandidates);
+
+        numVisible = 0;
+        for (i = 0; i < numCandidates; i++) {
+            numVisible += g_pStaticCullResults[i] != CULL_OUT;
+        }
+    }
+    batchTime = ri.Milliseconds() - startTime;
+
+    ri.Printf(
+        PRINT_ALL,
+        "batched: %d in visible leaves, %d visible, %d ms for %d iterations\n",
+        numCandidates,
+        numVisible,
+        batchTime,
+        numIterations
+    );
+}
+
 /*
 ==============
 R_PrintInfoStaticModels
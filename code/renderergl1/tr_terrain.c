@@ -109,6 +109,7 @@ static terraInt R_AllocateVert(cTerraPatchUnpacked_t *patch)
 
     patch->drawinfo.iVertHead = iVert;
     patch->drawinfo.nVerts++;
+    patch->uiMorphRecalc = 0;
 
     assert(g_vert.nFree > 0);
     g_vert.nFree--;
@@ -371,6 +372,7 @@ static void R_TerrainPatchesInit()
         patch->drawinfo.iVertHead    = 0;
         patch->drawinfo.nTris        = 0;
         patch->drawinfo.nVerts       = 0;
+        patch->uiMorphRecalc         = 0;
     }
 }
 
@@ -1041,17 +1043,30 @@ static void R_DoGeomorphs()
 
         if (patch->visCountDraw == g_terVisCount) {
             if (patch->byDirty) {
+                patch->uiMorphRecalc = -1;
                 while (g_vert.iCur) {
                     terrainVert_t *pVert = &g_pVert[g_vert.iCur];
                     R_CalcVertMorphHeight(pVert);
+                    if (patch->uiMorphRecalc > pVert->uiDistRecalc) {
+                        patch->uiMorphRecalc = pVert->uiDistRecalc;
+                    }
                     g_vert.iCur = pVert->iNext;
                 }
 
                 patch->byDirty = qfalse;
-            } else {
+            } else if (patch->uiMorphRecalc <= g_uiTerDist) {
+                //
+                // Added in OPM
+                //  Only walk the vertices when at least one of them
+                //  has crossed its recalc distance
+                //
+                patch->uiMorphRecalc = -1;
                 while (g_vert.iCur) {
                     terrainVert_t *pVert = &g_pVert[g_vert.iCur];
                     R_UpdateVertMorphHeight(pVert);
+                    if (patch->uiMorphRecalc > pVert->uiDistRecalc) {
+                        patch->uiMorphRecalc = pVert->uiDistRecalc;
+                    }
                     g_vert.iCur = pVert->iNext;
                 }
             }
@@ -1181,10 +1196,13 @@ void R_TessellateTerrain()
 
 /*
 ================
-R_TerrainPrepareFrame
+R_TerrainSetupView
+
+Updates the tessellation view state from the given view.
+This doesn't depend on the backend so it can be used without a frame being rendered
 ================
 */
-void R_TerrainPrepareFrame()
+static void R_TerrainSetupView(const vec3_t vieworg, const vec3_t forward, float fov_x, float farplane)
 {
     float distance;
     int   index;
@@ -1192,14 +1210,6 @@ void R_TerrainPrepareFrame()
     float fCheck;
     float fDistBound;
 
-    if (ter_lock->integer) {
-        return;
-    }
-
-    if (tr.viewParms.isPortalSky) {
-        return;
-    }
-
     g_terVisCount++;
     tr.world->activeTerraPatches = NULL;
 
@@ -1208,27 +1218,27 @@ void R_TerrainPrepareFrame()
     }
 
     distance = 1.0;
-    fFov     = tr.refdef.fov_x;
+    fFov     = fov_x;
     if (fFov < 1.0) {
         fFov = 1.0;
     }
 
     fCheck = 1.0 / (tan(fFov / 114.0) * ter_error->value / 320.0);
     if (g_terVisCount) {
-        float fFarPlane = tr.viewParms.farplane_distance;
+        float fFarPlane = farplane;
         if (fFarPlane == 0.0) {
             fFarPlane = 4096.0;
         }
 
-        fDistBound = fabs((fCheck - g_fCheck) * 510.0) + fabs((tr.refdef.vieworg[0] - g_vTerOrg[0]) * g_vTerFwd[0])
-                   + fabs((tr.refdef.vieworg[1] - g_vTerOrg[1]) * g_vTerFwd[1])
-                   + fabs((tr.refdef.viewaxis[0][0] - g_vTerFwd[0]) * fFarPlane)
-                   + fabs((tr.refdef.viewaxis[0][1] - g_vTerFwd[1]) * fFarPlane);
+        fDistBound = fabs((fCheck - g_fCheck) * 510.0) + fabs((vieworg[0] - g_vTerOrg[0]) * g_vTerFwd[0])
+                   + fabs((vieworg[1] - g_vTerOrg[1]) * g_vTerFwd[1]) + fabs((forward[0] - g_vTerFwd[0]) * fFarPlane)
+                   + fabs((forward[1] - g_vTerFwd[1]) * fFarPlane);
 
         g_uiTerDist = (ceil(fDistBound) + (float)g_uiTerDist);
         if (g_uiTerDist > 0xF0000000) {
             for (index = 0; index < tr.world->numTerraPatches; index++) {
-                tr.world->terraPatches[index].uiDistRecalc = 0;
+                tr.world->terraPatches[index].uiDistRecalc  = 0;
+                tr.world->terraPatches[index].uiMorphRecalc = 0;
             }
 
             for (index = 0; index < g_nTris; index++) {
@@ -1246,34 +1256,51 @@ void R_TerrainPrepareFrame()
         g_uiTerDist = 0;
     }
 
-    VectorCopy2D(tr.refdef.vieworg, g_vTerOrg);
-    VectorCopy(tr.refdef.viewaxis[0], g_vTerFwd);
+    VectorCopy2D(vieworg, g_vTerOrg);
+    VectorCopy(forward, g_vTerFwd);
     g_fCheck = fCheck;
 
     if (fDistBound != 0.0) {
-        index    = (int)tr.refdef.fov_x;
+        index    = (int)fov_x;
         distance = g_fDistanceTable[index];
 
         g_fClipDotSquared = g_fClipDotSquaredTable[index];
         g_fClipDotProduct = g_fClipDotProductTable[index];
-        VectorCopy(tr.refdef.viewaxis[0], g_vClipVector);
-        g_vClipOrigin[0] = tr.refdef.vieworg[0] - distance * tr.refdef.viewaxis[0][0] - 256.0;
-        g_vClipOrigin[1] = tr.refdef.vieworg[1] - distance * tr.refdef.viewaxis[0][1] - 256.0;
-        g_vClipOrigin[2] = tr.refdef.vieworg[2] - distance * tr.refdef.viewaxis[0][2] - 255.0;
-        g_vViewVector[0] = tr.refdef.viewaxis[0][0];
-        g_vViewVector[1] = tr.refdef.viewaxis[0][1];
-        g_vViewVector[2] =
-            -(tr.refdef.viewaxis[0][0] * tr.refdef.vieworg[0] + tr.refdef.viewaxis[0][1] * tr.refdef.vieworg[1]);
-        VectorCopy(tr.refdef.vieworg, g_vViewOrigin);
-
-        if (tr.viewParms.farplane_distance > 0) {
-            g_fFogDistance = distance + tr.viewParms.farplane_distance + 768.0;
+        VectorCopy(forward, g_vClipVector);
+        g_vClipOrigin[0] = vieworg[0] - distance * forward[0] - 256.0;
+        g_vClipOrigin[1] = vieworg[1] - distance * forward[1] - 256.0;
+        g_vClipOrigin[2] = vieworg[2] - distance * forward[2] - 255.0;
+        g_vViewVector[0] = forward[0];
+        g_vViewVector[1] = forward[1];
+        g_vViewVector[2] = -(forward[0] * vieworg[0] + forward[1] * vieworg[1]);
+        VectorCopy(vieworg, g_vViewOrigin);
+
+        if (farplane > 0) {
+            g_fFogDistance = distance + farplane + 768.0;
         } else {
             g_fFogDistance = 999999.0;
         }
     }
 }
 
+/*
+================
+R_TerrainPrepareFrame
+================
+*/
+void R_TerrainPrepareFrame()
+{
+    if (ter_lock->integer) {
+        return;
+    }
+
+    if (tr.viewParms.isPortalSky) {
+        return;
+    }
+
+    R_TerrainSetupView(tr.refdef.vieworg, tr.refdef.viewaxis[0], tr.refdef.fov_x, tr.viewParms.farplane_distance);
+}
+
 /*
 ================
 R_MarkTerrainPatch
@@ -1616,6 +1643,124 @@ void R_TerrainCrater_f(void)
     R_TerrainRestart_f();
 }
 
+/*
+================
+R_TerrainBenchmark_f
+
+Added in OPM
+  Replays a camera path over the loaded terrain and measures the tessellation time.
+  Only the CPU side (split, geomorph, merge) is measured, nothing is sent to the backend.
+  The orbit passes over the center of the terrain bounds at the given height above the highest patch
+================
+*/
+void R_TerrainBenchmark_f(void)
+{
+    int                    i, n;
+    int                    numFrames;
+    int                    startTime, totalTime;
+    int                    minTime, maxTime;
+    int                    totalSplit, totalMerge;
+    float                  fHeight;
+    float                  fRadius;
+    float                  fAngle;
+    vec3_t                 mins, maxs;
+    vec3_t                 center;
+    vec3_t                 vieworg;
+    vec3_t                 forward;
+    cTerraPatchUnpacked_t *patch;
+
+    if (!tr.world || tr.world->numTerraPatches <= 0 || !g_pTris) {
+        ri.Printf(PRINT_ALL, "No terrain loaded\n");
+        return;
+    }
+
+    numFrames = 1000;
+    if (ri.Cmd_Argc() > 1) {
+        numFrames = atoi(ri.Cmd_Argv(1));
+        if (numFrames < 1) {
+            numFrames = 1;
+        }
+    }
+
+    fHeight = 128;
+    if (ri.Cmd_Argc() > 2) {
+        fHeight = atof(ri.Cmd_Argv(2));
+    }
+
+    ClearBounds(mins, maxs);
+    for (i = 0; i < tr.world->numTerraPatches; i++) {
+        patch = &tr.world->terraPatches[i];
+
+        VectorSet(center, patch->x0, patch->y0, patch->z0);
+        AddPointToBounds(center, mins, maxs);
+        VectorSet(center, patch->x0 + 512, patch->y0 + 512, patch->zmax);
+        AddPointToBounds(center, mins, maxs);
+    }
+
+    VectorAdd(mins, maxs, center);
+    VectorScale(center, 0.5f, center);
+    fRadius = Q_max(maxs[0] - mins[0], maxs[1] - mins[1]) * 0.375f;
+
+    totalTime  = 0;
+    totalSplit = 0;
+    totalMerge = 0;
+    minTime    = 0x7FFFFFFF;
+    maxTime    = 0;
+    g_nSplit   = 0;
+    g_nMerge   = 0;
+
+    for (n = 0; n < numFrames; n++) {
+        int frameTime;
+
+        fAngle = (float)n / numFrames * M_PI * 2;
+
+        vieworg[0] = center[0] + cos(fAngle) * fRadius;
+        vieworg[1] = center[1] + sin(fAngle) * fRadius;
+        vieworg[2] = maxs[2] + fHeight;
+        // look along the tangent of the orbit
+        forward[0] = -sin(fAngle);
+        forward[1] = cos(fAngle);
+        forward[2] = 0;
+
+        startTime = ri.Milliseconds();
+
+        R_TerrainSetupView(vieworg, forward, 90, 0);
+        for (i = 0; i < tr.world->numTerraPatches; i++) {
+            R_MarkTerrainPatch(&tr.world->terraPatches[i]);
+        }
+        R_TessellateTerrain();
+
+        frameTime = ri.Milliseconds() - startTime;
+        totalTime += frameTime;
+        minTime = Q_min(minTime, frameTime);
+        maxTime = Q_max(maxTime, frameTime);
+
+        totalSplit += g_nSplit;
+        totalMerge += g_nMerge;
+        g_nSplit = 0;
+        g_nMerge = 0;
+    }
+
+    ri.Printf(
+        PRINT_ALL,
+        "%d frames over %d patches: %d ms total, %.3f ms avg, %d ms min, %d ms max\n",
+        numFrames,
+        tr.world->numTerraPatches,
+        totalTime,
+        (float)totalTime / numFrames,
+        minTime,
+        maxTime
+    );
+    ri.Printf(
+        PRINT_ALL,
+        "%d splits / %d merges, %zu tris / %zu verts in use\n",
+        totalSplit,
+        totalMerge,
+        g_nTris - g_tri.nFree,
+        g_nVerts - g_vert.nFree
+    );
+}
+
 /*
 ================
 R_InitTerrain
@@ -1642,6 +1787,7 @@ void R_InitTerrain()
     ter_count = ri.Cvar_Get("ter_count", "0", 0);
 
     ri.Cmd_AddCommand("ter_restart", R_TerrainRestart_f);
+    ri.Cmd_AddCommand("ter_bench", R_TerrainBenchmark_f);
     R_PreTessellateTerrain();
 
     for (i = 0; i < TERRAIN_TABLE_SIZE; i++) {
@@ -1660,6 +1806,7 @@ R_ShutdownTerrain
 void R_ShutdownTerrain()
 {
     ri.Cmd_RemoveCommand("ter_restart");
+    ri.Cmd_RemoveCommand("ter_bench");
 
     R_TerrainFree();
 }
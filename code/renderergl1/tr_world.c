@@ -48,9 +48,10 @@ R_CullGrid
 
 Returns true if the grid is completely culled away.
 Also sets the clipped hint bit in tess
+The world jobs pass their own counters
 =================
 */
-static qboolean	R_CullGrid( srfGridMesh_t *cv ) {
+static qboolean	R_CullGrid( srfGridMesh_t *cv, frontEndCounters_t *pc ) {
 	int 	boxCull;
 	int 	sphereCull;
 
@@ -72,33 +73,33 @@ static qboolean	R_CullGrid( srfGridMesh_t *cv ) {
 	// check for trivial reject
 	if ( sphereCull == CULL_OUT )
 	{
-		tr.pc.c_sphere_cull_patch_out++;
+		pc->c_sphere_cull_patch_out++;
 		return qtrue;
 	}
 	// check bounding box if necessary
 	else if ( sphereCull == CULL_CLIP )
 	{
-		tr.pc.c_sphere_cull_patch_clip++;
+		pc->c_sphere_cull_patch_clip++;
 
 		boxCull = R_CullLocalBox( cv->meshBounds );
 
 		if ( boxCull == CULL_OUT ) 
 		{
-			tr.pc.c_box_cull_patch_out++;
+			pc->c_box_cull_patch_out++;
 			return qtrue;
 		}
 		else if ( boxCull == CULL_IN )
 		{
-			tr.pc.c_box_cull_patch_in++;
+			pc->c_box_cull_patch_in++;
 		}
 		else
 		{
-			tr.pc.c_box_cull_patch_clip++;
+			pc->c_box_cull_patch_clip++;
 		}
 	}
 	else
 	{
-		tr.pc.c_sphere_cull_patch_in++;
+		pc->c_sphere_cull_patch_in++;
 	}
 
 	return qfalse;
@@ -115,7 +116,7 @@ added to the sorting list.
 This will also allow mirrors on both sides of a model without recursion.
 ================
 */
-static qboolean	R_CullSurface( surfaceType_t *surface, shader_t *shader ) {
+static qboolean	R_CullSurface( surfaceType_t *surface, shader_t *shader, frontEndCounters_t *pc ) {
 	srfSurfaceFace_t *sface;
 	float			d;
 
@@ -124,7 +125,7 @@ static qboolean	R_CullSurface( surfaceType_t *surface, shader_t *shader ) {
 	}
 
 	if ( *surface == SF_GRID ) {
-		return R_CullGrid( (srfGridMesh_t *)surface );
+		return R_CullGrid( (srfGridMesh_t *)surface, pc );
 	}
 
 	if ( *surface == SF_TRIANGLES ) {
@@ -439,6 +440,25 @@ int R_CheckDlightTerrain(cTerraPatchUnpacked_t* surf, int dlightBits)
 	return 0;
 }
 
+/*
+======================
+R_AddVisibleWorldSurface
+
+Adds a surface that passed culling
+======================
+*/
+static void R_AddVisibleWorldSurface( msurface_t *surf, int dlightBits ) {
+	// check for dlighting
+	dlightBits = R_CheckDlightSurface(surf, dlightBits);
+	if (surf->shader && surf->shader->isPortalSky) {
+		// Sky portal
+		R_Sky_AddSurf(surf);
+		return;
+	}
+
+	R_AddDrawSurf( surf->data, surf->shader, dlightBits );
+}
+
 /*
 ======================
 R_AddWorldSurface
@@ -453,19 +473,11 @@ static void R_AddWorldSurface( msurface_t *surf, int dlightBits ) {
 	// FIXME: bmodel fog?
 
 	// try to cull before dlighting or adding
-	if ( R_CullSurface( surf->data, surf->shader ) ) {
-		return;
-	}
-
-	// check for dlighting
-	dlightBits = R_CheckDlightSurface(surf, dlightBits);
-	if (surf->shader && surf->shader->isPortalSky) {
-		// Sky portal
-		R_Sky_AddSurf(surf);
+	if ( R_CullSurface( surf->data, surf->shader, &tr.pc ) ) {
 		return;
 	}
 
-	R_AddDrawSurf( surf->data, surf->shader, dlightBits );
+	R_AddVisibleWorldSurface( surf, dlightBits );
 }
 
 /*
@@ -522,6 +534,97 @@ void R_GetInlineModelBounds(int iIndex, vec3_t vMins, vec3_t vMaxs)
 }
 
 
+/*
+================
+R_CullWorldNode
+
+Returns qtrue if the node is outside the frustum,
+clears the planes the node is in front of from planeBits
+================
+*/
+static qboolean R_CullWorldNode( const mnode_t *node, int *planeBits ) {
+	int		i;
+	int		r;
+
+	for ( i = 0; i < 5; i++ ) {
+		if ( !( *planeBits & ( 1 << i ) ) ) {
+			continue;
+		}
+
+		r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[i]);
+		if (r == 2) {
+			return qtrue;					// culled
+		}
+		if (r == 1) {
+			*planeBits &= ~( 1 << i );		// all descendants will also be in front
+		}
+	}
+
+	return qfalse;
+}
+
+/*
+================
+R_AddWorldLeafBounds
+================
+*/
+static void R_AddWorldLeafBounds( mnode_t *node ) {
+	tr.pc.c_leafs++;
+
+	// add to z buffer bounds
+	if ( node->mins[0] < tr.viewParms.visBounds[0][0] ) {
+		tr.viewParms.visBounds[0][0] = node->mins[0];
+	}
+	if ( node->mins[1] < tr.viewParms.visBounds[0][1] ) {
+		tr.viewParms.visBounds[0][1] = node->mins[1];
+	}
+	if ( node->mins[2] < tr.viewParms.visBounds[0][2] ) {
+		tr.viewParms.visBounds[0][2] = node->mins[2];
+	}
+
+	if ( node->maxs[0] > tr.viewParms.visBounds[1][0] ) {
+		tr.viewParms.visBounds[1][0] = node->maxs[0];
+	}
+	if ( node->maxs[1] > tr.viewParms.visBounds[1][1] ) {
+		tr.viewParms.visBounds[1][1] = node->maxs[1];
+	}
+	if ( node->maxs[2] > tr.viewParms.visBounds[1][2] ) {
+		tr.viewParms.visBounds[1][2] = node->maxs[2];
+	}
+
+	tr.portalsky.cntNode = node;
+}
+
+/*
+================
+R_MarkWorldLeaf
+
+Terrain patches, static decals and static models of a visible leaf
+================
+*/
+static void R_MarkWorldLeaf( mnode_t *node ) {
+	int		i;
+
+	if (r_drawterrain->integer && tr.refdef.render_terrain && !tr.viewParms.isPortalSky)
+	{
+		for (i = 0; i < node->numTerraPatches; i++) {
+			R_MarkTerrainPatch(tr.world->visTerraPatches[node->firstTerraPatch + i]);
+		}
+	}
+
+	if (r_drawstaticdecals->integer) {
+		if (node->pFirstMarkFragment) {
+			R_AddPermanentMarkFragmentSurfaces(node->pFirstMarkFragment, node->iNumMarkFragment);
+		}
+	}
+
+	if (r_drawstaticmodels->integer) {
+		for (i = 0; i < node->numStaticModels; i++) {
+			tr.world->visStaticModels[node->firstStaticModel + i]->visCount = tr.visCount;
+		}
+	}
+}
+
 /*
 ================
 R_RecursiveWorldNode
@@ -538,59 +641,8 @@ static void R_RecursiveWorldNode( mnode_t *node, int planeBits, int dlightBits )
 		// if the bounding volume is outside the frustum, nothing
 		// inside can be visible OPTIMIZE: don't do this all the way to leafs?
 
-		if ( !r_nocull->integer ) {
-			int		r;
-
-			if (planeBits & 1) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[0]);
-				if (r == 2) {
-					return;						// culled
-				}
-				if (r == 1) {
-					planeBits &= ~1;			// all descendants will also be in front
-				}
-			}
-
-			if (planeBits & 2) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[1]);
-				if (r == 2) {
-					return;						// culled
-				}
-				if (r == 1) {
-					planeBits &= ~2;			// all descendants will also be in front
-				}
-			}
-
-			if (planeBits & 4) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[2]);
-				if (r == 2) {
-					return;						// culled
-				}
-				if (r == 1) {
-					planeBits &= ~4;			// all descendants will also be in front
-				}
-			}
-
-			if (planeBits & 8) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[3]);
-				if (r == 2) {
-					return;						// culled
-				}
-				if (r == 1) {
-					planeBits &= ~8;			// all descendants will also be in front
-				}
-			}
-
-			if (planeBits & 16) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[4]);
-				if (r == 2) {
-					return;						// culled
-				}
-				if (r == 1) {
-					planeBits &= ~16;			// all descendants will also be in front
-				}
-			}
-
+		if ( !r_nocull->integer && R_CullWorldNode( node, &planeBits ) ) {
+			return;
 		}
 
 		if ( node->contents != -1 ) {
@@ -609,30 +661,7 @@ static void R_RecursiveWorldNode( mnode_t *node, int planeBits, int dlightBits )
 		int			c;
 		msurface_t	*surf, **mark;
 
-		tr.pc.c_leafs++;
-
-		// add to z buffer bounds
-		if ( node->mins[0] < tr.viewParms.visBounds[0][0] ) {
-			tr.viewParms.visBounds[0][0] = node->mins[0];
-		}
-		if ( node->mins[1] < tr.viewParms.visBounds[0][1] ) {
-			tr.viewParms.visBounds[0][1] = node->mins[1];
-		}
-		if ( node->mins[2] < tr.viewParms.visBounds[0][2] ) {
-			tr.viewParms.visBounds[0][2] = node->mins[2];
-		}
-
-		if ( node->maxs[0] > tr.viewParms.visBounds[1][0] ) {
-			tr.viewParms.visBounds[1][0] = node->maxs[0];
-		}
-		if ( node->maxs[1] > tr.viewParms.visBounds[1][1] ) {
-			tr.viewParms.visBounds[1][1] = node->maxs[1];
-		}
-		if ( node->maxs[2] > tr.viewParms.visBounds[1][2] ) {
-			tr.viewParms.visBounds[1][2] = node->maxs[2];
-		}
-
-		tr.portalsky.cntNode = node;
+		R_AddWorldLeafBounds(node);
 
 		if (r_drawbrushes->integer) {
 			// add the individual surfaces
@@ -649,30 +678,291 @@ static void R_RecursiveWorldNode( mnode_t *node, int planeBits, int dlightBits )
 			}
 		}
 
-		if (r_drawterrain->integer && tr.refdef.render_terrain && !tr.viewParms.isPortalSky)
-		{
-			int i;
+		R_MarkWorldLeaf(node);
+	}
 
-			for (i = 0; i < node->numTerraPatches; i++) {
-				R_MarkTerrainPatch(tr.world->visTerraPatches[node->firstTerraPatch + i]);
-			}
+}
+
+/*
+=============================================================
+
+	WORLD JOBS
+
+Added in OPM
+  The visible part of the BSP is split into subtrees that are walked by
+  the front-end threads. A job only reads the view and the world, it culls
+  the nodes and the surfaces of its subtree and appends the visible leafs
+  and surfaces to the buffer of its thread. The buffers are then merged
+  in traversal order on the main thread, which adds the draw surfaces
+  (so they are sorted with the others) and does everything that writes
+  shared state: surface marks, dlights, sky portal, terrain and decals.
+
+=============================================================
+*/
+
+// depth of the top nodes walked on the main thread, up to 2^depth subtrees
+#define WORLD_SUBTREE_DEPTH	6
+#define MAX_WORLD_SUBTREES	(1 << WORLD_SUBTREE_DEPTH)
+
+typedef struct {
+	mnode_t		*node;
+	int			planeBits;
+
+	// filled by the job
+	int			thread;
+	int			firstLeaf;
+	int			numLeafs;
+} worldSubtree_t;
+
+typedef struct {
+	mnode_t		*node;
+	int			firstSurf;
+	int			numSurfs;
+} worldJobLeaf_t;
+
+typedef struct {
+	worldJobLeaf_t		*leafs;
+	int					numLeafs;
+	msurface_t			**surfs;		// surfaces that passed culling, a surface may be in several leafs
+	int					numSurfs;
+	frontEndCounters_t	pc;
+} worldJobBuffer_t;
+
+static worldSubtree_t	r_worldSubtrees[MAX_WORLD_SUBTREES];
+static int				r_numWorldSubtrees;
+
+static worldJobBuffer_t	r_worldJobBuffers[MAX_FRONTEND_THREADS];
+static int				r_numWorldJobBuffers;
+static int				r_worldJobMaxLeafs;
+static int				r_worldJobMaxSurfs;
+
+/*
+================
+R_ShutdownWorldJobs
+================
+*/
+void R_ShutdownWorldJobs( void ) {
+	int		i;
+
+	for (i = 0; i < r_numWorldJobBuffers; i++) {
+		ri.Free(r_worldJobBuffers[i].leafs);
+		ri.Free(r_worldJobBuffers[i].surfs);
+	}
+
+	Com_Memset(r_worldJobBuffers, 0, sizeof(r_worldJobBuffers));
+	r_numWorldJobBuffers = 0;
+	r_worldJobMaxLeafs = 0;
+	r_worldJobMaxSurfs = 0;
+}
+
+/*
+================
+R_AllocWorldJobBuffers
+
+Each thread may walk the whole world, so a buffer
+holds all the leafs and all the leaf surfaces
+================
+*/
+static void R_AllocWorldJobBuffers( int numThreads ) {
+	int		maxLeafs;
+	int		maxSurfs;
+	int		i;
+
+	maxLeafs = tr.world->numnodes - tr.world->numDecisionNodes;
+	maxSurfs = tr.world->nummarksurfaces;
+
+	if (numThreads <= r_numWorldJobBuffers && maxLeafs <= r_worldJobMaxLeafs && maxSurfs <= r_worldJobMaxSurfs) {
+		return;
+	}
+
+	R_ShutdownWorldJobs();
+
+	for (i = 0; i < numThreads; i++) {
+		r_worldJobBuffers[i].leafs = ri.Malloc(sizeof(worldJobLeaf_t) * maxLeafs);
+		r_worldJobBuffers[i].surfs = ri.Malloc(sizeof(msurface_t *) * maxSurfs);
+	}
+
+	r_numWorldJobBuffers = numThreads;
+	r_worldJobMaxLeafs = maxLeafs;
+	r_worldJobMaxSurfs = maxSurfs;
+}
+
+/*
+================
+R_GatherWorldSubtrees
+================
+*/
+static void R_GatherWorldSubtrees( mnode_t *node, int planeBits, int depth ) {
+	worldSubtree_t	*subtree;
+
+	if (node->visframe != tr.visCount) {
+		return;
+	}
+
+	if ( !r_nocull->integer && R_CullWorldNode( node, &planeBits ) ) {
+		return;
+	}
+
+	if ( node->contents != -1 || !depth ) {
+		subtree = &r_worldSubtrees[r_numWorldSubtrees++];
+		subtree->node = node;
+		subtree->planeBits = planeBits;
+		return;
+	}
+
+	// front side first, like R_RecursiveWorldNode
+	R_GatherWorldSubtrees(node->children[0], planeBits, depth - 1);
+	R_GatherWorldSubtrees(node->children[1], planeBits, depth - 1);
+}
+
+/*
+================
+R_RecursiveWorldNodeJob
+
+Same walk as R_RecursiveWorldNode, into the buffer of the job
+================
+*/
+static void R_RecursiveWorldNodeJob( mnode_t *node, int planeBits, worldJobBuffer_t *buffer ) {
+	worldJobLeaf_t	*leaf;
+	msurface_t		*surf, **mark;
+	int				c;
+
+	do {
+		if (node->visframe != tr.visCount) {
+			return;
+		}
+
+		if ( !r_nocull->integer && R_CullWorldNode( node, &planeBits ) ) {
+			return;
 		}
 
-		if (r_drawstaticdecals->integer) {
-			if (node->pFirstMarkFragment) {
-				R_AddPermanentMarkFragmentSurfaces(node->pFirstMarkFragment, node->iNumMarkFragment);
+		if ( node->contents != -1 ) {
+			break;
+		}
+
+		R_RecursiveWorldNodeJob(node->children[0], planeBits, buffer);
+
+		node = node->children[1];
+	} while ( 1 );
+
+	leaf = &buffer->leafs[buffer->numLeafs++];
+	leaf->node = node;
+	leaf->firstSurf = buffer->numSurfs;
+
+	if (r_drawbrushes->integer) {
+		mark = node->firstmarksurface;
+		c = node->nummarksurfaces;
+		while (c--) {
+			surf = *mark;
+			if ( !R_CullSurface( surf->data, surf->shader, &buffer->pc ) ) {
+				buffer->surfs[buffer->numSurfs++] = surf;
 			}
+			mark++;
 		}
+	}
+
+	leaf->numSurfs = buffer->numSurfs - leaf->firstSurf;
+}
+
+/*
+================
+R_WorldSubtreeJob
+================
+*/
+static void R_WorldSubtreeJob( int task, int thread, void *data ) {
+	worldSubtree_t		*subtree;
+	worldJobBuffer_t	*buffer;
+
+	subtree = &r_worldSubtrees[task];
+	buffer = &r_worldJobBuffers[thread];
+
+	subtree->thread = thread;
+	subtree->firstLeaf = buffer->numLeafs;
+	R_RecursiveWorldNodeJob(subtree->node, subtree->planeBits, buffer);
+	subtree->numLeafs = buffer->numLeafs - subtree->firstLeaf;
+}
+
+/*
+================
+R_MergeWorldJobs
+
+Adds the leafs and surfaces of the jobs in the order R_RecursiveWorldNode would have
+================
+*/
+static void R_MergeWorldJobs( int numThreads, int dlightBits ) {
+	const worldSubtree_t	*subtree;
+	const worldJobBuffer_t	*buffer;
+	const worldJobLeaf_t	*leaf;
+	msurface_t				*surf;
+	int						i, j, k;
+
+	for (i = 0; i < r_numWorldSubtrees; i++) {
+		subtree = &r_worldSubtrees[i];
+		buffer = &r_worldJobBuffers[subtree->thread];
+
+		for (j = 0; j < subtree->numLeafs; j++) {
+			leaf = &buffer->leafs[subtree->firstLeaf + j];
 
-		if (r_drawstaticmodels->integer) {
-			int i;
+			R_AddWorldLeafBounds(leaf->node);
 
-			for (i = 0; i < node->numStaticModels; i++) {
-				tr.world->visStaticModels[node->firstStaticModel + i]->visCount = tr.visCount;
+			for (k = 0; k < leaf->numSurfs; k++) {
+				surf = buffer->surfs[leaf->firstSurf + k];
+
+				// the surface may have already been added if it
+				// spans multiple leafs
+				if (surf->viewCount != tr.viewCount) {
+					surf->viewCount = tr.viewCount;
+					R_AddVisibleWorldSurface(surf, dlightBits);
+				}
 			}
+
+			R_MarkWorldLeaf(leaf->node);
 		}
 	}
 
+	for (i = 0; i < numThreads; i++) {
+		buffer = &r_worldJobBuffers[i];
+
+		tr.pc.c_sphere_cull_patch_in += buffer->pc.c_sphere_cull_patch_in;
+		tr.pc.c_sphere_cull_patch_clip += buffer->pc.c_sphere_cull_patch_clip;
+		tr.pc.c_sphere_cull_patch_out += buffer->pc.c_sphere_cull_patch_out;
+		tr.pc.c_box_cull_patch_in += buffer->pc.c_box_cull_patch_in;
+		tr.pc.c_box_cull_patch_clip += buffer->pc.c_box_cull_patch_clip;
+		tr.pc.c_box_cull_patch_out += buffer->pc.c_box_cull_patch_out;
+	}
+}
+
+/*
+================
+R_AddWorldNodes
+
+Walks the world on the front-end threads, or on the main thread if there is only one
+================
+*/
+static void R_AddWorldNodes( int planeBits, int dlightBits ) {
+	int		numThreads;
+	int		i;
+
+	numThreads = R_FrontEndJobThreads();
+	if (numThreads < 2) {
+		R_RecursiveWorldNode(tr.world->nodes, planeBits, dlightBits);
+		return;
+	}
+
+	R_AllocWorldJobBuffers(numThreads);
+
+	r_numWorldSubtrees = 0;
+	R_GatherWorldSubtrees(tr.world->nodes, planeBits, WORLD_SUBTREE_DEPTH);
+
+	for (i = 0; i < numThreads; i++) {
+		r_worldJobBuffers[i].numLeafs = 0;
+		r_worldJobBuffers[i].numSurfs = 0;
+		Com_Memset(&r_worldJobBuffers[i].pc, 0, sizeof(r_worldJobBuffers[i].pc));
+	}
+
+	R_RunFrontEndJobs(R_WorldSubtreeJob, NULL, r_numWorldSubtrees);
+
+	R_MergeWorldJobs(numThreads, dlightBits);
 }
 
 int R_SphereInLeafs(const vec3_t p, float r, mnode_t** nodes, int nMaxNodes) {
@@ -896,7 +1186,7 @@ void R_AddWorldSurfaces (void) {
 		tr.refdef.num_dlights = 32;
 	}
 	R_TransformDlights(tr.refdef.num_dlights, tr.refdef.dlights, &tr.viewParms.world);
-	R_RecursiveWorldNode(tr.world->nodes, tr.viewParms.fog.extrafrustums ? 31 : 15, (1 << tr.refdef.num_dlights) - 1);
+	R_AddWorldNodes(tr.viewParms.fog.extrafrustums ? 31 : 15, (1 << tr.refdef.num_dlights) - 1);
 
 	if (r_drawterrain->integer && tr.refdef.render_terrain && !tr.viewParms.isPortalSky) {
 		R_AddTerrainSurfaces();
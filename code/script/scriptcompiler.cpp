@@ -70,6 +70,8 @@ void ScriptCompiler::Reset()
     bCanContinue = false;
 
     prev_opcode_pos = 0;
+
+    m_iNumVarCaches = 0;
 }
 
 unsigned char ScriptCompiler::PrevOpcode()
@@ -281,13 +283,24 @@ void ScriptCompiler::EmitAssignmentStatement(sval_t lhs, unsigned int sourcePos)
     }
 
     EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
+    EmitVarCacheSlot();
 }
 
 void ScriptCompiler::EmitBoolJumpFalse(unsigned int sourcePos)
 {
     if (PrevOpcode() == OP_UN_CAST_BOOLEAN) {
         AbsorbPrevOpcode();
-        EmitOpcode(OP_VAR_JUMP_FALSE4, sourcePos);
+
+        if (PrevOpcode() >= OP_BIN_EQUALITY && PrevOpcode() <= OP_BIN_GREATER_THAN_OR_EQUAL) {
+            // Added in OPM
+            //  fuse the comparison and the jump
+            int opcode = OP_BIN_EQUALITY_JUMP_FALSE4 + (PrevOpcode() - OP_BIN_EQUALITY);
+
+            AbsorbPrevOpcode();
+            EmitOpcode(opcode, sourcePos);
+        } else {
+            EmitOpcode(OP_VAR_JUMP_FALSE4, sourcePos);
+        }
     } else {
         EmitOpcode(OP_BOOL_JUMP_FALSE4, sourcePos);
     }
@@ -501,20 +514,23 @@ void ScriptCompiler::EmitField(sval_t listener_val, sval_t field_val, unsigned i
     index    = Director.AddString(name);
     eventnum = Event::FindGetterEventNum(name);
 
-    prev_index = GetOpcodeValue<unsigned int>(sizeof(unsigned int), sizeof(unsigned int));
+    prev_index = GetOpcodeValue<unsigned int>(sizeof(unsigned int) + sizeof(op_cacheSlot_t), sizeof(unsigned int));
 
     if (listener_val.node[0].type != ENUM_listener
         || (eventnum && BuiltinReadVariable(sourcePos, listener_val.node[1].intValue, eventnum))) {
         EmitValue(listener_val);
         EmitOpcode(OP_STORE_FIELD, sourcePos);
         EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
+        EmitVarCacheSlot();
     } else if (PrevOpcode() != (OP_LOAD_GAME_VAR + listener_val.node[1].intValue) || prev_index != index) {
         EmitOpcode(OP_STORE_GAME_VAR + listener_val.node[1].intValue, sourcePos);
         EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
+        EmitVarCacheSlot();
     } else {
         AbsorbPrevOpcode();
         EmitOpcode(OP_LOAD_STORE_GAME_VAR + listener_val.node[1].intValue, sourcePos);
-        code_pos += sizeof(unsigned int);
+        // keep the name and the cache slot of the absorbed opcode
+        code_pos += sizeof(unsigned int) + sizeof(op_cacheSlot_t);
     }
 }
 
@@ -934,6 +950,7 @@ void ScriptCompiler::EmitParameter(sval_t lhs, unsigned int sourcePos)
 
         unsigned int index = Director.AddString(name);
         EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
+        EmitVarCacheSlot();
     }
 }
 
@@ -980,6 +997,7 @@ void ScriptCompiler::EmitRef(sval_t val, unsigned int sourcePos)
     EmitValue(val.node[1]);
     EmitOpcode(OP_STORE_FIELD_REF, sourcePos);
     EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
+    EmitVarCacheSlot();
 }
 
 void ScriptCompiler::EmitStatementList(sval_t val)
@@ -1300,6 +1318,14 @@ __emit:
     }
 }
 
+// Added in OPM
+//  reserves the inline cache of the variable opcode that was just emitted,
+//  see ScriptVM::executeGetter
+void ScriptCompiler::EmitVarCacheSlot()
+{
+    EmitOpcodeValue((op_cacheSlot_t)m_iNumVarCaches++, sizeof(op_cacheSlot_t));
+}
+
 void ScriptCompiler::EmitVarToBool(unsigned int sourcePos)
 {
     int prev = PrevOpcode();
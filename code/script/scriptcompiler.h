@@ -70,6 +70,10 @@ public:
 
     bool compileSuccess;
 
+    // Added in OPM
+    //  number of inline caches used by the variable opcodes
+    unsigned int m_iNumVarCaches;
+
     static int current_label;
 
 public:
@@ -134,6 +138,7 @@ public:
     void EmitSwitch(sval_t val, unsigned int sourcePos);
     void EmitValue(sval_t val);
     void EmitValue(ScriptVariable& var, unsigned int sourcePos);
+    void EmitVarCacheSlot();
     void EmitVarToBool(unsigned int sourcePos);
     void EmitWhileJump(sval_t while_expr, sval_t while_stmt, sval_t inc_stmt, unsigned int sourcePos);
 
@@ -83,18 +83,18 @@ static opcode_t OpcodeInfo[] = {
     {"OPCODE_EXEC_METHOD5",              5,                        -5,   1},
     {"OPCODE_EXEC_METHOD_COUNT1",        6,                        -128, 1},
 
-    {"OPCODE_LOAD_GAME_VAR",             5,                        -1,   0},
-    {"OPCODE_LOAD_LEVEL_VAR",            5,                        -1,   0},
-    {"OPCODE_LOAD_LOCAL_VAR",            5,                        -1,   0},
-    {"OPCODE_LOAD_PARM_VAR",             5,                        -1,   0},
-    {"OPCODE_LOAD_SELF_VAR",             5,                        -1,   0},
-    {"OPCODE_LOAD_GROUP_VAR",            5,                        -1,   0},
-    {"OPCODE_LOAD_OWNER_VAR",            5,                        -1,   0},
-    {"OPCODE_LOAD_FIELD_VAR",            5,                        -2,   0},
+    {"OPCODE_LOAD_GAME_VAR",             9,                        -1,   0},
+    {"OPCODE_LOAD_LEVEL_VAR",            9,                        -1,   0},
+    {"OPCODE_LOAD_LOCAL_VAR",            9,                        -1,   0},
+    {"OPCODE_LOAD_PARM_VAR",             9,                        -1,   0},
+    {"OPCODE_LOAD_SELF_VAR",             9,                        -1,   0},
+    {"OPCODE_LOAD_GROUP_VAR",            9,                        -1,   0},
+    {"OPCODE_LOAD_OWNER_VAR",            9,                        -1,   0},
+    {"OPCODE_LOAD_FIELD_VAR",            9,                        -2,   0},
     {"OPCODE_LOAD_ARRAY_VAR",            1,                        -3,   0},
     {"OPCODE_LOAD_CONST_ARRAY1",         2,                        -128, 0},
 
-    {"OPCODE_STORE_FIELD_REF",           5,                        0,    0},
+    {"OPCODE_STORE_FIELD_REF",           9,                        0,    0},
     {"OPCODE_STORE_ARRAY_REF",           1,                        -1,   0},
 
     {"OPCODE_MARK_STACK_POS",            1,                        0,    0},
@@ -103,22 +103,22 @@ static opcode_t OpcodeInfo[] = {
 
     {"OPCODE_RESTORE_STACK_POS",         1,                        0,    0},
 
-    {"OPCODE_LOAD_STORE_GAME_VAR",       5,                        0,    0},
-    {"OPCODE_LOAD_STORE_LEVEL_VAR",      5,                        0,    0},
-    {"OPCODE_LOAD_STORE_LOCAL_VAR",      5,                        0,    0},
-    {"OPCODE_LOAD_STORE_PARM_VAR",       5,                        0,    0},
-    {"OPCODE_LOAD_STORE_SELF_VAR",       5,                        0,    0},
-    {"OPCODE_LOAD_STORE_GROUP_VAR",      5,                        0,    0},
-    {"OPCODE_LOAD_STORE_OWNER_VAR",      5,                        0,    0},
-
-    {"OPCODE_STORE_GAME_VAR",            5,                        1,    0},
-    {"OPCODE_STORE_LEVEL_VAR",           5,                        1,    0},
-    {"OPCODE_STORE_LOCAL_VAR",           5,                        1,    0},
-    {"OPCODE_STORE_PARM_VAR",            5,                        1,    0},
-    {"OPCODE_STORE_SELF_VAR",            5,                        1,    0},
-    {"OPCODE_STORE_GROUP_VAR",           5,                        1,    0},
-    {"OPCODE_STORE_OWNER_VAR",           5,                        1,    0},
-    {"OPCODE_STORE_FIELD",               5,                        0,    1},
+    {"OPCODE_LOAD_STORE_GAME_VAR",       9,                        0,    0},
+    {"OPCODE_LOAD_STORE_LEVEL_VAR",      9,                        0,    0},
+    {"OPCODE_LOAD_STORE_LOCAL_VAR",      9,                        0,    0},
+    {"OPCODE_LOAD_STORE_PARM_VAR",       9,                        0,    0},
+    {"OPCODE_LOAD_STORE_SELF_VAR",       9,                        0,    0},
+    {"OPCODE_LOAD_STORE_GROUP_VAR",      9,                        0,    0},
+    {"OPCODE_LOAD_STORE_OWNER_VAR",      9,                        0,    0},
+
+    {"OPCODE_STORE_GAME_VAR",            9,                        1,    0},
+    {"OPCODE_STORE_LEVEL_VAR",           9,                        1,    0},
+    {"OPCODE_STORE_LOCAL_VAR",           9,                        1,    0},
+    {"OPCODE_STORE_PARM_VAR",            9,                        1,    0},
+    {"OPCODE_STORE_SELF_VAR",            9,                        1,    0},
+    {"OPCODE_STORE_GROUP_VAR",           9,                        1,    0},
+    {"OPCODE_STORE_OWNER_VAR",           9,                        1,    0},
+    {"OPCODE_STORE_FIELD",               9,                        0,    1},
     {"OPCODE_STORE_ARRAY",               1,                        -1,   0},
     {"OPCODE_STORE_GAME",                1,                        1,    0},
     {"OPCODE_STORE_LEVEL",               1,                        1,    0},
@@ -164,6 +164,14 @@ static opcode_t OpcodeInfo[] = {
 
     {"OPCODE_END",                       1,                        -1,   0},
     {"OPCODE_RETURN",                    1,                        -1,   0},
+
+    // Added in OPM
+    {"OPCODE_BIN_EQUALITY_JUMP_FALSE4",              5, -2, 0},
+    {"OPCODE_BIN_INEQUALITY_JUMP_FALSE4",            5, -2, 0},
+    {"OPCODE_BIN_LESS_THAN_JUMP_FALSE4",             5, -2, 0},
+    {"OPCODE_BIN_GREATER_THAN_JUMP_FALSE4",          5, -2, 0},
+    {"OPCODE_BIN_LESS_THAN_OR_EQUAL_JUMP_FALSE4",    5, -2, 0},
+    {"OPCODE_BIN_GREATER_THAN_OR_EQUAL_JUMP_FALSE4", 5, -2, 0},
 };
 
 static const char *aszVarGroupNames[] = {"game", "level", "local", "parm", "self"};
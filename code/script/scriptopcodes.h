@@ -40,6 +40,8 @@ using op_offset_t = uint32_t;
 using op_parmNum_t = uint8_t;
 /** Parameter count of const array. */
 using op_arrayParmNum_t = uint16_t;
+/** Index of the inline cache of a variable access, see ScriptVarCache. */
+using op_cacheSlot_t = uint32_t;
 
 typedef struct {
     const char *opcodename;
@@ -192,6 +194,15 @@ typedef enum {
     OP_END,
     OP_RETURN,
 
+    // Added in OPM
+    //  superinstructions: a comparison followed by OP_VAR_JUMP_FALSE4
+    OP_BIN_EQUALITY_JUMP_FALSE4,
+    OP_BIN_INEQUALITY_JUMP_FALSE4,
+    OP_BIN_LESS_THAN_JUMP_FALSE4,
+    OP_BIN_GREATER_THAN_JUMP_FALSE4,
+    OP_BIN_LESS_THAN_OR_EQUAL_JUMP_FALSE4,
+    OP_BIN_GREATER_THAN_OR_EQUAL_JUMP_FALSE4,
+
     OP_PREVIOUS,
     OP_MAX = OP_PREVIOUS
 } opcode_e;
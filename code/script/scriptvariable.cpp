@@ -920,7 +920,7 @@ Entity *ScriptVariable::entityValue(void)
 
     switch (type) {
     case VARIABLE_CONSTSTRING:
-        ent = static_cast<Entity *>(world->GetScriptTarget(Director.GetString(m_data.intValue)));
+        ent = static_cast<Entity *>(world->GetScriptTarget((const_str)m_data.intValue));
         break;
     case VARIABLE_STRING:
         ent = static_cast<Entity *>(world->GetScriptTarget(stringValue()));
@@ -1034,8 +1034,8 @@ void ScriptVariable::evalArrayAt(ScriptVariable& var)
 
 float ScriptVariable::floatValue(void) const
 {
-    const char *string;
-    float       val;
+    str   string;
+    float val;
 
     switch (type) {
     case VARIABLE_FLOAT:
@@ -1086,7 +1086,7 @@ Listener *ScriptVariable::listenerValue(void) const
     switch (type) {
 #ifdef WITH_SCRIPT_ENGINE
     case VARIABLE_CONSTSTRING:
-        return world->GetScriptTarget(Director.GetString(m_data.intValue));
+        return world->GetScriptTarget((const_str)m_data.intValue);
 
     case VARIABLE_STRING:
         return world->GetScriptTarget(stringValue());
@@ -1194,8 +1194,8 @@ str ScriptVariable::stringValue() const
 
 Vector ScriptVariable::vectorValue(void) const
 {
-    const char *string;
-    float       x = 0.f, y = 0.f, z = 0.f;
+    str   string;
+    float x = 0.f, y = 0.f, z = 0.f;
 
     switch (type) {
     case VARIABLE_VECTOR:
@@ -1205,20 +1205,20 @@ Vector ScriptVariable::vectorValue(void) const
     case VARIABLE_STRING:
         string = stringValue();
 
-        if (strcmp(string, "") == 0) {
+        if (strcmp(string.c_str(), "") == 0) {
             throw ScriptException("cannot cast empty string to vector");
         }
 
-        if (*string == '(') {
-            if (sscanf(string, "(%f %f %f)", &x, &y, &z) != 3) {
-                if (sscanf(string, "(%f, %f, %f)", &x, &y, &z) != 3) {
-                    throw ScriptException("Couldn't convert string to vector - malformed string '%s'", string);
+        if (string[0] == '(') {
+            if (sscanf(string.c_str(), "(%f %f %f)", &x, &y, &z) != 3) {
+                if (sscanf(string.c_str(), "(%f, %f, %f)", &x, &y, &z) != 3) {
+                    throw ScriptException("Couldn't convert string to vector - malformed string '%s'", string.c_str());
                 }
             }
         } else {
-            if (sscanf(string, "%f %f %f", &x, &y, &z) != 3) {
-                if (sscanf(string, "%f, %f, %f", &x, &y, &z) != 3) {
-                    throw ScriptException("Couldn't convert string to vector - malformed string '%s'", string);
+            if (sscanf(string.c_str(), "%f %f %f", &x, &y, &z) != 3) {
+                if (sscanf(string.c_str(), "%f, %f, %f", &x, &y, &z) != 3) {
+                    throw ScriptException("Couldn't convert string to vector - malformed string '%s'", string.c_str());
                 }
             }
         }
@@ -33,6 +33,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "../fgame/level.h"
 #include "../fgame/parm.h"
 #include "../fgame/worldspawn.h"
+#include "../fgame/scriptprofiler.h"
 
 #include <utility>
 
@@ -53,6 +54,43 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #endif
 
+// Added in OPM
+//  maximum number of commands between two checks of the execution time
+#define VM_MAX_CMD_COUNT 15000
+
+// Added in OPM
+//  Direct-threaded dispatch for ScriptVM::Execute.
+//  With GCC/Clang, each opcode handler jumps straight to the handler of the next opcode
+//  through a table of label addresses, as long as nothing needs the bookkeeping
+//  at the end of the loop (trace, opcode pair histogram, execution time check).
+//  Other compilers only use the switch.
+#if defined(__GNUC__) || defined(__clang__)
+#    define VM_THREADED_DISPATCH
+#endif
+
+#ifdef VM_THREADED_DISPATCH
+#    define VM_CASE(op) \
+    case op:            \
+    vm_##op
+#    define VM_DEFAULT \
+    default:           \
+    vm_default
+#    define VM_NEXT                                                                                             \
+        if (bFastDispatch && state == STATE_RUNNING && Director.cmdCount + 1 < VM_MAX_CMD_COUNT            \
+            && *m_CodePos < OP_MAX) {                                                                           \
+            Director.cmdCount++;                                                                                \
+            Director.totalCmdCount++;                                                                           \
+            m_PrevCodePos = m_CodePos;                                                                          \
+            opcode        = m_CodePos++;                                                                        \
+            goto *dispatchTable[*opcode];                                                                       \
+        }                                                                                                       \
+        break
+#else
+#    define VM_CASE(op) case op
+#    define VM_DEFAULT  default
+#    define VM_NEXT     break
+#endif
+
 static const ScriptVM *currentScriptFile;
 static unsigned int    currentScriptLine;
 
@@ -464,11 +502,30 @@ bool ScriptVM::doJumpVarIf(bool booleanValue)
     return jumpVar(offset, booleanValue);
 }
 
+// Added in OPM
+//  superinstruction for a comparison followed by OP_VAR_JUMP_FALSE4
+void ScriptVM::doCompareJumpFalse(void (ScriptVariable::*compare)(ScriptVariable& variable))
+{
+    ScriptVariable& a = m_VMStack.Pop();
+    ScriptVariable& b = m_VMStack.GetTop();
+
+    try {
+        (b.*compare)(a);
+    } catch (...) {
+        // the jump is still made like it would be with the separate opcodes
+        doJumpIf(!m_VMStack.Pop().booleanValue());
+        throw;
+    }
+
+    doJumpIf(!m_VMStack.Pop().m_data.intValue);
+}
+
 void ScriptVM::loadTopInternal(Listener *listener)
 {
-    const const_str variable = fetchOpcodeValue<op_name_t>();
+    const const_str      variable  = fetchOpcodeValue<op_name_t>();
+    const op_cacheSlot_t cacheSlot = fetchOpcodeValue<op_cacheSlot_t>();
 
-    if (!executeSetter(listener, variable)) {
+    if (!executeSetter(listener, variable, cacheSlot)) {
         // just set the variable
         ScriptVariable& pTop = m_VMStack.GetTop();
         listener->Vars()->SetVariable(variable, std::move(pTop));
@@ -477,10 +534,11 @@ void ScriptVM::loadTopInternal(Listener *listener)
 
 ScriptVariable *ScriptVM::storeTopInternal(Listener *listener)
 {
-    const const_str variable = fetchOpcodeValue<op_name_t>();
-    ScriptVariable *listenerVar;
+    const const_str      variable  = fetchOpcodeValue<op_name_t>();
+    const op_cacheSlot_t cacheSlot = fetchOpcodeValue<op_cacheSlot_t>();
+    ScriptVariable      *listenerVar;
 
-    if (!executeGetter(listener, variable)) {
+    if (!executeGetter(listener, variable, cacheSlot)) {
         ScriptVariable& pTop = m_VMStack.GetTop();
         listenerVar          = listener->Vars()->GetOrCreateVariable(variable);
 
@@ -494,9 +552,10 @@ ScriptVariable *ScriptVM::storeTopInternal(Listener *listener)
 
 void ScriptVM::loadStoreTop(Listener *listener)
 {
-    const const_str variable = fetchOpcodeValue<op_name_t>();
+    const const_str      variable  = fetchOpcodeValue<op_name_t>();
+    const op_cacheSlot_t cacheSlot = fetchOpcodeValue<op_cacheSlot_t>();
 
-    if (!executeSetter(listener, variable)) {
+    if (!executeSetter(listener, variable, cacheSlot)) {
         // just set the variable
         ScriptVariable& pTop = m_VMStack.GetTop();
         listener->Vars()->SetVariable(variable, pTop);
@@ -505,7 +564,7 @@ void ScriptVM::loadStoreTop(Listener *listener)
 
 void ScriptVM::skipField()
 {
-    m_CodePos += sizeof(unsigned int);
+    m_CodePos += sizeof(op_name_t) + sizeof(op_cacheSlot_t);
 }
 
 template<>
@@ -612,11 +671,36 @@ void ScriptVM::checkValidEvent(Event& ev, Listener* listener) {
     }
 }
 
-bool ScriptVM::executeGetter(Listener *listener, op_evName_t eventName)
+bool ScriptVM::executeGetter(Listener *listener, op_evName_t eventName, op_cacheSlot_t cacheSlot)
 {
-    int eventNum = Event::FindGetterEventNum(eventName);
+    ScriptVarCache& cache    = GetScript()->m_VarCaches[cacheSlot];
+    ClassDef       *classDef = listener->classinfo();
+    int             eventNum;
+
+    assert(cacheSlot < GetScript()->m_NumVarCaches);
+
+    if (cache.classDef == classDef) {
+        // Added in OPM
+        //  this opcode already resolved the name for this class
+        eventNum = cache.eventNum;
+    } else {
+        eventNum = Event::FindGetterEventNum(eventName);
+
+        if (!eventNum || !classDef->GetDef(eventNum)) {
+            eventNum = Event::FindSetterEventNum(eventName);
+            assert(!eventNum || !classDef->GetDef(eventNum));
+            if (eventNum && classDef->GetDef(eventNum)) {
+                ScriptError("Cannot set a read-only variable");
+            }
+
+            eventNum = 0;
+        }
 
-    if (eventNum && listener->classinfo()->GetDef(eventNum)) {
+        cache.classDef = classDef;
+        cache.eventNum = eventNum;
+    }
+
+    if (eventNum) {
         ScriptCommandEvent ev(eventNum);
 
         listener->ProcessScriptEvent(ev);
@@ -625,22 +709,39 @@ bool ScriptVM::executeGetter(Listener *listener, op_evName_t eventName)
         pTop                 = std::move(ev.GetValue());
 
         return true;
-    } else {
-        eventNum = Event::FindSetterEventNum(eventName);
-        assert(!eventNum || !listener->classinfo()->GetDef(eventNum));
-        if (eventNum && listener->classinfo()->GetDef(eventNum)) {
-            ScriptError("Cannot set a read-only variable");
-        }
     }
 
     return false;
 }
 
-bool ScriptVM::executeSetter(Listener *listener, op_evName_t eventName)
+bool ScriptVM::executeSetter(Listener *listener, op_evName_t eventName, op_cacheSlot_t cacheSlot)
 {
-    int eventNum = Event::FindSetterEventNum(eventName);
+    ScriptVarCache& cache    = GetScript()->m_VarCaches[cacheSlot];
+    ClassDef       *classDef = listener->classinfo();
+    int             eventNum;
+
+    assert(cacheSlot < GetScript()->m_NumVarCaches);
+
+    if (cache.classDef == classDef) {
+        eventNum = cache.eventNum;
+    } else {
+        eventNum = Event::FindSetterEventNum(eventName);
+
+        if (!eventNum || !classDef->GetDef(eventNum)) {
+            eventNum = Event::FindSetterEventNum(eventName);
+            assert(!eventNum || !classDef->GetDef(eventNum));
+            if (eventNum && classDef->GetDef(eventNum)) {
+                ScriptError("Cannot get a write-only variable");
+            }
+
+            eventNum = 0;
+        }
+
+        cache.classDef = classDef;
+        cache.eventNum = eventNum;
+    }
 
-    if (eventNum && listener->classinfo()->GetDef(eventNum)) {
+    if (eventNum) {
         ScriptCommandEvent ev(eventNum, 1);
 
         ScriptVariable& pTop = m_VMStack.GetTop();
@@ -649,12 +750,6 @@ bool ScriptVM::executeSetter(Listener *listener, op_evName_t eventName)
         listener->ProcessScriptEvent(ev);
 
         return true;
-    } else {
-        eventNum = Event::FindSetterEventNum(eventName);
-        assert(!eventNum || !listener->classinfo()->GetDef(eventNum));
-        if (eventNum && listener->classinfo()->GetDef(eventNum)) {
-            ScriptError("Cannot get a write-only variable");
-        }
     }
 
     return false;
@@ -1026,6 +1121,135 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
 
     TargetList *targetList;
 
+#ifdef VM_THREADED_DISPATCH
+    // Added in OPM
+    //  handler of each opcode, in the order of opcode_e
+    static const void *const dispatchTable[] = {
+        &&vm_OP_DONE,
+        &&vm_OP_BOOL_JUMP_FALSE4,
+        &&vm_OP_BOOL_JUMP_TRUE4,
+        &&vm_OP_VAR_JUMP_FALSE4,
+        &&vm_OP_VAR_JUMP_TRUE4,
+        &&vm_OP_BOOL_LOGICAL_AND,
+        &&vm_OP_BOOL_LOGICAL_OR,
+        &&vm_OP_VAR_LOGICAL_AND,
+        &&vm_OP_VAR_LOGICAL_OR,
+        &&vm_default, // OP_BOOL_TO_VAR
+        &&vm_OP_JUMP4,
+        &&vm_OP_JUMP_BACK4,
+        &&vm_OP_STORE_INT0,
+        &&vm_OP_STORE_INT1,
+        &&vm_OP_STORE_INT2,
+        &&vm_OP_STORE_INT3,
+        &&vm_OP_STORE_INT4,
+        &&vm_OP_BOOL_STORE_FALSE,
+        &&vm_OP_BOOL_STORE_TRUE,
+        &&vm_OP_STORE_STRING,
+        &&vm_OP_STORE_FLOAT,
+        &&vm_OP_STORE_VECTOR,
+        &&vm_OP_CALC_VECTOR,
+        &&vm_OP_STORE_NULL,
+        &&vm_OP_STORE_NIL,
+        &&vm_OP_EXEC_CMD0,
+        &&vm_OP_EXEC_CMD1,
+        &&vm_OP_EXEC_CMD2,
+        &&vm_OP_EXEC_CMD3,
+        &&vm_OP_EXEC_CMD4,
+        &&vm_OP_EXEC_CMD5,
+        &&vm_OP_EXEC_CMD_COUNT1,
+        &&vm_OP_EXEC_CMD_METHOD0,
+        &&vm_OP_EXEC_CMD_METHOD1,
+        &&vm_OP_EXEC_CMD_METHOD2,
+        &&vm_OP_EXEC_CMD_METHOD3,
+        &&vm_OP_EXEC_CMD_METHOD4,
+        &&vm_OP_EXEC_CMD_METHOD5,
+        &&vm_OP_EXEC_CMD_METHOD_COUNT1,
+        &&vm_OP_EXEC_METHOD0,
+        &&vm_OP_EXEC_METHOD1,
+        &&vm_OP_EXEC_METHOD2,
+        &&vm_OP_EXEC_METHOD3,
+        &&vm_OP_EXEC_METHOD4,
+        &&vm_OP_EXEC_METHOD5,
+        &&vm_OP_EXEC_METHOD_COUNT1,
+        &&vm_OP_LOAD_GAME_VAR,
+        &&vm_OP_LOAD_LEVEL_VAR,
+        &&vm_OP_LOAD_LOCAL_VAR,
+        &&vm_OP_LOAD_PARM_VAR,
+        &&vm_OP_LOAD_SELF_VAR,
+        &&vm_OP_LOAD_GROUP_VAR,
+        &&vm_OP_LOAD_OWNER_VAR,
+        &&vm_OP_LOAD_FIELD_VAR,
+        &&vm_OP_LOAD_ARRAY_VAR,
+        &&vm_OP_LOAD_CONST_ARRAY1,
+        &&vm_OP_STORE_FIELD_REF,
+        &&vm_OP_STORE_ARRAY_REF,
+        &&vm_OP_MARK_STACK_POS,
+        &&vm_OP_STORE_PARAM,
+        &&vm_OP_RESTORE_STACK_POS,
+        &&vm_OP_LOAD_STORE_GAME_VAR,
+        &&vm_OP_LOAD_STORE_LEVEL_VAR,
+        &&vm_OP_LOAD_STORE_LOCAL_VAR,
+        &&vm_OP_LOAD_STORE_PARM_VAR,
+        &&vm_OP_LOAD_STORE_SELF_VAR,
+        &&vm_OP_LOAD_STORE_GROUP_VAR,
+        &&vm_OP_LOAD_STORE_OWNER_VAR,
+        &&vm_OP_STORE_GAME_VAR,
+        &&vm_OP_STORE_LEVEL_VAR,
+        &&vm_OP_STORE_LOCAL_VAR,
+        &&vm_OP_STORE_PARM_VAR,
+        &&vm_OP_STORE_SELF_VAR,
+        &&vm_OP_STORE_GROUP_VAR,
+        &&vm_OP_STORE_OWNER_VAR,
+        &&vm_OP_STORE_FIELD,
+        &&vm_OP_STORE_ARRAY,
+        &&vm_OP_STORE_GAME,
+        &&vm_OP_STORE_LEVEL,
+        &&vm_OP_STORE_LOCAL,
+        &&vm_OP_STORE_PARM,
+        &&vm_OP_STORE_SELF,
+        &&vm_OP_STORE_GROUP,
+        &&vm_OP_STORE_OWNER,
+        &&vm_OP_BIN_BITWISE_AND,
+        &&vm_OP_BIN_BITWISE_OR,
+        &&vm_OP_BIN_BITWISE_EXCL_OR,
+        &&vm_OP_BIN_EQUALITY,
+        &&vm_OP_BIN_INEQUALITY,
+        &&vm_OP_BIN_LESS_THAN,
+        &&vm_OP_BIN_GREATER_THAN,
+        &&vm_OP_BIN_LESS_THAN_OR_EQUAL,
+        &&vm_OP_BIN_GREATER_THAN_OR_EQUAL,
+        &&vm_OP_BIN_PLUS,
+        &&vm_OP_BIN_MINUS,
+        &&vm_OP_BIN_MULTIPLY,
+        &&vm_OP_BIN_DIVIDE,
+        &&vm_OP_BIN_PERCENTAGE,
+        &&vm_OP_UN_MINUS,
+        &&vm_OP_UN_COMPLEMENT,
+        &&vm_OP_UN_TARGETNAME,
+        &&vm_OP_BOOL_UN_NOT,
+        &&vm_OP_VAR_UN_NOT,
+        &&vm_OP_UN_CAST_BOOLEAN,
+        &&vm_OP_UN_INC,
+        &&vm_OP_UN_DEC,
+        &&vm_OP_UN_SIZE,
+        &&vm_OP_SWITCH,
+        &&vm_OP_FUNC,
+        &&vm_OP_NOP,
+        &&vm_OP_BIN_SHIFT_LEFT,
+        &&vm_OP_BIN_SHIFT_RIGHT,
+        &&vm_default, // OP_END
+        &&vm_default, // OP_RETURN
+        &&vm_OP_BIN_EQUALITY_JUMP_FALSE4,
+        &&vm_OP_BIN_INEQUALITY_JUMP_FALSE4,
+        &&vm_OP_BIN_LESS_THAN_JUMP_FALSE4,
+        &&vm_OP_BIN_GREATER_THAN_JUMP_FALSE4,
+        &&vm_OP_BIN_LESS_THAN_OR_EQUAL_JUMP_FALSE4,
+        &&vm_OP_BIN_GREATER_THAN_OR_EQUAL_JUMP_FALSE4,
+    };
+    static_assert(sizeof(dispatchTable) / sizeof(dispatchTable[0]) == OP_MAX, "dispatchTable must match opcode_e");
+    bool bFastDispatch;
+#endif
+
     if (Director.stackCount >= MAX_STACK_DEPTH) {
         state = STATE_EXECUTION;
 
@@ -1051,6 +1275,11 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
 
     Director.stackCount++;
 
+    if (scriptProfiler.IsActive()) {
+        // Added in OPM
+        scriptProfiler.EnterFrame(this, Director.stackCount);
+    }
+
     if (dataSize) {
         SetFastData(data, dataSize);
     }
@@ -1071,6 +1300,22 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
             }
         }
 
+        if (Director.opcodePairCounts) {
+            // Added in OPM
+            //  opcode pair histogram, see the scriptopcodepairs command
+            Director.CountOpcodePair(m_PrevCodePos, m_CodePos);
+        }
+
+        if (scriptProfiler.IsActive()) {
+            // Added in OPM
+            //  see the scriptprofile command
+            scriptProfiler.Tick(this, Director.stackCount, m_CodePos);
+        }
+
+#ifdef VM_THREADED_DISPATCH
+        bFastDispatch = !g_scripttrace->integer && !Director.opcodePairCounts && !scriptProfiler.IsActive();
+#endif
+
         m_PrevCodePos = m_CodePos;
 
         try {
@@ -1098,326 +1343,356 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
 
             opcode = m_CodePos++;
             switch (*opcode) {
-            case OP_BIN_BITWISE_AND:
+            VM_CASE(OP_BIN_BITWISE_AND):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b &= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_BITWISE_OR:
+            VM_CASE(OP_BIN_BITWISE_OR):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b |= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_BITWISE_EXCL_OR:
+            VM_CASE(OP_BIN_BITWISE_EXCL_OR):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b ^= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_EQUALITY:
+            VM_CASE(OP_BIN_EQUALITY):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 b->setIntValue(*b == *a);
-                break;
+                VM_NEXT;
 
-            case OP_BIN_INEQUALITY:
+            VM_CASE(OP_BIN_INEQUALITY):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 b->setIntValue(*b != *a);
-                break;
+                VM_NEXT;
 
-            case OP_BIN_GREATER_THAN:
+            VM_CASE(OP_BIN_GREATER_THAN):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 b->greaterthan(*a);
-                break;
+                VM_NEXT;
 
-            case OP_BIN_GREATER_THAN_OR_EQUAL:
+            VM_CASE(OP_BIN_GREATER_THAN_OR_EQUAL):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 b->greaterthanorequal(*a);
-                break;
+                VM_NEXT;
 
-            case OP_BIN_LESS_THAN:
+            VM_CASE(OP_BIN_LESS_THAN):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 b->lessthan(*a);
-                break;
+                VM_NEXT;
 
-            case OP_BIN_LESS_THAN_OR_EQUAL:
+            VM_CASE(OP_BIN_LESS_THAN_OR_EQUAL):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 b->lessthanorequal(*a);
-                break;
+                VM_NEXT;
 
-            case OP_BIN_PLUS:
+            VM_CASE(OP_BIN_PLUS):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b += *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_MINUS:
+            VM_CASE(OP_BIN_MINUS):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b -= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_MULTIPLY:
+            VM_CASE(OP_BIN_MULTIPLY):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b *= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_DIVIDE:
+            VM_CASE(OP_BIN_DIVIDE):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b /= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_PERCENTAGE:
+            VM_CASE(OP_BIN_PERCENTAGE):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b %= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_SHIFT_LEFT:
+            VM_CASE(OP_BIN_SHIFT_LEFT):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b <<= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_SHIFT_RIGHT:
+            VM_CASE(OP_BIN_SHIFT_RIGHT):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b >>= *a;
-                break;
+                VM_NEXT;
+
+            VM_CASE(OP_BIN_EQUALITY_JUMP_FALSE4):
+                a = &m_VMStack.Pop();
+                b = &m_VMStack.Pop();
+
+                doJumpIf(!(*b == *a));
+                VM_NEXT;
+
+            VM_CASE(OP_BIN_INEQUALITY_JUMP_FALSE4):
+                a = &m_VMStack.Pop();
+                b = &m_VMStack.Pop();
+
+                doJumpIf(!(*b != *a));
+                VM_NEXT;
+
+            VM_CASE(OP_BIN_LESS_THAN_JUMP_FALSE4):
+                doCompareJumpFalse(&ScriptVariable::lessthan);
+                VM_NEXT;
+
+            VM_CASE(OP_BIN_GREATER_THAN_JUMP_FALSE4):
+                doCompareJumpFalse(&ScriptVariable::greaterthan);
+                VM_NEXT;
+
+            VM_CASE(OP_BIN_LESS_THAN_OR_EQUAL_JUMP_FALSE4):
+                doCompareJumpFalse(&ScriptVariable::lessthanorequal);
+                VM_NEXT;
 
-            case OP_BOOL_JUMP_FALSE4:
+            VM_CASE(OP_BIN_GREATER_THAN_OR_EQUAL_JUMP_FALSE4):
+                doCompareJumpFalse(&ScriptVariable::greaterthanorequal);
+                VM_NEXT;
+
+            VM_CASE(OP_BOOL_JUMP_FALSE4):
                 doJumpIf(!m_VMStack.Pop().m_data.intValue);
-                break;
+                VM_NEXT;
 
-            case OP_BOOL_JUMP_TRUE4:
+            VM_CASE(OP_BOOL_JUMP_TRUE4):
                 doJumpIf(m_VMStack.Pop().m_data.intValue);
-                break;
+                VM_NEXT;
 
-            case OP_VAR_JUMP_FALSE4:
+            VM_CASE(OP_VAR_JUMP_FALSE4):
                 doJumpIf(!m_VMStack.Pop().booleanValue());
-                break;
+                VM_NEXT;
 
-            case OP_VAR_JUMP_TRUE4:
+            VM_CASE(OP_VAR_JUMP_TRUE4):
                 doJumpIf(m_VMStack.Pop().booleanValue());
-                break;
+                VM_NEXT;
 
-            case OP_BOOL_LOGICAL_AND:
+            VM_CASE(OP_BOOL_LOGICAL_AND):
                 doJumpVarIf(!m_VMStack.GetTop().m_data.intValue);
-                break;
+                VM_NEXT;
 
-            case OP_BOOL_LOGICAL_OR:
+            VM_CASE(OP_BOOL_LOGICAL_OR):
                 doJumpVarIf(m_VMStack.GetTop().m_data.intValue);
-                break;
+                VM_NEXT;
 
-            case OP_VAR_LOGICAL_AND:
+            VM_CASE(OP_VAR_LOGICAL_AND):
                 if (!doJumpVarIf(m_VMStack.GetTop().booleanValue())) {
                     m_VMStack.GetTop().SetFalse();
                 }
-                break;
+                VM_NEXT;
 
-            case OP_VAR_LOGICAL_OR:
+            VM_CASE(OP_VAR_LOGICAL_OR):
                 if (!doJumpVarIf(!m_VMStack.GetTop().booleanValue())) {
                     m_VMStack.GetTop().SetTrue();
                 }
-                break;
+                VM_NEXT;
 
-            case OP_BOOL_STORE_FALSE:
+            VM_CASE(OP_BOOL_STORE_FALSE):
                 m_VMStack.PushAndGet().SetFalse();
-                break;
+                VM_NEXT;
 
-            case OP_BOOL_STORE_TRUE:
+            VM_CASE(OP_BOOL_STORE_TRUE):
                 m_VMStack.PushAndGet().SetTrue();
-                break;
+                VM_NEXT;
 
-            case OP_BOOL_UN_NOT:
+            VM_CASE(OP_BOOL_UN_NOT):
                 m_VMStack.GetTop().m_data.intValue = (m_VMStack.GetTop().m_data.intValue == 0);
-                break;
+                VM_NEXT;
 
-            case OP_CALC_VECTOR:
+            VM_CASE(OP_CALC_VECTOR):
                 c = &m_VMStack.Pop();
                 b = &m_VMStack.Pop();
                 a = &m_VMStack.GetTop();
 
                 m_VMStack.GetTop().setVectorValue(Vector(a->floatValue(), b->floatValue(), c->floatValue()));
-                break;
+                VM_NEXT;
 
-            case OP_EXEC_CMD0:
+            VM_CASE(OP_EXEC_CMD0):
                 {
                     execCmdCommon(0);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD1:
+            VM_CASE(OP_EXEC_CMD1):
                 {
                     execCmdCommon(1);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD2:
+            VM_CASE(OP_EXEC_CMD2):
                 {
                     execCmdCommon(2);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD3:
+            VM_CASE(OP_EXEC_CMD3):
                 {
                     execCmdCommon(3);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD4:
+            VM_CASE(OP_EXEC_CMD4):
                 {
                     execCmdCommon(4);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD5:
+            VM_CASE(OP_EXEC_CMD5):
                 {
                     execCmdCommon(5);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_COUNT1:
+            VM_CASE(OP_EXEC_CMD_COUNT1):
                 {
                     const op_parmNum_t numParms = fetchOpcodeValue<op_parmNum_t>();
                     execCmdCommon(numParms);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_METHOD0:
+            VM_CASE(OP_EXEC_CMD_METHOD0):
                 {
                     execCmdMethodCommon(0);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_METHOD1:
+            VM_CASE(OP_EXEC_CMD_METHOD1):
                 {
                     execCmdMethodCommon(1);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_METHOD2:
+            VM_CASE(OP_EXEC_CMD_METHOD2):
                 {
                     execCmdMethodCommon(2);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_METHOD3:
+            VM_CASE(OP_EXEC_CMD_METHOD3):
                 {
                     execCmdMethodCommon(3);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_METHOD4:
+            VM_CASE(OP_EXEC_CMD_METHOD4):
                 {
                     execCmdMethodCommon(4);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_METHOD5:
+            VM_CASE(OP_EXEC_CMD_METHOD5):
                 {
                     execCmdMethodCommon(5);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_METHOD_COUNT1:
+            VM_CASE(OP_EXEC_CMD_METHOD_COUNT1):
                 {
                     const op_parmNum_t numParms = fetchOpcodeValue<op_parmNum_t>();
                     execCmdMethodCommon(numParms);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_METHOD0:
+            VM_CASE(OP_EXEC_METHOD0):
                 {
                     execMethodCommon(0);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_METHOD1:
+            VM_CASE(OP_EXEC_METHOD1):
                 {
                     execMethodCommon(1);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_METHOD2:
+            VM_CASE(OP_EXEC_METHOD2):
                 {
                     execMethodCommon(2);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_METHOD3:
+            VM_CASE(OP_EXEC_METHOD3):
                 {
                     execMethodCommon(3);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_METHOD4:
+            VM_CASE(OP_EXEC_METHOD4):
                 {
                     execMethodCommon(4);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_METHOD5:
+            VM_CASE(OP_EXEC_METHOD5):
                 {
                     execMethodCommon(5);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_METHOD_COUNT1:
+            VM_CASE(OP_EXEC_METHOD_COUNT1):
                 {
                     const op_parmNum_t numParms = fetchOpcodeValue<op_parmNum_t>();
                     execMethodCommon(numParms);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_FUNC:
+            VM_CASE(OP_FUNC):
                 {
                     execFunction(Director);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_JUMP4:
+            VM_CASE(OP_JUMP4):
                 jump(fetchOpcodeValue<unsigned int>());
-                break;
+                VM_NEXT;
 
-            case OP_JUMP_BACK4:
+            VM_CASE(OP_JUMP_BACK4):
                 jumpBack(fetchActualOpcodeValue<unsigned int>());
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_ARRAY_VAR:
+            VM_CASE(OP_LOAD_ARRAY_VAR):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.Pop();
                 c = &m_VMStack.Pop();
 
                 b->setArrayAt(*a, *c);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_FIELD_VAR:
+            VM_CASE(OP_LOAD_FIELD_VAR):
                 a = &m_VMStack.Pop();
 
                 try {
@@ -1441,112 +1716,112 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                     throw;
                 }
 
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_CONST_ARRAY1:
+            VM_CASE(OP_LOAD_CONST_ARRAY1):
                 {
                     op_arrayParmNum_t numParms = fetchOpcodeValue<op_arrayParmNum_t>();
 
                     ScriptVariable& pTop = m_VMStack.PopAndGet(numParms - 1);
                     pTop.setConstArrayValue(&pTop, numParms);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_LOAD_GAME_VAR:
+            VM_CASE(OP_LOAD_GAME_VAR):
                 loadTop(&game);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_GROUP_VAR:
+            VM_CASE(OP_LOAD_GROUP_VAR):
                 loadTop(m_ScriptClass);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_LEVEL_VAR:
+            VM_CASE(OP_LOAD_LEVEL_VAR):
                 loadTop(&level);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_LOCAL_VAR:
+            VM_CASE(OP_LOAD_LOCAL_VAR):
                 loadTop(m_Thread);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_OWNER_VAR:
+            VM_CASE(OP_LOAD_OWNER_VAR):
                 if (!m_ScriptClass->m_Self) {
                     m_VMStack.Pop();
-                    m_CodePos += sizeof(unsigned int);
+                    skipField();
                     ScriptError("self is NULL");
                 }
 
                 if (!m_ScriptClass->m_Self->GetScriptOwner()) {
                     m_VMStack.Pop();
-                    m_CodePos += sizeof(unsigned int);
+                    skipField();
                     ScriptError("self.owner is NULL");
                 }
 
                 loadTop(m_ScriptClass->m_Self->GetScriptOwner());
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_PARM_VAR:
+            VM_CASE(OP_LOAD_PARM_VAR):
                 loadTop(&parm);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_SELF_VAR:
+            VM_CASE(OP_LOAD_SELF_VAR):
                 if (!m_ScriptClass->m_Self) {
                     m_VMStack.Pop();
-                    m_CodePos += sizeof(unsigned int);
+                    skipField();
                     ScriptError("self is NULL");
                 }
 
                 loadTop(m_ScriptClass->m_Self);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_STORE_GAME_VAR:
+            VM_CASE(OP_LOAD_STORE_GAME_VAR):
                 loadStoreTop(&game);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_STORE_GROUP_VAR:
+            VM_CASE(OP_LOAD_STORE_GROUP_VAR):
                 loadStoreTop(m_ScriptClass);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_STORE_LEVEL_VAR:
+            VM_CASE(OP_LOAD_STORE_LEVEL_VAR):
                 loadStoreTop(&level);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_STORE_LOCAL_VAR:
+            VM_CASE(OP_LOAD_STORE_LOCAL_VAR):
                 loadStoreTop(m_Thread);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_STORE_OWNER_VAR:
+            VM_CASE(OP_LOAD_STORE_OWNER_VAR):
                 if (!m_ScriptClass->m_Self) {
-                    m_CodePos += sizeof(unsigned int);
+                    skipField();
                     ScriptError("self is NULL");
                 }
 
                 if (!m_ScriptClass->m_Self->GetScriptOwner()) {
-                    m_CodePos += sizeof(unsigned int);
+                    skipField();
                     ScriptError("self.owner is NULL");
                 }
 
                 loadStoreTop(m_ScriptClass->m_Self->GetScriptOwner());
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_STORE_PARM_VAR:
+            VM_CASE(OP_LOAD_STORE_PARM_VAR):
                 loadStoreTop(&parm);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_STORE_SELF_VAR:
+            VM_CASE(OP_LOAD_STORE_SELF_VAR):
                 if (!m_ScriptClass->m_Self) {
-                    m_CodePos += sizeof(unsigned int);
+                    skipField();
                     ScriptError("self is NULL");
                 }
 
                 loadStoreTop(m_ScriptClass->m_Self);
-                break;
+                VM_NEXT;
 
-            case OP_MARK_STACK_POS:
+            VM_CASE(OP_MARK_STACK_POS):
                 m_StackPos   = &m_VMStack.GetTop();
                 m_VMStack.m_bMarkStack = true;
-                break;
+                VM_NEXT;
 
-            case OP_STORE_PARAM:
+            VM_CASE(OP_STORE_PARAM):
                 if (fastEvent.dataSize) {
                     m_VMStack.SetTop(*(fastEvent.data++));
                     fastEvent.dataSize--;
@@ -1554,24 +1829,24 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                     m_VMStack.SetTop(*(m_StackPos + 1));
                     m_VMStack.GetTop().Clear();
                 }
-                break;
+                VM_NEXT;
 
-            case OP_RESTORE_STACK_POS:
+            VM_CASE(OP_RESTORE_STACK_POS):
                 m_VMStack.SetTop(*m_StackPos);
                 m_VMStack.m_bMarkStack = false;
-                break;
+                VM_NEXT;
 
-            case OP_STORE_ARRAY:
+            VM_CASE(OP_STORE_ARRAY):
                 m_VMStack.Pop();
                 m_VMStack.GetTop().evalArrayAt(*(m_VMStack.GetTopPtr() + 1));
-                break;
+                VM_NEXT;
 
-            case OP_STORE_ARRAY_REF:
+            VM_CASE(OP_STORE_ARRAY_REF):
                 m_VMStack.Pop();
                 m_VMStack.GetTop().setArrayRefValue(*(m_VMStack.GetTopPtr() + 1));
-                break;
+                VM_NEXT;
 
-            case OP_STORE_FIELD_REF:
+            VM_CASE(OP_STORE_FIELD_REF):
                 try {
                     try {
                         listener = m_VMStack.GetTop().listenerValue();
@@ -1594,14 +1869,14 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                         // having a listener variable means the variable was just created
                         m_VMStack.GetTop().setRefValue(listenerVar);
                     }
-                    break;
+                    VM_NEXT;
                 } catch (...) {
                     ScriptVariable *const pTop = m_VMStack.GetTopPtr();
                     pTop->setRefValue(pTop);
                     throw;
                 }
 
-            case OP_STORE_FIELD:
+            VM_CASE(OP_STORE_FIELD):
                 try {
                     listener = m_VMStack.GetTop().listenerValue();
 
@@ -1616,105 +1891,105 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                 }
 
                 storeTop<true>(listener);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_FLOAT:
+            VM_CASE(OP_STORE_FLOAT):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setFloatValue(fetchOpcodeValue<float>());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_INT0:
+            VM_CASE(OP_STORE_INT0):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setIntValue(0);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_INT1:
+            VM_CASE(OP_STORE_INT1):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setIntValue(fetchOpcodeValue<byte>());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_INT2:
+            VM_CASE(OP_STORE_INT2):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setIntValue(fetchOpcodeValue<short>());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_INT3:
+            VM_CASE(OP_STORE_INT3):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setIntValue(fetchOpcodeValue<short3>());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_INT4:
+            VM_CASE(OP_STORE_INT4):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setIntValue(fetchOpcodeValue<int>());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_GAME_VAR:
+            VM_CASE(OP_STORE_GAME_VAR):
                 storeTop(&game);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_GROUP_VAR:
+            VM_CASE(OP_STORE_GROUP_VAR):
                 storeTop(m_ScriptClass);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_LEVEL_VAR:
+            VM_CASE(OP_STORE_LEVEL_VAR):
                 storeTop(&level);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_LOCAL_VAR:
+            VM_CASE(OP_STORE_LOCAL_VAR):
                 storeTop(m_Thread);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_OWNER_VAR:
+            VM_CASE(OP_STORE_OWNER_VAR):
                 if (!m_ScriptClass->m_Self) {
                     m_VMStack.PushAndGet().Clear();
-                    m_CodePos += sizeof(unsigned int);
+                    skipField();
                     ScriptError("self is NULL");
                 }
 
                 if (!m_ScriptClass->m_Self->GetScriptOwner()) {
                     m_VMStack.PushAndGet().Clear();
-                    m_CodePos += sizeof(unsigned int);
+                    skipField();
                     ScriptError("self.owner is NULL");
                 }
 
                 storeTop(m_ScriptClass->m_Self->GetScriptOwner());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_PARM_VAR:
+            VM_CASE(OP_STORE_PARM_VAR):
                 storeTop(&parm);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_SELF_VAR:
+            VM_CASE(OP_STORE_SELF_VAR):
                 if (!m_ScriptClass->m_Self) {
                     m_VMStack.PushAndGet().Clear();
-                    m_CodePos += sizeof(unsigned int);
+                    skipField();
                     ScriptError("self is NULL");
                 }
 
                 storeTop(m_ScriptClass->m_Self);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_GAME:
+            VM_CASE(OP_STORE_GAME):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setListenerValue(&game);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_GROUP:
+            VM_CASE(OP_STORE_GROUP):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setListenerValue(m_ScriptClass);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_LEVEL:
+            VM_CASE(OP_STORE_LEVEL):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setListenerValue(&level);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_LOCAL:
+            VM_CASE(OP_STORE_LOCAL):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setListenerValue(m_Thread);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_OWNER:
+            VM_CASE(OP_STORE_OWNER):
                 if (m_ScriptClass->m_Self) {
                     m_VMStack.Push();
                 } else {
@@ -1723,72 +1998,78 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                 }
 
                 m_VMStack.GetTop().setListenerValue(m_ScriptClass->m_Self->GetScriptOwner());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_PARM:
+            VM_CASE(OP_STORE_PARM):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setListenerValue(&parm);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_SELF:
+            VM_CASE(OP_STORE_SELF):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setListenerValue(m_ScriptClass->m_Self);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_NIL:
+            VM_CASE(OP_STORE_NIL):
                 m_VMStack.Push();
                 m_VMStack.GetTop().Clear();
-                break;
+                VM_NEXT;
 
-            case OP_STORE_NULL:
+            VM_CASE(OP_STORE_NULL):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setListenerValue(NULL);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_STRING:
+            VM_CASE(OP_STORE_STRING):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setConstStringValue(fetchOpcodeValue<unsigned int>());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_VECTOR:
+            VM_CASE(OP_STORE_VECTOR):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setVectorValue(fetchOpcodeValue<Vector>());
-                break;
+                VM_NEXT;
 
-            case OP_SWITCH:
+            VM_CASE(OP_SWITCH):
                 if (!Switch(fetchActualOpcodeValue<StateScript *>(), m_VMStack.Pop())) {
                     m_CodePos += sizeof(StateScript *);
                 }
-                break;
+                VM_NEXT;
 
-            case OP_UN_CAST_BOOLEAN:
+            VM_CASE(OP_UN_CAST_BOOLEAN):
                 m_VMStack.GetTop().CastBoolean();
-                break;
+                VM_NEXT;
 
-            case OP_UN_COMPLEMENT:
+            VM_CASE(OP_UN_COMPLEMENT):
                 m_VMStack.GetTop().complement();
-                break;
+                VM_NEXT;
 
-            case OP_UN_MINUS:
+            VM_CASE(OP_UN_MINUS):
                 m_VMStack.GetTop().minus();
-                break;
+                VM_NEXT;
 
-            case OP_UN_DEC:
+            VM_CASE(OP_UN_DEC):
                 m_VMStack.GetTop()--;
-                break;
+                VM_NEXT;
 
-            case OP_UN_INC:
+            VM_CASE(OP_UN_INC):
                 m_VMStack.GetTop()++;
-                break;
+                VM_NEXT;
 
-            case OP_UN_SIZE:
+            VM_CASE(OP_UN_SIZE):
                 m_VMStack.GetTop().setIntValue((int)m_VMStack.GetTop().size());
-                break;
+                VM_NEXT;
 
-            case OP_UN_TARGETNAME:
+            VM_CASE(OP_UN_TARGETNAME):
                 // retrieve the target name
                 if (world) {
-                    targetList = world->GetExistingTargetList(m_VMStack.GetTop().stringValue());
+                    if (m_VMStack.GetTop().GetType() == VARIABLE_CONSTSTRING) {
+                        // Added in OPM
+                        //  constant target names are already interned, look them up directly
+                        targetList = world->GetExistingTargetList(m_VMStack.GetTop().constStringValue());
+                    } else {
+                        targetList = world->GetExistingTargetList(m_VMStack.GetTop().stringValue());
+                    }
                 } else {
                     // Added in OPM
                     //  don't use the target list if the world is NULL
@@ -1811,32 +2092,33 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                     // multiple listeners
                     m_VMStack.GetTop().setContainerValue((Container<SafePtr<Listener>> *)&targetList->list);
                 }
-                break;
+                VM_NEXT;
 
-            case OP_VAR_UN_NOT:
+            VM_CASE(OP_VAR_UN_NOT):
                 m_VMStack.GetTop().setIntValue(m_VMStack.GetTop().booleanValue());
-                break;
+                VM_NEXT;
 
-            case OP_DONE:
+            VM_CASE(OP_DONE):
                 End();
-                break;
+                VM_NEXT;
 
-            case OP_NOP:
-                break;
+            VM_CASE(OP_NOP):
+                VM_NEXT;
 
-            default:
+            VM_DEFAULT:
                 assert(!"Invalid opcode");
                 if (*opcode < OP_MAX) {
                     gi.DPrintf("unknown opcode %d ('%s')\n", *opcode, OpcodeName(*opcode));
                 } else {
                     gi.DPrintf("unknown opcode %d\n", *opcode);
                 }
-                break;
+                VM_NEXT;
             }
 
             Director.cmdCount++;
+            Director.totalCmdCount++;
 
-            if (Director.cmdCount >= 15000) {
+            if (Director.cmdCount >= VM_MAX_CMD_COUNT) {
                 if (!Director.cmdTime) {
                     Director.cmdTime = gi.Milliseconds();
                     Director.cmdCount = 0;
@@ -1877,6 +2159,11 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
         }
     }
 
+    if (scriptProfiler.IsActive()) {
+        // Added in OPM
+        scriptProfiler.LeaveFrame(this, Director.stackCount);
+    }
+
     Director.stackCount--;
 
     if (g_scripttrace->integer && CanScriptTracePrint()) {
@@ -1960,7 +2247,7 @@ void ScriptVM::SetFastData(ScriptVariable *data, int dataSize)
     }
 
     if (dataSize) {
-        fastEvent.data     = new ScriptVariable[dataSize];
+        fastEvent.data     = Event::NewData(dataSize);
         fastEvent.dataSize = dataSize;
 
         for (int i = 0; i < dataSize; i++) {
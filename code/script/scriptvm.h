@@ -174,8 +174,8 @@ private:
     void executeCommand(Listener *listener, op_parmNum_t iParamCount, op_evName_t eventnum);
     template<bool bReturn>
     void executeCommandInternal(Event& ev, Listener *listener, ScriptVariable *fromVar, op_parmNum_t iParamCount);
-    bool executeGetter(Listener *listener, op_evName_t eventName);
-    bool executeSetter(Listener *listener, op_evName_t eventName);
+    bool executeGetter(Listener *listener, op_evName_t eventName, op_cacheSlot_t cacheSlot);
+    bool executeSetter(Listener *listener, op_evName_t eventName, op_cacheSlot_t cacheSlot);
     void transferVarsToEvent(Event& ev, ScriptVariable *fromVar, op_parmNum_t count);
     void checkValidEvent(Event& ev, Listener *listener);
 
@@ -240,6 +240,7 @@ private:
     bool jumpVar(unsigned int offset, bool booleanValue);
     void doJumpIf(bool booleanValue);
     bool doJumpVarIf(bool booleanValue);
+    void doCompareJumpFalse(void (ScriptVariable::*compare)(ScriptVariable& variable));
 
     void fetchOpcodeValue(void *outValue, size_t size);
     void fetchActualOpcodeValue(void *outValue, size_t size);
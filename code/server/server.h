@@ -76,6 +76,10 @@ typedef enum {
 	SS_GAME				// actively running
 } serverState_t;
 
+// Added in OPM
+//  number of buckets in the configstring name index
+#define CS_HASH_SIZE	1024
+
 typedef struct {
 	serverState_t	state;
 	qboolean		restarting;			// if true, send configstring changes during SS_LOADING
@@ -91,6 +95,13 @@ typedef struct {
 	float			frameTime;
 	struct cmodel_s	*models[MAX_MODELS];
 	char			*configstrings[MAX_CONFIGSTRINGS];
+	// Added in OPM
+	//  case-insensitive index of configstrings, used by SV_FindIndex.
+	//  slots are stored as index + 1 so a zeroed server_t is a valid empty index
+	unsigned short	csHashHead[CS_HASH_SIZE];
+	unsigned short	csHashNext[MAX_CONFIGSTRINGS];
+	unsigned short	csHashValue[MAX_CONFIGSTRINGS];
+	unsigned int	csUsedBits[(MAX_CONFIGSTRINGS + 31) / 32];
 	svEntity_t		svEntities[MAX_GENTITIES];
 
 	int				farplane;
@@ -213,6 +224,10 @@ typedef struct client_s {
 
 	int				oldServerTime;
 	qboolean		csUpdated[MAX_CONFIGSTRINGS];
+	// Added in OPM
+	//  configstrings changed while active, sent once per snapshot
+	short			csPending[MAX_CONFIGSTRINGS];
+	int				numCsPending;
 
 	server_sound_t server_sounds[ MAX_SERVER_SOUNDS ];
 	int number_of_server_sounds;
@@ -325,7 +340,6 @@ typedef struct {
 	netprofclient_t netprofile;
 } serverStatic_t;
 
-#define SERVER_MAXBANS	1024
 // Structure for managing bans
 typedef struct
 {
@@ -388,7 +402,7 @@ extern	cvar_t	*sv_strictAuth;
 #endif
 extern	cvar_t	*sv_banFile;
 
-extern	serverBan_t serverBans[SERVER_MAXBANS];
+extern	serverBan_t *serverBans;
 extern	int serverBansCount;
 
 #ifdef USE_VOIP
@@ -477,6 +491,8 @@ int SV_ImageIndex( const char *name );
 int SV_ItemIndex( const char *name );
 void SV_SetLightStyle( int index, const char *data );
 void SV_UpdateConfigstrings( client_t *client );
+void SV_FlushConfigstrings( client_t *client );
+void SV_ClearPendingConfigstrings( client_t *client );
 
 void SV_SetUserinfo( int index, const char *val );
 void SV_GetUserinfo( int index, char *buffer, int bufferSize );
@@ -506,6 +522,7 @@ void SV_ExecuteClientMessage( client_t *cl, msg_t *msg );
 void SV_UserinfoChanged( client_t *cl );
 
 void SV_ClientEnterWorld( client_t *client, usercmd_t *cmd );
+client_t *SV_ConnectBenchClient( const char *name );
 void SV_FreeClient(client_t *client);
 void SV_DropClient( client_t *drop, const char *reason );
 
@@ -521,6 +538,9 @@ int SV_SendQueuedMessages(void);
 // sv_ccmds.c
 //
 void SV_Heartbeat_f( void );
+// Added in OPM
+void SV_InitBans( void );
+int SV_FindBan( const netadr_t *from, qboolean isexception );
 
 //
 // sv_snapshot.c
@@ -597,12 +617,20 @@ int SV_AreaEntities( const vec3_t mins, const vec3_t maxs, int *entityList, int
 // returns the number of pointers filled in
 // The world entity is never returned in this list.
 
+// Added in OPM
+//  gathers the area entities once for a burst of traces inside mins/maxs
+void SV_BeginTraceSession( const vec3_t mins, const vec3_t maxs );
+void SV_EndTraceSession( void );
+
 baseshader_t *SV_GetShaderPointer( int iShaderNum );
 int SV_PointContents( const vec3_t p, int passEntityNum );
 // returns the CONTENTS_* value from the world and all entities at the given point.
 
 qboolean SV_SightTraceEntity( gentity_t *touch, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int contentmask, qboolean cylinder );
 qboolean SV_SightTrace( const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int passEntityNum2, int contentmask, qboolean cylinder );
+// Added in OPM
+//  point sight trace that can run on several threads at once
+qboolean SV_SightTraceConcurrent( const vec3_t start, const vec3_t end, int passEntityNum, int passEntityNum2, int contentmask );
 qboolean SV_HitEntity(gentity_t* pEnt, gentity_t* pOther);
 void SV_Trace( trace_t *results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int contentmask, qboolean cylinder, qboolean traceDeep );
 void SV_TraceDeep( trace_t *results, const vec3_t vStart, const vec3_t vEnd, int iBrushMask, gentity_t *touch );
@@ -632,6 +660,17 @@ void SV_NET_UpdateClientNetProfileInfo(netprofclient_t* netprofile, int rate);
 void SV_NET_UpdateAllNetProfileInfo();
 void SV_NET_CalcTotalNetProfile(netprofclient_t* netprofile, qboolean server);
 
+//
+// sv_bench.c
+//
+extern qboolean				sv_benchRunning;
+extern unsigned long long	sv_benchGameTime;		// microseconds in the game frames
+extern unsigned long long	sv_benchSnapshotTime;	// microseconds building and encoding snapshots
+
+void SV_Bench_f( void );
+void SV_RecordCmds_f( void );
+void SV_RecordUsercmd( client_t *cl, const usercmd_t *cmd );
+
 //
 // sv_gamespy.c
 //
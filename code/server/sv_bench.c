@@ -0,0 +1,640 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// sv_bench.c: Headless server benchmark
+//
+// svbench loads a map, connects clients that have no network connection and
+// runs a fixed number of server frames back to back. Each frame, every client
+// sends a client message carrying its next usercmds, built like the client
+// does and executed by SV_ExecuteClientMessage, so the usercmds go through
+// SV_UserMove and SV_ClientThink. The client acknowledges the last snapshot
+// and all reliable commands, so the snapshots are delta compressed like
+// they would be for a real client. The snapshots are built, encoded and
+// dropped by the netchan.
+//
+// The usercmds come from a file recorded with svrecordcmds, or from a
+// synthetic stream. Game bots can be added with sv_numbots as usual.
+//
+
+#include "server.h"
+
+#define BENCH_CMDFILE_ID		"UCMD"
+#define BENCH_CMDFILE_VERSION	1
+#define BENCH_CMDFILE_HEADER	8
+#define BENCH_CMD_SIZE			23
+
+#define BENCH_SYNTHETIC_CMDS	4096
+#define BENCH_SYNTHETIC_MSEC	16		// ~60 fps client
+
+#define BENCH_MAX_CLIENTS		MAX_CLIENTS
+
+typedef struct {
+	usercmd_t	cmd;
+	usereyes_t	eyes;
+} benchCmd_t;
+
+typedef struct {
+	client_t	*client;
+	int			nextCmd;
+	int			serverTime;
+	int			surplusMsec;	// usercmd time sent ahead of the server
+} benchClient_t;
+
+typedef enum {
+	BT_FRAME,
+	BT_USERCMDS,
+	BT_GAME,
+	BT_SNAPSHOT,
+	BT_NUM_TIMES
+} benchTime_t;
+
+static const char *benchTimeNames[ BT_NUM_TIMES ] = { "frame", "usercmds", "game", "snapshot" };
+
+qboolean			sv_benchRunning;
+unsigned long long	sv_benchGameTime;
+unsigned long long	sv_benchSnapshotTime;
+
+static fileHandle_t	sv_recordFile;
+static int			sv_recordClient;
+static int			sv_recordNumCmds;
+
+/*
+==================
+SV_BenchPutShort / SV_BenchPutFloat
+
+Little endian, whatever the platform
+==================
+*/
+static byte *SV_BenchPutShort( byte *p, int value ) {
+	p[ 0 ] = value & 0xFF;
+	p[ 1 ] = ( value >> 8 ) & 0xFF;
+	return p + 2;
+}
+
+static byte *SV_BenchPutFloat( byte *p, float value ) {
+	floatint_t fi;
+
+	fi.f = value;
+	p[ 0 ] = fi.ui & 0xFF;
+	p[ 1 ] = ( fi.ui >> 8 ) & 0xFF;
+	p[ 2 ] = ( fi.ui >> 16 ) & 0xFF;
+	p[ 3 ] = ( fi.ui >> 24 ) & 0xFF;
+	return p + 4;
+}
+
+static const byte *SV_BenchGetShort( const byte *p, int *value ) {
+	*value = (short)( p[ 0 ] | ( p[ 1 ] << 8 ) );
+	return p + 2;
+}
+
+static const byte *SV_BenchGetFloat( const byte *p, float *value ) {
+	floatint_t fi;
+
+	fi.ui = p[ 0 ] | ( p[ 1 ] << 8 ) | ( p[ 2 ] << 16 ) | ( (unsigned int)p[ 3 ] << 24 );
+	*value = fi.f;
+	return p + 4;
+}
+
+/*
+==================
+SV_BenchWriteCmd
+==================
+*/
+static void SV_BenchWriteCmd( byte *p, const usercmd_t *cmd, const usereyes_t *eyes ) {
+	int i;
+
+	*p++ = cmd->msec;
+	p = SV_BenchPutShort( p, cmd->buttons );
+	for ( i = 0; i < 3; i++ ) {
+		p = SV_BenchPutShort( p, cmd->angles[ i ] );
+	}
+	*p++ = (byte)cmd->forwardmove;
+	*p++ = (byte)cmd->rightmove;
+	*p++ = (byte)cmd->upmove;
+	for ( i = 0; i < 3; i++ ) {
+		*p++ = (byte)eyes->ofs[ i ];
+	}
+	for ( i = 0; i < 2; i++ ) {
+		p = SV_BenchPutFloat( p, eyes->angles[ i ] );
+	}
+}
+
+/*
+==================
+SV_BenchReadCmd
+==================
+*/
+static void SV_BenchReadCmd( const byte *p, benchCmd_t *out ) {
+	int i, value;
+
+	Com_Memset( out, 0, sizeof( *out ) );
+
+	out->cmd.msec = *p++;
+	p = SV_BenchGetShort( p, &value );
+	out->cmd.buttons = value;
+	for ( i = 0; i < 3; i++ ) {
+		p = SV_BenchGetShort( p, &value );
+		out->cmd.angles[ i ] = value;
+	}
+	out->cmd.forwardmove = (signed char)*p++;
+	out->cmd.rightmove = (signed char)*p++;
+	out->cmd.upmove = (signed char)*p++;
+	for ( i = 0; i < 3; i++ ) {
+		out->eyes.ofs[ i ] = (signed char)*p++;
+	}
+	for ( i = 0; i < 2; i++ ) {
+		p = SV_BenchGetFloat( p, &out->eyes.angles[ i ] );
+	}
+}
+
+/*
+==================
+SV_RecordUsercmd
+
+Called by SV_ClientThink
+==================
+*/
+void SV_RecordUsercmd( client_t *cl, const usercmd_t *cmd ) {
+	byte buffer[ BENCH_CMD_SIZE ];
+
+	if ( !sv_recordFile || cl - svs.clients != sv_recordClient ) {
+		return;
+	}
+
+	SV_BenchWriteCmd( buffer, cmd, &cl->lastEyeinfo );
+	FS_Write( buffer, sizeof( buffer ), sv_recordFile );
+	sv_recordNumCmds++;
+}
+
+/*
+==================
+SV_RecordCmds_f
+
+svrecordcmds <clientnum> <filename> | stop
+==================
+*/
+void SV_RecordCmds_f( void ) {
+	byte	header[ BENCH_CMDFILE_HEADER ];
+	int		clientNum;
+
+	if ( Cmd_Argc() == 2 && !Q_stricmp( Cmd_Argv( 1 ), "stop" ) ) {
+		if ( !sv_recordFile ) {
+			Com_Printf( "Not recording usercmds\n" );
+			return;
+		}
+
+		FS_FCloseFile( sv_recordFile );
+		sv_recordFile = 0;
+		Com_Printf( "Recorded %i usercmds\n", sv_recordNumCmds );
+		return;
+	}
+
+	if ( Cmd_Argc() != 3 ) {
+		Com_Printf( "Usage: svrecordcmds <clientnum> <filename> | stop\n" );
+		Com_Printf( "Records the usercmds of a client, to be replayed by svbench.\n" );
+		return;
+	}
+
+	if ( !com_sv_running->integer ) {
+		Com_Printf( "Server is not running.\n" );
+		return;
+	}
+
+	clientNum = atoi( Cmd_Argv( 1 ) );
+	if ( clientNum < 0 || clientNum >= sv_maxclients->integer || svs.clients[ clientNum ].state != CS_ACTIVE ) {
+		Com_Printf( "Client %i is not active\n", clientNum );
+		return;
+	}
+
+	if ( sv_recordFile ) {
+		FS_FCloseFile( sv_recordFile );
+	}
+
+	sv_recordFile = FS_FOpenFileWrite( Cmd_Argv( 2 ) );
+	if ( !sv_recordFile ) {
+		Com_Printf( "Couldn't open %s for writing\n", Cmd_Argv( 2 ) );
+		return;
+	}
+
+	memcpy( header, BENCH_CMDFILE_ID, 4 );
+	SV_BenchPutShort( header + 4, BENCH_CMDFILE_VERSION );
+	SV_BenchPutShort( header + 6, 0 );
+	FS_Write( header, sizeof( header ), sv_recordFile );
+
+	sv_recordClient = clientNum;
+	sv_recordNumCmds = 0;
+	Com_Printf( "Recording the usercmds of %s to %s\n", svs.clients[ clientNum ].name, Cmd_Argv( 2 ) );
+}
+
+/*
+==================
+SV_BenchLoadCmds
+
+Returns the number of usercmds, 0 if the file is invalid
+==================
+*/
+static int SV_BenchLoadCmds( const char *filename, benchCmd_t **cmds ) {
+	byte	*buffer;
+	long	length;
+	int		version;
+	int		count;
+	int		i;
+
+	length = FS_ReadFile( filename, (void **)&buffer );
+	if ( length < 0 || !buffer ) {
+		Com_Printf( "Couldn't read %s\n", filename );
+		return 0;
+	}
+
+	// the header must be there before the version is read
+	if ( length < BENCH_CMDFILE_HEADER || memcmp( buffer, BENCH_CMDFILE_ID, 4 ) ) {
+		version = -1;
+	} else {
+		SV_BenchGetShort( buffer + 4, &version );
+	}
+
+	if ( version != BENCH_CMDFILE_VERSION ) {
+		Com_Printf( "%s is not a usercmd recording\n", filename );
+		FS_FreeFile( buffer );
+		return 0;
+	}
+
+	count = ( length - BENCH_CMDFILE_HEADER ) / BENCH_CMD_SIZE;
+	if ( !count ) {
+		Com_Printf( "%s has no usercmd\n", filename );
+		FS_FreeFile( buffer );
+		return 0;
+	}
+
+	*cmds = Z_Malloc( sizeof( benchCmd_t ) * count );
+	for ( i = 0; i < count; i++ ) {
+		SV_BenchReadCmd( buffer + BENCH_CMDFILE_HEADER + i * BENCH_CMD_SIZE, &( *cmds )[ i ] );
+	}
+
+	FS_FreeFile( buffer );
+	return count;
+}
+
+/*
+==================
+SV_BenchSyntheticCmds
+
+Runs around, turns, strafes and fires, always the same way
+==================
+*/
+static int SV_BenchSyntheticCmds( benchCmd_t **cmds ) {
+	benchCmd_t		*out;
+	unsigned int	seed;
+	float			yaw, yawSpeed;
+	int				forward, right;
+	int				i;
+
+	*cmds = Z_Malloc( sizeof( benchCmd_t ) * BENCH_SYNTHETIC_CMDS );
+
+	seed = 0x5eed;
+	yaw = 0;
+	yawSpeed = 0;
+	forward = 127;
+	right = 0;
+
+	for ( i = 0; i < BENCH_SYNTHETIC_CMDS; i++ ) {
+		out = &( *cmds )[ i ];
+		Com_Memset( out, 0, sizeof( *out ) );
+
+		if ( !( i % 60 ) ) {
+			seed = seed * 1103515245 + 12345;
+			forward = ( seed >> 16 ) & 1 ? 127 : 64;
+			right = ( int )( ( seed >> 17 ) % 3 ) * 127 - 127;
+			yawSpeed = ( float )( ( seed >> 20 ) % 9 ) - 4.0f;
+		}
+
+		yaw = AngleMod( yaw + yawSpeed );
+
+		out->cmd.msec = BENCH_SYNTHETIC_MSEC;
+		out->cmd.buttons = BUTTON_RUN;
+		if ( i % 90 < 10 ) {
+			// also respawns dead players
+			out->cmd.buttons |= BUTTON_ATTACKLEFT;
+		}
+		out->cmd.angles[ YAW ] = ANGLE2SHORT( yaw );
+		out->cmd.forwardmove = forward;
+		out->cmd.rightmove = right;
+		out->eyes.ofs[ 2 ] = 82;
+		out->eyes.angles[ 1 ] = yaw;
+	}
+
+	return BENCH_SYNTHETIC_CMDS;
+}
+
+/*
+==================
+SV_BenchClientPacket
+
+Sends the usercmds of one server frame, like CL_WritePacket.
+The usercmds rarely add up to the frame time, what goes past it
+is taken from the next frame so the clients keep the server pace.
+==================
+*/
+static void SV_BenchClientPacket( benchClient_t *bc, const benchCmd_t *cmds, int numCmds, int frameMsec ) {
+	byte		buffer[ MAX_MSGLEN ];
+	msg_t		msg;
+	client_t	*cl;
+	usercmd_t	packetCmds[ MAX_PACKET_USERCMDS ];
+	usercmd_t	nullcmd;
+	usercmd_t	*oldcmd;
+	usereyes_t	eyes;
+	int			messageAcknowledge;
+	int			count, msec, budget;
+	int			key;
+	int			i;
+
+	cl = bc->client;
+
+	if ( cl->state != CS_ACTIVE ) {
+		return;
+	}
+
+	budget = frameMsec - bc->surplusMsec;
+	if ( budget <= 0 ) {
+		// already ahead by a whole frame
+		bc->surplusMsec -= frameMsec;
+		return;
+	}
+
+	count = 0;
+	msec = 0;
+	while ( count < MAX_PACKET_USERCMDS && msec < budget ) {
+		const benchCmd_t *src = &cmds[ bc->nextCmd ];
+
+		bc->nextCmd = ( bc->nextCmd + 1 ) % numCmds;
+
+		packetCmds[ count ] = src->cmd;
+		if ( !packetCmds[ count ].msec ) {
+			packetCmds[ count ].msec = 1;
+		}
+		bc->serverTime += packetCmds[ count ].msec;
+		msec += packetCmds[ count ].msec;
+		packetCmds[ count ].serverTime = bc->serverTime;
+		eyes = src->eyes;
+		count++;
+	}
+
+	// a client that hit the usercmd limit doesn't catch up later
+	bc->surplusMsec = Q_max( msec - budget, 0 );
+
+	// acknowledge the last snapshot and all the reliable commands
+	messageAcknowledge = cl->netchan.outgoingSequence - 1;
+	if ( messageAcknowledge < 0 ) {
+		messageAcknowledge = 0;
+	}
+
+	MSG_Init( &msg, buffer, sizeof( buffer ) );
+	MSG_Bitstream( &msg );
+
+	MSG_WriteLong( &msg, sv.serverId );
+	MSG_WriteLong( &msg, messageAcknowledge );
+	MSG_WriteLong( &msg, cl->reliableSequence );
+
+	MSG_WriteByte( &msg, clc_move );
+	MSG_WriteByte( &msg, count );
+	MSG_WriteDeltaEyeInfo( &msg, &cl->lastEyeinfo, &eyes );
+
+	key = sv.checksumFeed;
+	key ^= messageAcknowledge;
+	key ^= MSG_HashKey( cl->reliableCommands[ cl->reliableSequence & ( MAX_RELIABLE_COMMANDS - 1 ) ], 32 );
+
+	Com_Memset( &nullcmd, 0, sizeof( nullcmd ) );
+	oldcmd = &nullcmd;
+	for ( i = 0; i < count; i++ ) {
+		MSG_WriteDeltaUsercmdKey( &msg, key, oldcmd, &packetCmds[ i ] );
+		oldcmd = &packetCmds[ i ];
+	}
+
+	MSG_WriteByte( &msg, clc_EOF );
+
+	MSG_BeginReading( &msg );
+	cl->lastPacketTime = svs.time;
+	SV_ExecuteClientMessage( cl, &msg );
+}
+
+/*
+==================
+SV_BenchCompareTimes
+==================
+*/
+static int SV_BenchCompareTimes( const void *a, const void *b ) {
+	const unsigned int timeA = *( const unsigned int * )a;
+	const unsigned int timeB = *( const unsigned int * )b;
+
+	if ( timeA != timeB ) {
+		return timeA < timeB ? -1 : 1;
+	}
+
+	return 0;
+}
+
+/*
+==================
+SV_BenchPrintTimes
+==================
+*/
+static void SV_BenchPrintTimes( const char *name, unsigned int *times, int count ) {
+	unsigned long long total;
+	int i;
+
+	total = 0;
+	for ( i = 0; i < count; i++ ) {
+		total += times[ i ];
+	}
+
+	qsort( times, count, sizeof( times[ 0 ] ), SV_BenchCompareTimes );
+
+	Com_Printf(
+		"%-10s %8.3f %8.3f %8.3f %8.3f %8.3f\n",
+		name,
+		total / 1000.0 / count,
+		times[ ( count - 1 ) * 50 / 100 ] / 1000.0,
+		times[ ( count - 1 ) * 95 / 100 ] / 1000.0,
+		times[ ( count - 1 ) * 99 / 100 ] / 1000.0,
+		times[ count - 1 ] / 1000.0
+	);
+}
+
+/*
+==================
+SV_Bench_f
+
+svbench <map> <frames> <clients> [cmdfile]
+==================
+*/
+void SV_Bench_f( void ) {
+	static benchCmd_t	*cmds;
+	static unsigned int	*times[ BT_NUM_TIMES ];
+	benchClient_t		clients[ BENCH_MAX_CLIENTS ];
+	char				mapname[ MAX_QPATH ];
+	char				cmdfile[ MAX_QPATH ];
+	unsigned long long	frameStart, start;
+	int					numFrames, numClients, numCmds;
+	int					frameMsec;
+	int					overBudget;
+	int					frame;
+	int					i;
+
+	if ( Cmd_Argc() < 4 ) {
+		Com_Printf( "Usage: svbench <map> <frames> <clients> [cmdfile]\n" );
+		Com_Printf( "Runs the map for a number of frames with clients replaying the usercmds\n" );
+		Com_Printf( "recorded by svrecordcmds, or synthetic ones. sv_numbots adds game bots.\n" );
+		return;
+	}
+
+	Q_strncpyz( mapname, Cmd_Argv( 1 ), sizeof( mapname ) );
+	numFrames = atoi( Cmd_Argv( 2 ) );
+	numClients = atoi( Cmd_Argv( 3 ) );
+	Q_strncpyz( cmdfile, Cmd_Argc() > 4 ? Cmd_Argv( 4 ) : "", sizeof( cmdfile ) );
+
+	if ( numFrames < 1 || numClients < 0 ) {
+		Com_Printf( "Invalid frame or client count\n" );
+		return;
+	}
+
+	numClients = Q_min( numClients, BENCH_MAX_CLIENTS );
+
+	// left over if the previous run was interrupted by an error
+	sv_benchRunning = qfalse;
+	if ( cmds ) {
+		Z_Free( cmds );
+		cmds = NULL;
+	}
+	for ( i = 0; i < BT_NUM_TIMES; i++ ) {
+		if ( times[ i ] ) {
+			Z_Free( times[ i ] );
+			times[ i ] = NULL;
+		}
+	}
+
+	if ( *cmdfile ) {
+		numCmds = SV_BenchLoadCmds( cmdfile, &cmds );
+		if ( !numCmds ) {
+			return;
+		}
+	} else {
+		numCmds = SV_BenchSyntheticCmds( &cmds );
+	}
+
+	// the map command tokenizes again
+	Cbuf_ExecuteText( EXEC_NOW, va( "map %s\n", mapname ) );
+
+	if ( !com_sv_running->integer ) {
+		Com_Printf( "svbench: couldn't load %s\n", mapname );
+		return;
+	}
+
+	for ( i = 0; i < numClients; i++ ) {
+		clients[ i ].client = SV_ConnectBenchClient( va( "bench%i", i ) );
+		if ( !clients[ i ].client ) {
+			Com_Printf( "svbench: only %i clients could connect, raise sv_maxclients\n", i );
+			numClients = i;
+			break;
+		}
+		// don't replay the same usercmds at the same time
+		clients[ i ].nextCmd = ( int )( ( long long )numCmds * i / Q_max( numClients, 1 ) );
+		clients[ i ].serverTime = svs.time;
+		clients[ i ].surplusMsec = 0;
+	}
+
+	SV_ServerLoaded();
+
+	for ( i = 0; i < BT_NUM_TIMES; i++ ) {
+		times[ i ] = Z_Malloc( sizeof( unsigned int ) * numFrames );
+	}
+
+	if ( sv_fps->integer < 1 ) {
+		Cvar_Set( "sv_fps", "20" );
+	}
+	frameMsec = Q_max( 1000 / sv_fps->integer, 1 );
+	overBudget = 0;
+
+	Com_Printf( "svbench: %i frames of %s with %i clients, %s\n", numFrames, mapname, numClients, *cmdfile ? cmdfile : "synthetic usercmds" );
+
+	sv_benchRunning = qtrue;
+
+	for ( frame = 0; frame < numFrames; frame++ ) {
+		frameStart = Sys_Microseconds();
+
+		for ( i = 0; i < numClients; i++ ) {
+			SV_BenchClientPacket( &clients[ i ], cmds, numCmds, frameMsec );
+		}
+
+		times[ BT_USERCMDS ][ frame ] = ( unsigned int )( Sys_Microseconds() - frameStart );
+
+		sv_benchGameTime = 0;
+		sv_benchSnapshotTime = 0;
+		SV_Frame( frameMsec );
+
+		if ( !com_sv_running->integer ) {
+			Com_Printf( "svbench: the server stopped after %i frames\n", frame );
+			break;
+		}
+
+		// the fragments would be sent while the server is idle
+		start = Sys_Microseconds();
+		for ( i = 0; i < numClients; i++ ) {
+			while ( clients[ i ].client->netchan.unsentFragments ) {
+				SV_Netchan_TransmitNextFragment( clients[ i ].client );
+			}
+		}
+		sv_benchSnapshotTime += Sys_Microseconds() - start;
+
+		times[ BT_GAME ][ frame ] = ( unsigned int )sv_benchGameTime;
+		times[ BT_SNAPSHOT ][ frame ] = ( unsigned int )sv_benchSnapshotTime;
+		times[ BT_FRAME ][ frame ] = ( unsigned int )( Sys_Microseconds() - frameStart );
+
+		if ( times[ BT_FRAME ][ frame ] > ( unsigned int )frameMsec * 1000 ) {
+			overBudget++;
+		}
+	}
+
+	sv_benchRunning = qfalse;
+
+	if ( frame ) {
+		Com_Printf( "svbench: %i frames, %i over the %i ms budget\n", frame, overBudget, frameMsec );
+		Com_Printf( "(ms)            avg      p50      p95      p99      max\n" );
+		for ( i = 0; i < BT_NUM_TIMES; i++ ) {
+			SV_BenchPrintTimes( benchTimeNames[ i ], times[ i ], frame );
+		}
+	}
+
+	if ( com_sv_running->integer ) {
+		for ( i = 0; i < numClients; i++ ) {
+			if ( clients[ i ].client->state >= CS_CONNECTED ) {
+				SV_DropClient( clients[ i ].client, "benchmark finished" );
+			}
+		}
+	}
+
+	Z_Free( cmds );
+	cmds = NULL;
+	for ( i = 0; i < BT_NUM_TIMES; i++ ) {
+		Z_Free( times[ i ] );
+		times[ i ] = NULL;
+	}
+}
@@ -21,6 +21,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
 #include "server.h"
+#include "../qcommon/iptrie.h"
 
 #ifndef DEDICATED
 #    include "../client/client.h"
@@ -569,6 +570,136 @@ static void SV_BanNum_f( void ) {
 }
 #endif
 
+//
+// Added in OPM
+//  The ban list can hold community blocklists with hundreds of thousands of ranges,
+//  so it grows as needed and connecting addresses are matched against a prefix trie
+//  of the bans and one of the exceptions, rebuilt whenever the list changes.
+//
+
+static int serverBansMax;
+static ipTrie_t sv_banTries[2]; // bans, exceptions
+
+/*
+==================
+SV_BanAlloc
+==================
+*/
+static void *SV_BanAlloc(size_t size)
+{
+	return Z_Malloc(size);
+}
+
+/*
+==================
+SV_InitBans
+==================
+*/
+void SV_InitBans(void)
+{
+	if(sv_banTries[0].alloc)
+		return;
+
+	IPTrie_Init(&sv_banTries[0], SV_BanAlloc, Z_Free);
+	IPTrie_Init(&sv_banTries[1], SV_BanAlloc, Z_Free);
+}
+
+/*
+==================
+SV_BanAddress
+
+Family and bytes of an address for the ban tries
+==================
+*/
+static qboolean SV_BanAddress(const netadr_t *adr, ipTrieFamily_t *family, const byte **addr)
+{
+	if(adr->type == NA_IP)
+	{
+		*family = IPTRIE_IPV4;
+		*addr = adr->ip;
+		return qtrue;
+	}
+	
+	if(adr->type == NA_IP6)
+	{
+		*family = IPTRIE_IPV6;
+		*addr = adr->ip6;
+		return qtrue;
+	}
+	
+	return qfalse;
+}
+
+/*
+==================
+SV_RebuildBanTries
+==================
+*/
+static void SV_RebuildBanTries(void)
+{
+	int index;
+	serverBan_t *curban;
+	ipTrieFamily_t family;
+	const byte *addr;
+	
+	IPTrie_Clear(&sv_banTries[0]);
+	IPTrie_Clear(&sv_banTries[1]);
+	
+	for(index = 0; index < serverBansCount; index++)
+	{
+		curban = &serverBans[index];
+		
+		if(SV_BanAddress(&curban->ip, &family, &addr))
+			IPTrie_Insert(&sv_banTries[curban->isexception ? 1 : 0], family, addr, curban->subnet, index);
+	}
+}
+
+/*
+==================
+SV_FindBan
+
+Index of the most specific ban or exception containing the address, -1 if there is none
+==================
+*/
+int SV_FindBan(const netadr_t *from, qboolean isexception)
+{
+	ipTrieFamily_t family;
+	const byte *addr;
+	
+	if(!SV_BanAddress(from, &family, &addr))
+		return -1;
+	
+	return IPTrie_Lookup(&sv_banTries[isexception ? 1 : 0], family, addr);
+}
+
+/*
+==================
+SV_AllocBanEntry
+
+Append an entry to the ban list
+==================
+*/
+static serverBan_t *SV_AllocBanEntry(void)
+{
+	serverBan_t *bans;
+	
+	if(serverBansCount >= serverBansMax)
+	{
+		serverBansMax = serverBansMax ? serverBansMax * 2 : 1024;
+		bans = Z_Malloc(serverBansMax * sizeof(*bans));
+		
+		if(serverBans)
+		{
+			Com_Memcpy(bans, serverBans, serverBansCount * sizeof(*bans));
+			Z_Free(serverBans);
+		}
+		
+		serverBans = bans;
+	}
+	
+	return &serverBans[serverBansCount++];
+}
+
 /*
 ==================
 SV_RehashBans_f
@@ -578,10 +709,12 @@ Load saved bans from file.
 */
 static void SV_RehashBans_f(void)
 {
-	int index, filelen;
+	int filelen;
 	fileHandle_t readfrom;
 	char *textbuf, *curpos, *maskpos, *newlinepos, *endpos;
 	char filepath[MAX_QPATH];
+	netadr_t ip;
+	serverBan_t *curban;
 	
 	// make sure server is running
 	if ( !com_sv_running->integer ) {
@@ -589,6 +722,7 @@ static void SV_RehashBans_f(void)
 	}
 	
 	serverBansCount = 0;
+	SV_RebuildBanTries();
 	
 	if(!sv_banFile->string || !*sv_banFile->string)
 		return;
@@ -611,7 +745,7 @@ static void SV_RehashBans_f(void)
 		
 		endpos = textbuf + filelen;
 		
-		for(index = 0; index < SERVER_MAXBANS && curpos + 2 < endpos; index++)
+		while(curpos + 2 < endpos)
 		{
 			// find the end of the address string
 			for(maskpos = curpos + 2; maskpos < endpos && *maskpos != ' '; maskpos++);
@@ -630,29 +764,31 @@ static void SV_RehashBans_f(void)
 			
 			*newlinepos = '\0';
 			
-			if(NET_StringToAdr(curpos + 2, &serverBans[index].ip, NA_UNSPEC))
+			if(NET_StringToAdr(curpos + 2, &ip, NA_UNSPEC))
 			{
-				serverBans[index].isexception = (curpos[0] != '0');
-				serverBans[index].subnet = atoi(maskpos);
+				curban = SV_AllocBanEntry();
+				curban->ip = ip;
+				curban->isexception = (curpos[0] != '0');
+				curban->subnet = atoi(maskpos);
 				
-				if(serverBans[index].ip.type == NA_IP &&
-				   (serverBans[index].subnet < 1 || serverBans[index].subnet > 32))
+				if(curban->ip.type == NA_IP &&
+				   (curban->subnet < 1 || curban->subnet > 32))
 				{
-					serverBans[index].subnet = 32;
+					curban->subnet = 32;
 				}
-				else if(serverBans[index].ip.type == NA_IP6 &&
-					(serverBans[index].subnet < 1 || serverBans[index].subnet > 128))
+				else if(curban->ip.type == NA_IP6 &&
+					(curban->subnet < 1 || curban->subnet > 128))
 				{
-					serverBans[index].subnet = 128;
+					curban->subnet = 128;
 				}
 			}
 			
 			curpos = newlinepos + 1;
 		}
-			
-		serverBansCount = index;
 		
 		Z_Free(textbuf);
+		
+		SV_RebuildBanTries();
 	}
 }
 
@@ -704,7 +840,7 @@ static qboolean SV_DelBanEntryFromList(int index)
 {
 	if(index == serverBansCount - 1)
 		serverBansCount--;
-	else if(index < ARRAY_LEN(serverBans) - 1)
+	else if(index < serverBansCount - 1)
 	{
 		memmove(serverBans + index, serverBans + index + 1, (serverBansCount - index - 1) * sizeof(*serverBans));
 		serverBansCount--;
@@ -790,12 +926,6 @@ static void SV_AddBanToList(qboolean isexception)
 		return;
 	}
 
-	if(serverBansCount >= ARRAY_LEN(serverBans))
-	{
-		Com_Printf ("Error: Maximum number of bans/exceptions exceeded.\n");
-		return;
-	}
-
 	banstring = Cmd_Argv(1);
 	
 	if(strchr(banstring, '.') || strchr(banstring, ':'))
@@ -892,12 +1022,12 @@ static void SV_AddBanToList(qboolean isexception)
 			index++;
 	}
 
-	serverBans[serverBansCount].ip = ip;
-	serverBans[serverBansCount].subnet = mask;
-	serverBans[serverBansCount].isexception = isexception;
-	
-	serverBansCount++;
+	curban = SV_AllocBanEntry();
+	curban->ip = ip;
+	curban->subnet = mask;
+	curban->isexception = isexception;
 	
+	SV_RebuildBanTries();
 	SV_WriteBans();
 
 	Com_Printf("Added %s: %s/%d\n", isexception ? "ban exception" : "ban",
@@ -992,9 +1122,300 @@ static void SV_DelBanFromList(qboolean isexception)
 		}
 	}
 	
+	SV_RebuildBanTries();
 	SV_WriteBans();
 }
 
+/*
+==================
+SV_ParseNumericIPv4
+
+Dotted quad, without any name lookup
+==================
+*/
+
+static qboolean SV_ParseNumericIPv4(const char *s, byte *out)
+{
+	int i, value, digits;
+
+	for(i = 0; i < 4; i++)
+	{
+		if(i > 0)
+		{
+			if(*s != '.')
+				return qfalse;
+			s++;
+		}
+
+		value = digits = 0;
+		while(*s >= '0' && *s <= '9')
+		{
+			value = value * 10 + *s - '0';
+			s++;
+
+			if(++digits > 3)
+				return qfalse;
+		}
+
+		if(!digits || value > 255)
+			return qfalse;
+
+		out[i] = value;
+	}
+
+	return *s == '\0';
+}
+
+/*
+==================
+SV_ParseNumericIPv6
+
+Colon separated hex groups, with at most one :: and an optional dotted quad at the end,
+without any name lookup
+==================
+*/
+
+static qboolean SV_ParseNumericIPv6(const char *s, byte *out)
+{
+	byte groups[16];
+	int count, gap, value, digits;
+
+	count = 0;
+	gap = -1;
+
+	if(s[0] == ':')
+	{
+		if(s[1] != ':')
+			return qfalse;
+
+		gap = 0;
+		s += 2;
+	}
+
+	while(*s)
+	{
+		if(count >= 16)
+			return qfalse;
+
+		// the last group can be a dotted quad
+		if(strchr(s, '.') && !strchr(s, ':'))
+		{
+			if(count > 12 || !SV_ParseNumericIPv4(s, groups + count))
+				return qfalse;
+
+			count += 4;
+			break;
+		}
+
+		value = digits = 0;
+		for(;; s++)
+		{
+			if(*s >= '0' && *s <= '9')
+				value = value * 16 + *s - '0';
+			else if(*s >= 'a' && *s <= 'f')
+				value = value * 16 + *s - 'a' + 10;
+			else if(*s >= 'A' && *s <= 'F')
+				value = value * 16 + *s - 'A' + 10;
+			else
+				break;
+
+			if(++digits > 4)
+				return qfalse;
+		}
+
+		if(!digits)
+			return qfalse;
+
+		groups[count++] = value >> 8;
+		groups[count++] = value & 0xFF;
+
+		if(!*s)
+			break;
+
+		if(*s != ':')
+			return qfalse;
+		s++;
+
+		if(*s == ':')
+		{
+			if(gap >= 0)
+				return qfalse;
+
+			gap = count;
+			s++;
+		}
+		else if(!*s)
+			return qfalse;
+	}
+
+	if(gap < 0)
+	{
+		if(count != 16)
+			return qfalse;
+
+		Com_Memcpy(out, groups, 16);
+		return qtrue;
+	}
+
+	// :: stands for one group at least
+	if(count > 14)
+		return qfalse;
+
+	Com_Memset(out, 0, 16);
+	Com_Memcpy(out, groups, gap);
+	Com_Memcpy(out + 16 - (count - gap), groups + gap, count - gap);
+
+	return qtrue;
+}
+
+/*
+==================
+SV_ParseNumericCIDR
+
+Like SV_ParseCIDRNotation, but only numeric addresses are accepted so that
+nothing goes through a name lookup, and an invalid subnet is an error
+==================
+*/
+
+static qboolean SV_ParseNumericCIDR(netadr_t *dest, int *mask, char *adrstr)
+{
+	char *suffix;
+	int maxbits;
+	
+	suffix = strchr(adrstr, '/');
+	if(suffix)
+	{
+		*suffix = '\0';
+		suffix++;
+	}
+
+	Com_Memset(dest, 0, sizeof(*dest));
+
+	if(SV_ParseNumericIPv4(adrstr, dest->ip))
+	{
+		dest->type = NA_IP;
+		maxbits = 32;
+	}
+	else if(SV_ParseNumericIPv6(adrstr, dest->ip6))
+	{
+		dest->type = NA_IP6;
+		maxbits = 128;
+	}
+	else
+		return qtrue;
+
+	if(!suffix)
+	{
+		*mask = maxbits;
+		return qfalse;
+	}
+
+	if(!*suffix || strlen(suffix) > 3 || strspn(suffix, "0123456789") != strlen(suffix))
+		return qtrue;
+
+	*mask = atoi(suffix);
+
+	return *mask < 1 || *mask > maxbits;
+}
+
+/*
+==================
+SV_ImportBans_f
+
+Added in OPM
+Append a blocklist file to the bans or to the exceptions, with one ip[/subnet]
+per line. Empty lines and comments starting with # or ; are skipped.
+==================
+*/
+
+static void SV_ImportBans_f(void)
+{
+	int filelen, mask, count, duplicates, invalid;
+	fileHandle_t readfrom;
+	char *textbuf, *curpos, *lineend;
+	char filepath[MAX_QPATH];
+	netadr_t ip;
+	qboolean isexception;
+	ipTrie_t *trie;
+	ipTrieFamily_t family;
+	const byte *addr;
+	serverBan_t *curban;
+
+	// make sure server is running
+	if ( !com_sv_running->integer ) {
+		Com_Printf( "Server is not running.\n" );
+		return;
+	}
+	
+	if(Cmd_Argc() < 2 || Cmd_Argc() > 3)
+	{
+		Com_Printf ("Usage: %s <file> [exceptions]\n", Cmd_Argv(0));
+		return;
+	}
+
+	isexception = Cmd_Argc() == 3 && atoi(Cmd_Argv(2));
+	trie = &sv_banTries[isexception ? 1 : 0];
+
+	Com_sprintf(filepath, sizeof(filepath), "%s/%s", FS_GetCurrentGameDir(), Cmd_Argv(1));
+
+	filelen = FS_SV_FOpenFileRead(filepath, &readfrom);
+	if(filelen < 0)
+	{
+		Com_Printf("Error: Couldn't open %s\n", filepath);
+		return;
+	}
+
+	// zero filled, so the text is terminated
+	textbuf = Z_Malloc(filelen + 1);
+	
+	FS_Read(textbuf, filelen, readfrom);
+	FS_FCloseFile(readfrom);
+	
+	count = duplicates = invalid = 0;
+
+	for(curpos = textbuf; *curpos; curpos = lineend)
+	{
+		for(lineend = curpos; *lineend && *lineend != '\n'; lineend++);
+		
+		if(*lineend)
+			*lineend++ = '\0';
+		
+		// only keep the first word of the line
+		curpos += strspn(curpos, " \t");
+		curpos[strcspn(curpos, " \t\r#;")] = '\0';
+		
+		if(!*curpos)
+			continue;
+		
+		if(SV_ParseNumericCIDR(&ip, &mask, curpos) || !SV_BanAddress(&ip, &family, &addr))
+		{
+			invalid++;
+			continue;
+		}
+		
+		if(IPTrie_Find(trie, family, addr, mask) != -1)
+		{
+			duplicates++;
+			continue;
+		}
+		
+		curban = SV_AllocBanEntry();
+		curban->ip = ip;
+		curban->subnet = mask;
+		curban->isexception = isexception;
+		
+		IPTrie_Insert(trie, family, addr, mask, serverBansCount - 1);
+		count++;
+	}
+	
+	Z_Free(textbuf);
+	
+	if(count)
+		SV_WriteBans();
+	
+	Com_Printf("Imported %d %s from %s (%d duplicates, %d invalid lines)\n",
+		   count, isexception ? "exceptions" : "bans", filepath, duplicates, invalid);
+}
 
 /*
 ==================
@@ -1058,6 +1479,7 @@ static void SV_FlushBans_f(void)
 	}
 
 	serverBansCount = 0;
+	SV_RebuildBanTries();
 	
 	// empty the ban file.
 	SV_WriteBans();
@@ -1850,6 +2272,7 @@ void SV_AddOperatorCommands(void) {
 	Cmd_AddCommand("bandel", SV_BanDel_f);
 	Cmd_AddCommand("exceptdel", SV_ExceptDel_f);
 	Cmd_AddCommand("flushbans", SV_FlushBans_f);
+	Cmd_AddCommand("importbans", SV_ImportBans_f); // Added in OPM
 	
 	Cmd_AddCommand("difficultyEasy", SV_EasyMode_f);
 	Cmd_AddCommand("difficultyMedium", SV_MediumMode_f);
@@ -1859,6 +2282,9 @@ void SV_AddOperatorCommands(void) {
     Cmd_AddCommand("netprofiledump", SV_NetProfileDump_f);
 	// Added in 2.30
     Cmd_AddCommand("reloadmap", SV_ReloadMap_f);
+	// Added in OPM
+	Cmd_AddCommand("svbench", SV_Bench_f);
+	Cmd_AddCommand("svrecordcmds", SV_RecordCmds_f);
 
 	// Changed in 2.0
 	//  Set medium mode regardless of if the developer mode is set
@@ -201,9 +201,6 @@ Check whether a certain address is banned
 
 static qboolean SV_IsBanned(netadr_t *from, qboolean isexception)
 {
-	int index;
-	serverBan_t *curban;
-	
 	if(!isexception)
 	{
 		// If this is a query for a ban, first check whether the client is excepted
@@ -211,18 +208,9 @@ static qboolean SV_IsBanned(netadr_t *from, qboolean isexception)
 			return qfalse;
 	}
 	
-	for(index = 0; index < serverBansCount; index++)
-	{
-		curban = &serverBans[index];
-		
-		if(curban->isexception == isexception)
-		{
-			if(NET_CompareBaseAdrMask(curban->ip, *from, curban->subnet))
-				return qtrue;
-		}
-	}
-	
-	return qfalse;
+	// Added in OPM
+	//  Prefix trie lookup instead of going through the whole list
+	return SV_FindBan(from, isexception) != -1;
 }
 
 /*
@@ -768,6 +756,9 @@ static void SV_SendClientGameState( client_t *client ) {
 	Com_DPrintf( "Going from CS_CONNECTED to CS_PRIMED for %s\n", client->name );
 	client->state = CS_PRIMED;
 	client->pureAuthentic = 0;
+	// Added in OPM
+	//  the gamestate carries every configstring
+	SV_ClearPendingConfigstrings( client );
 	client->gotCP = qfalse;
 
 	// when we receive the first packet from the client, we will
@@ -868,6 +859,73 @@ void SV_ClientEnterWorld( client_t *client, usercmd_t *cmd ) {
 	}
 }
 
+/*
+==================
+SV_ConnectBenchClient
+
+Added in OPM
+Connects a client that has no network connection, used by svbench.
+Its packets are built by the server, and everything sent to it is dropped
+==================
+*/
+client_t *SV_ConnectBenchClient( const char *name ) {
+	char		userinfo[MAX_INFO_STRING];
+	client_t	*cl;
+	netadr_t	adr;
+	const char	*denied;
+	int			clientNum;
+
+	for ( clientNum = 0; clientNum < sv_maxclients->integer; clientNum++ ) {
+		if ( svs.clients[ clientNum ].state == CS_FREE ) {
+			break;
+		}
+	}
+
+	if ( clientNum == sv_maxclients->integer ) {
+		return NULL;
+	}
+
+	cl = &svs.clients[ clientNum ];
+	Com_Memset( cl, 0, sizeof( *cl ) );
+
+	Com_Memset( &adr, 0, sizeof( adr ) );
+	adr.type = NA_BOT;
+
+	userinfo[ 0 ] = 0;
+	Info_SetValueForKey( userinfo, "name", name );
+	Info_SetValueForKey( userinfo, "rate", "90000" );
+	Info_SetValueForKey( userinfo, "snaps", va( "%i", sv_fps->integer ) );
+	Info_SetValueForKey( userinfo, "fov", "80" );
+
+	cl->gentity = SV_GentityNum( clientNum );
+	Netchan_Setup( NS_SERVER, &cl->netchan, adr, clientNum, 0, qfalse );
+	cl->netchan_end_queue = &cl->netchan_start_queue;
+	Q_strncpyz( cl->userinfo, userinfo, sizeof( cl->userinfo ) );
+
+	denied = ge->ClientConnect( clientNum, qtrue, qfalse );
+	if ( denied ) {
+		Com_Printf( "Game rejected the benchmark client %s: %s\n", name, denied );
+		return NULL;
+	}
+
+	SV_UserinfoChanged( cl );
+
+	cl->state = CS_CONNECTED;
+	cl->lastPacketTime = svs.time;
+	cl->lastConnectTime = svs.time;
+	cl->gamestateMessageNum = -1;
+
+	SV_SendClientGameState( cl );
+
+	// there is no pure check to wait for
+	cl->pureAuthentic = 1;
+	cl->gotCP = qtrue;
+
+	SV_ClientEnterWorld( cl, NULL );
+
+	return cl;
+}
+
 /*
 ============================================================
 
@@ -1754,6 +1812,10 @@ void SV_ClientThink (client_t *cl, usercmd_t *cmd) {
 		return;		// may have been kicked during the last usercmd
 	}
 
+	// Added in OPM
+	//  svrecordcmds
+	SV_RecordUsercmd( cl, cmd );
+
 	ge->ClientThink( ( gentity_t * )SV_GentityNum( cl - svs.clients ), cmd, &cl->lastEyeinfo );
 
 	err = ge->errorMessage;
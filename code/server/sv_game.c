@@ -1911,6 +1911,9 @@ void SV_InitGameProgs( void ) {
 
 	// Added in OPM
 	import.pvssoundindex				= SV_PVSSoundIndex;
+	import.BeginTraceSession			= SV_BeginTraceSession;
+	import.EndTraceSession				= SV_EndTraceSession;
+	import.SightTraceConcurrent			= SV_SightTraceConcurrent;
 
 	ge = Sys_GetGameAPI( &import );
 
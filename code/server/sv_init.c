@@ -66,6 +66,103 @@ void SV_AddSvsTimeFixup( int *piTime )
 
 void SV_SendConfigstring( client_t *client, int index );
 
+/*
+===============
+SV_ConfigstringHash
+
+Case-insensitive hash matching Q_stricmp
+===============
+*/
+static unsigned int SV_ConfigstringHash( const char *s ) {
+	unsigned int	hash;
+	int				c;
+
+	// Added in OPM
+	hash = 2166136261u;
+	while ( *s ) {
+		c = *s++;
+		if ( c >= 'A' && c <= 'Z' ) {
+			c += 'a' - 'A';
+		}
+		hash = ( hash ^ (unsigned char)c ) * 16777619u;
+	}
+
+	return hash & ( CS_HASH_SIZE - 1 );
+}
+
+/*
+===============
+SV_LinkConfigstring
+
+Adds a non-empty configstring to the name index
+===============
+*/
+static void SV_LinkConfigstring( int index ) {
+	unsigned int hash;
+
+	// Added in OPM
+	if ( !sv.configstrings[ index ] || !sv.configstrings[ index ][ 0 ] ) {
+		return;
+	}
+
+	hash = SV_ConfigstringHash( sv.configstrings[ index ] );
+	sv.csHashValue[ index ] = hash;
+	sv.csHashNext[ index ] = sv.csHashHead[ hash ];
+	sv.csHashHead[ hash ] = index + 1;
+	sv.csUsedBits[ index >> 5 ] |= 1u << ( index & 31 );
+}
+
+/*
+===============
+SV_UnlinkConfigstring
+
+Removes a configstring from the name index
+===============
+*/
+static void SV_UnlinkConfigstring( int index ) {
+	unsigned short *link;
+
+	// Added in OPM
+	if ( !( sv.csUsedBits[ index >> 5 ] & ( 1u << ( index & 31 ) ) ) ) {
+		return;
+	}
+
+	for ( link = &sv.csHashHead[ sv.csHashValue[ index ] ]; *link; link = &sv.csHashNext[ *link - 1 ] ) {
+		if ( *link == index + 1 ) {
+			*link = sv.csHashNext[ index ];
+			break;
+		}
+	}
+
+	sv.csHashNext[ index ] = 0;
+	sv.csUsedBits[ index >> 5 ] &= ~( 1u << ( index & 31 ) );
+}
+
+/*
+===============
+SV_FirstEmptyConfigstring
+
+Returns the first empty configstring in [first, last), or last if there is none
+===============
+*/
+static int SV_FirstEmptyConfigstring( int first, int last ) {
+	int i;
+
+	// Added in OPM
+	for ( i = first; i < last; ) {
+		if ( !( i & 31 ) && sv.csUsedBits[ i >> 5 ] == 0xFFFFFFFF ) {
+			i += 32;
+			continue;
+		}
+		if ( !( sv.csUsedBits[ i >> 5 ] & ( 1u << ( i & 31 ) ) ) ) {
+			return i;
+		}
+		i++;
+	}
+
+	return last;
+}
+
 /*
 ===============
 SV_SetConfigstring
@@ -90,8 +187,10 @@ void SV_SetConfigstring (int index, const char *val) {
 	}
 
 	// change the string in sv
+	SV_UnlinkConfigstring( index );
 	Z_Free( sv.configstrings[index] );
 	sv.configstrings[index] = CopyString( val );
+	SV_LinkConfigstring( index );
 
 	// send it to all the clients if we aren't
 	// spawning a new server
@@ -108,9 +207,14 @@ void SV_SetConfigstring (int index, const char *val) {
 			if ( index == CS_SERVERINFO && client->gentity && (client->gentity->r.svFlags & SVF_NOSERVERINFO) ) {
 				continue;
 			}
-		
 
-			SV_SendConfigstring(client, index);
+			// Added in OPM
+			//  queue the update, it's sent with the next snapshot
+			//  or before the next reliable command to this client
+			if ( !client->csUpdated[ index ] ) {
+				client->csUpdated[ index ] = qtrue;
+				client->csPending[ client->numCsPending++ ] = index;
+			}
 		}
 	}
 }
@@ -145,8 +249,9 @@ SV_FindIndex
 ================
 */
 int SV_FindIndex( const char *name, int start, int max, qboolean create ) {
-	int		i;
-	char	*s;
+	int				i;
+	int				first, last, empty, found;
+	unsigned short	link;
 
 	if( !name || !name[ 0 ] ) {
 		return 0;
@@ -160,27 +265,39 @@ int SV_FindIndex( const char *name, int start, int max, qboolean create ) {
 		Com_Error( 1, "SV_FindIndex: bad max index %i\n", max );
 	}
 
-	for( i = 1; i<max; i++ ) {
-		s = sv.configstrings[ start + i ];
+	// Added in OPM
+	//  look the name up in the hash index instead of comparing
+	//  every string of the range. Like the linear scan, only slots
+	//  before the first empty one are considered
+	first = start + 1;
+	last = start + max;
+	empty = SV_FirstEmptyConfigstring( first, last );
+	found = 0;
 
-		if( !s || !s[ 0 ] ) {
-			break;
+	for( link = sv.csHashHead[ SV_ConfigstringHash( name ) ]; link; link = sv.csHashNext[ link - 1 ] ) {
+		i = link - 1;
+		if( i < first || i >= empty || ( found && i >= found ) ) {
+			continue;
 		}
-		if( !Q_stricmp( s, name ) ) {
-			return i;
+		if( !Q_stricmp( sv.configstrings[ i ], name ) ) {
+			found = i;
 		}
 	}
 
+	if( found ) {
+		return found - start;
+	}
+
 	if( !create ) {
 		return 0;
 	}
 
-	if( i == max ) {
+	if( empty == last ) {
 		Com_Error( 1, "SV_FindIndex: overflow  max%d create%d  name %s", max, create, name );
 	}
 
-	SV_SetConfigstring( start + i, name );
-	return i;
+	SV_SetConfigstring( empty, name );
+	return empty - start;
 }
 
 /*
@@ -329,6 +446,58 @@ void SV_UpdateConfigstrings(client_t *client)
 	}
 }
 
+/*
+===============
+SV_FlushConfigstrings
+
+Sends the configstrings queued by SV_SetConfigstring while the
+client was active, one update per changed index
+===============
+*/
+void SV_FlushConfigstrings( client_t *client )
+{
+	int i;
+	int index;
+	int count;
+
+	// Added in OPM
+	//  reset the queue first, SV_SendConfigstring goes through
+	//  SV_AddServerCommand which flushes it as well
+	count = client->numCsPending;
+	client->numCsPending = 0;
+
+	for( i = 0; i < count; i++ ) {
+		index = client->csPending[i];
+		client->csUpdated[index] = qfalse;
+
+		// do not always send server info to all clients
+		if ( index == CS_SERVERINFO && client->gentity &&
+			(client->gentity->r.svFlags & SVF_NOSERVERINFO) ) {
+			continue;
+		}
+		SV_SendConfigstring(client, index);
+	}
+}
+
+/*
+===============
+SV_ClearPendingConfigstrings
+
+Drops the queued configstrings, used when the whole
+gamestate is sent to the client
+===============
+*/
+void SV_ClearPendingConfigstrings( client_t *client )
+{
+	int i;
+
+	// Added in OPM
+	for( i = 0; i < client->numCsPending; i++ ) {
+		client->csUpdated[client->csPending[i]] = qfalse;
+	}
+	client->numCsPending = 0;
+}
+
 /*
 ===============
 SV_SetUserinfo
@@ -1108,6 +1277,7 @@ void SV_Init (void)
 	Cvar_Get( "g_ddayshingleguys", "0", CVAR_ARCHIVE );
 	
 	// Load saved bans
+	SV_InitBans();
 	Cbuf_AddText("rehashbans\n");
 
     if (com_gotOriginalConfig) {
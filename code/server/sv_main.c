@@ -80,7 +80,7 @@ cvar_t	*sv_strictAuth;
 #endif
 cvar_t	*sv_banFile;
 
-serverBan_t serverBans[SERVER_MAXBANS];
+serverBan_t *serverBans;
 int serverBansCount = 0;
 
 /*
@@ -158,6 +158,13 @@ not have future snapshot_t executed before it is executed
 void SV_AddServerCommand( client_t *client, const char *cmd ) {
 	int		index, i;
 
+	// Added in OPM
+	//  send queued configstrings first so they stay ordered
+	//  with the other reliable commands
+	if ( client->numCsPending ) {
+		SV_FlushConfigstrings( client );
+	}
+
 	// this is very ugly but it's also a waste to for instance send multiple config string updates
 	// for the same config string index in one snapshot
 	if ( !strncmp(cmd, "cs ", 3) && SV_ReplacePendingServerCommands(client, cmd) ) {
@@ -1023,6 +1030,7 @@ happen before SV_Frame is called
 void SV_Frame( int msec ) {
 	int		frameMsec;
 	int		startTime;
+	unsigned long long benchTime;
 
 	// the menu kills the server with this cvar
 	if ( sv_killserver->integer ) {
@@ -1105,6 +1113,14 @@ void SV_Frame( int msec ) {
 	// update ping based on the all received frames
 	SV_CalcPings();
 
+	// Added in OPM
+	//  split the frame time for svbench
+	if ( sv_benchRunning ) {
+		benchTime = Sys_Microseconds();
+	} else {
+		benchTime = 0;
+	}
+
 	// run the game simulation in chunks
 	while ( sv.timeResidual >= frameMsec ) {
 		sv.timeResidual -= frameMsec;
@@ -1130,12 +1146,21 @@ void SV_Frame( int msec ) {
 		time_game = Sys_Milliseconds () - startTime;
 	}
 
+	if ( sv_benchRunning ) {
+		sv_benchGameTime += Sys_Microseconds() - benchTime;
+		benchTime = Sys_Microseconds();
+	}
+
 	// check timeouts
 	SV_CheckTimeouts();
 
 	// send messages back to the clients
 	SV_SendClientMessages();
 
+	if ( sv_benchRunning ) {
+		sv_benchSnapshotTime += Sys_Microseconds() - benchTime;
+	}
+
 	// send a heartbeat to the master if needed
 	SV_MasterHeartbeat();
 
@@ -812,6 +812,33 @@ static void SV_AddEntitiesVisibleFromPoint(const vec3_t origin, clientSnapshot_t
 	}
 }
 
+/*
+=============
+Radar teams
+
+Added in OPM
+The team members and their positions are gathered once per server frame,
+each client then only scans its own team.
+=============
+*/
+#define MAX_RADAR_TEAMS 3 // every non-zero combination of EF_ANY_TEAM
+
+typedef struct {
+	int		clientNum;
+	float	x, y;
+} radarMember_t;
+
+typedef struct {
+	int				team;
+	int				numMembers;
+	radarMember_t	members[MAX_CLIENTS];
+} radarTeam_t;
+
+static radarTeam_t	sv_radarTeams[MAX_RADAR_TEAMS];
+static int			sv_numRadarTeams;
+static int			sv_radarClientTeam[MAX_CLIENTS];
+static int			sv_radarTeamsTime = -1;
+
 /*
 =============
 SV_ClearNonPVSClient
@@ -836,6 +863,8 @@ void SV_InitRadar() {
 	for (i = 0; i < svs.iNumClients; i++) {
 		SV_ClearNonPVSClient(&svs.clients[i]);
 	}
+
+	sv_radarTeamsTime = -1;
 }
 
 /*
@@ -941,6 +970,56 @@ qboolean SV_IsTeamGame() {
 	return g_gametype->integer >= GT_TEAM;
 }
 
+/*
+=============
+SV_BuildRadarTeams
+
+Puts every client that is in a team game into its team's bucket.
+=============
+*/
+static void SV_BuildRadarTeams(void) {
+	client_t* other;
+	radarTeam_t* team;
+	radarMember_t* member;
+	int teamBits;
+	int i, j;
+
+	sv_radarTeamsTime = svs.time;
+	sv_numRadarTeams = 0;
+
+	for (i = 0; i < svs.iNumClients; i++) {
+		other = &svs.clients[i];
+		sv_radarClientTeam[i] = -1;
+
+		if (!SV_InTeamGame(other)) {
+			continue;
+		}
+
+		teamBits = other->gentity->s.eFlags & EF_ANY_TEAM;
+
+		for (j = 0; j < sv_numRadarTeams; j++) {
+			if (sv_radarTeams[j].team == teamBits) {
+				break;
+			}
+		}
+
+		if (j == sv_numRadarTeams) {
+			assert(sv_numRadarTeams < MAX_RADAR_TEAMS);
+			sv_radarTeams[j].team = teamBits;
+			sv_radarTeams[j].numMembers = 0;
+			sv_numRadarTeams++;
+		}
+
+		team = &sv_radarTeams[j];
+		member = &team->members[team->numMembers++];
+		member->clientNum = i;
+		member->x = other->gentity->s.origin[0];
+		member->y = other->gentity->s.origin[1];
+
+		sv_radarClientTeam[i] = j;
+	}
+}
+
 /*
 =============
 SV_UpdateRadar
@@ -949,10 +1028,13 @@ Updates the radar information for the specified client.
 =============
 */
 void SV_UpdateRadar(client_t* client) {
-	client_t* other;
-	client_t* mate;
+	radarTeam_t* team;
+	radarMember_t* member;
+	radarMember_t* mate;
 	float deltaX, deltaY;
-	float dist;
+	float distSquared;
+	float range;
+	int clientNum;
 	int deltaTime;
 	int bestTime;
 	int i;
@@ -969,29 +1051,32 @@ void SV_UpdateRadar(client_t* client) {
 		return;
 	}
 
-	bestTime = svs.time;
+	clientNum = client - svs.clients;
 
-	for (i = 0; i < svs.iNumClients; i++) {
-		other = &svs.clients[i];
+	if (sv_radarTeamsTime != svs.time
+		|| sv_radarClientTeam[clientNum] == -1
+		|| sv_radarTeams[sv_radarClientTeam[clientNum]].team != (client->gentity->s.eFlags & EF_ANY_TEAM)) {
+		// first radar update of this frame, or the client changed team since
+		SV_BuildRadarTeams();
+	}
 
-		if (other == client) {
-			continue;
-		}
+	team = &sv_radarTeams[sv_radarClientTeam[clientNum]];
+	range = com_radar_range->value;
+	bestTime = svs.time;
 
-		if (!SV_InTeamGame(other)) {
-			continue;
-		}
+	for (i = 0; i < team->numMembers; i++) {
+		member = &team->members[i];
 
-		if (!SV_SameTeam(client, other)) {
+		if (member->clientNum == clientNum) {
 			continue;
 		}
 
-		deltaX = other->gentity->s.origin[0] - client->gentity->s.origin[0];
-		deltaY = other->gentity->s.origin[1] - client->gentity->s.origin[1];
-		deltaTime = svs.time - client->lastRadarTime[i];
-		dist = sqrt(deltaX * deltaX + deltaY * deltaY);
+		deltaX = member->x - client->gentity->s.origin[0];
+		deltaY = member->y - client->gentity->s.origin[1];
+		deltaTime = svs.time - client->lastRadarTime[member->clientNum];
+		distSquared = deltaX * deltaX + deltaY * deltaY;
 
-		if (dist > com_radar_range->value) {
+		if (range < 0 || distSquared > range * range) {
 			if (deltaTime < 1000) {
 				continue;
 			}
@@ -1000,8 +1085,8 @@ void SV_UpdateRadar(client_t* client) {
 		}
 
 		if (deltaTime > svs.time - bestTime) {
-			bestTime = client->lastRadarTime[i];
-			mate = other;
+			bestTime = client->lastRadarTime[member->clientNum];
+			mate = member;
 		}
 	}
 
@@ -1010,7 +1095,7 @@ void SV_UpdateRadar(client_t* client) {
 		return;
 	}
 
-	SV_SetNonPVSClient(client, mate);
+	SV_SetNonPVSClient(client, &svs.clients[mate->clientNum]);
 }
 
 /*
@@ -1209,6 +1294,12 @@ void SV_SendClientSnapshot( client_t *client ) {
 	byte		msg_buf[MAX_MSGLEN];
 	msg_t		msg;
 
+	// Added in OPM
+	//  send configstrings changed during this frame
+	if ( client->numCsPending ) {
+		SV_FlushConfigstrings( client );
+	}
+
 	// build the snapshot
 	SV_BuildClientSnapshot( client );
 
@@ -1297,7 +1388,9 @@ void SV_SendClientMessages(void)
 
 		rate = SV_RateMsec(c);
 
-		if(!(c->netchan.remoteAddress.type == NA_LOOPBACK ||
+		// Added in OPM
+		//  nothing is sent to clients without a connection (svbench)
+		if(!(c->netchan.remoteAddress.type == NA_LOOPBACK || c->netchan.remoteAddress.type == NA_BOT ||
 		     (sv_lanForceRate->integer && Sys_IsLANAddress(c->netchan.remoteAddress))))
 		{
 			// rate control for clients not on LAN 
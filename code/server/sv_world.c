@@ -71,6 +71,11 @@ typedef struct worldSector_s {
 worldSector_t	sv_worldSectors[AREA_NODES];
 int			sv_numworldSectors;
 
+// Added in OPM
+//  bumped each time an entity is linked or unlinked,
+//  so cached area lists can tell when they went stale
+static int	sv_linkSequence;
+
 
 /*
 ===============
@@ -150,6 +155,7 @@ void SV_ClearWorld( void ) {
 
 	Com_Memset( sv_worldSectors, 0, sizeof(sv_worldSectors) );
 	sv_numworldSectors = 0;
+	sv_linkSequence++;
 
 	// get world map bounds
 	h = CM_InlineModel( 0 );
@@ -180,6 +186,7 @@ void SV_UnlinkEntity( gentity_t *gEnt ) {
 	ent = SV_SvEntityForGentity( gEnt );
 
 	gEnt->r.linked = qfalse;
+	sv_linkSequence++;
 
 	ws = ent->worldSector;
 	if ( !ws ) {
@@ -341,6 +348,7 @@ void SV_LinkEntity( gentity_t *gEnt ) {
 	}
 
 	gEnt->r.linkcount++;
+	sv_linkSequence++;
 
 	// find the first world sector node that the ent's box crosses
 	node = sv_worldSectors;
@@ -470,6 +478,114 @@ int SV_AreaEntities( const vec3_t mins, const vec3_t maxs, int *entityList, int
 
 
 
+/*
+============================================================================
+
+TRACE SESSIONS
+
+Added in OPM.
+A burst of traces sharing the same volume, like every pellet of a shotgun
+blast, can gather the area entities once. Each trace that stays inside the
+session volume then filters the cached list instead of walking the world
+sectors again. The list is dropped as soon as any entity is linked or
+unlinked, and traces leaving the volume fall back to SV_AreaEntities.
+============================================================================
+*/
+
+typedef struct {
+	qboolean	active;
+	int			linkSequence;
+	vec3_t		mins, maxs;
+	int			numEntities;
+	int			entityList[ MAX_GENTITIES ];
+} traceSession_t;
+
+static traceSession_t sv_traceSession;
+
+/*
+================
+SV_BeginTraceSession
+================
+*/
+void SV_BeginTraceSession( const vec3_t mins, const vec3_t maxs ) {
+	int num;
+
+	sv_traceSession.active = qfalse;
+
+	num = SV_AreaEntities( mins, maxs, sv_traceSession.entityList, MAX_GENTITIES );
+	if ( num == MAX_GENTITIES ) {
+		// the list might be truncated
+		return;
+	}
+
+	VectorCopy( mins, sv_traceSession.mins );
+	VectorCopy( maxs, sv_traceSession.maxs );
+	sv_traceSession.numEntities = num;
+	sv_traceSession.linkSequence = sv_linkSequence;
+	sv_traceSession.active = qtrue;
+}
+
+/*
+================
+SV_EndTraceSession
+================
+*/
+void SV_EndTraceSession( void ) {
+	sv_traceSession.active = qfalse;
+}
+
+/*
+================
+SV_ClipAreaEntities
+
+Same as SV_AreaEntities, but served from the current
+trace session when it encloses the given bounds.
+The session list keeps the world sector order, so
+the result is the same as walking the sectors.
+================
+*/
+static int SV_ClipAreaEntities( const vec3_t mins, const vec3_t maxs, int *entityList, int maxcount ) {
+	gentity_t	*gcheck;
+	int			i;
+	int			count;
+
+	if ( !sv_traceSession.active
+		|| sv_traceSession.linkSequence != sv_linkSequence
+		|| mins[ 0 ] < sv_traceSession.mins[ 0 ]
+		|| mins[ 1 ] < sv_traceSession.mins[ 1 ]
+		|| mins[ 2 ] < sv_traceSession.mins[ 2 ]
+		|| maxs[ 0 ] > sv_traceSession.maxs[ 0 ]
+		|| maxs[ 1 ] > sv_traceSession.maxs[ 1 ]
+		|| maxs[ 2 ] > sv_traceSession.maxs[ 2 ] ) {
+		return SV_AreaEntities( mins, maxs, entityList, maxcount );
+	}
+
+	count = 0;
+
+	for ( i = 0; i < sv_traceSession.numEntities; i++ ) {
+		gcheck = SV_GentityNum( sv_traceSession.entityList[ i ] );
+
+		if( gcheck->r.absmin[ 0 ] > maxs[ 0 ]
+			|| gcheck->r.absmin[ 1 ] > maxs[ 1 ]
+			|| gcheck->r.absmin[ 2 ] > maxs[ 2 ]
+			|| gcheck->r.absmax[ 0 ] < mins[ 0 ]
+			|| gcheck->r.absmax[ 1 ] < mins[ 1 ]
+			|| gcheck->r.absmax[ 2 ] < mins[ 2 ] ) {
+			continue;
+		}
+
+		if ( count == maxcount ) {
+			Com_Printf( "SV_AreaEntities: MAXCOUNT\n" );
+			break;
+		}
+
+		entityList[ count++ ] = sv_traceSession.entityList[ i ];
+	}
+
+	return count;
+}
+
+
 //===========================================================================
 
 
@@ -535,7 +651,7 @@ static void SV_ClipMoveToEntities( moveclip_t *clip ) {
 	trace_t		trace;
 	clipHandle_t	clipHandle;
 
-	num = SV_AreaEntities( clip->boxmins, clip->boxmaxs, touchlist, MAX_GENTITIES );
+	num = SV_ClipAreaEntities( clip->boxmins, clip->boxmaxs, touchlist, MAX_GENTITIES );
 
 	if ( clip->passEntityNum != ENTITYNUM_NONE ) {
 		passOwnerNum = ( SV_GentityNum( clip->passEntityNum ) )->r.ownerNum;
@@ -625,9 +741,12 @@ static void SV_ClipMoveToEntities( moveclip_t *clip ) {
 /*
 ====================
 SV_ClipSightToEntities
+
+With concurrent set, the clip must be a point and
+nothing shared is written, see SV_SightTraceConcurrent
 ====================
 */
-qboolean SV_ClipSightToEntities( moveclip_t *clip, int passEntityNum2 )
+qboolean SV_ClipSightToEntities( moveclip_t *clip, int passEntityNum2, qboolean concurrent )
 {
 	int			i, num;
 	int			touchlist[ MAX_GENTITIES ];
@@ -636,7 +755,7 @@ qboolean SV_ClipSightToEntities( moveclip_t *clip, int passEntityNum2 )
 	int			passOwnerNum2;
 	clipHandle_t	clipHandle;
 
-	num = SV_AreaEntities( clip->boxmins, clip->boxmaxs, touchlist, MAX_GENTITIES );
+	num = SV_ClipAreaEntities( clip->boxmins, clip->boxmaxs, touchlist, MAX_GENTITIES );
 
 	if( clip->passEntityNum != ENTITYNUM_NONE ) {
 		passOwnerNum = ( SV_GentityNum( clip->passEntityNum ) )->r.ownerNum;
@@ -698,6 +817,20 @@ qboolean SV_ClipSightToEntities( moveclip_t *clip, int passEntityNum2 )
 			continue;
 		}
 
+		if( concurrent ) {
+			// the temp box model is shared, so boxes are built by the trace
+			if( touch->r.bmodel && touch->solid != SOLID_BBOX ) {
+				if( !CM_ConcurrentSightTrace( clip->start, clip->end, CM_InlineModel( touch->s.modelindex ),
+					clip->contentmask, touch->s.origin, touch->r.currentAngles ) ) {
+					return qfalse;
+				}
+			} else if( !CM_ConcurrentBoxSightTrace( clip->start, clip->end, touch->r.mins, touch->r.maxs,
+				touch->r.contents, clip->contentmask, touch->s.origin, touch->r.currentAngles ) ) {
+				return qfalse;
+			}
+			continue;
+		}
+
 		// might intersect, so do an exact clip
 		clipHandle = SV_ClipHandleForEntity( touch );
 
@@ -762,7 +895,48 @@ qboolean SV_SightTrace( const vec3_t start, const vec3_t mins, const vec3_t maxs
 	}
 
 	// clip to other solid entities
-	return SV_ClipSightToEntities( &clip, passEntityNum2 );
+	return SV_ClipSightToEntities( &clip, passEntityNum2, qfalse );
+}
+
+/*
+==================
+SV_SightTraceConcurrent
+
+Added in OPM.
+Same as SV_SightTrace with a point, but several threads can run it
+at once as long as no entity is linked, unlinked or moved meanwhile.
+Returns false if something was hit.
+==================
+*/
+qboolean SV_SightTraceConcurrent( const vec3_t start, const vec3_t end, int passEntityNum, int passEntityNum2, int contentmask ) {
+	moveclip_t clip;
+	int i;
+
+	if( !CM_ConcurrentSightTrace( start, end, 0, contentmask, vec3_origin, vec3_origin ) ) {
+		return qfalse;
+	}
+
+	clip.contentmask = contentmask;
+	clip.start = start;
+	VectorCopy( end, clip.end );
+	clip.mins = vec3_origin;
+	clip.maxs = vec3_origin;
+	clip.passEntityNum = passEntityNum;
+	clip.cylinder = qfalse;
+
+	for( i = 0; i<3; i++ ) {
+		if( end[ i ] > start[ i ] ) {
+			clip.boxmins[ i ] = clip.start[ i ] - 1;
+			clip.boxmaxs[ i ] = clip.end[ i ] + 1;
+		}
+		else {
+			clip.boxmins[ i ] = clip.end[ i ] - 1;
+			clip.boxmaxs[ i ] = clip.start[ i ] + 1;
+		}
+	}
+
+	// clip to other solid entities
+	return SV_ClipSightToEntities( &clip, passEntityNum2, qtrue );
 }
 /*
 ==================
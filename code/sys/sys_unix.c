@@ -202,6 +202,21 @@ int Sys_Milliseconds (void)
 	return curtime;
 }
 
+/*
+================
+Sys_Microseconds
+================
+*/
+unsigned long long Sys_Microseconds (void)
+{
+	struct timespec ts;
+
+	// Added in OPM
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (unsigned long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 /*
 ==================
 Sys_RandomBytes
@@ -248,6 +248,9 @@ typedef struct skelSurfaceGame_s {
     skelIndex_t              *pCollapse;
     struct skelSurfaceGame_s *pNext;
     skelIndex_t              *pCollapseIndex;
+    // Added in OPM
+    //  weights repacked by the renderer for skinning
+    struct skelPackedSurface_s *pPacked;
 
 #ifdef __cplusplus
     skelSurfaceGame_s();
@@ -351,6 +354,29 @@ typedef struct skeletorVertexGame_s {
     int    numMorphs;
 } skeletorVertexGame_t;
 
+//
+// Added in OPM
+//  Vertex weights repacked into a contiguous stream, without the morphs in between
+//
+typedef struct skelPackedWeight_s {
+    vec3_t offset;
+    float  boneWeight;
+} skelPackedWeight_t;
+
+typedef struct skelPackedVert_s {
+    vec3_t normal;
+    vec2_t texCoords;
+    int    numWeights;
+} skelPackedVert_t;
+
+typedef struct skelPackedSurface_s {
+    int                 numVerts; // 0 if the surface can't be packed
+    int                 numWeights;
+    skelPackedVert_t   *pVerts;
+    skelPackedWeight_t *pWeights;
+    int                *pBoneIndexes;
+} skelPackedSurface_t;
+
 typedef struct staticSurface_s {
     int                ident;
     int                ofsStaticData;
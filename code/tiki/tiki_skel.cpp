@@ -316,6 +316,7 @@ void TIKI_CacheFileSkel(skelHeader_t *pHeader, skelcache_t *cache, int length)
         pGameSurf->pStaticXyz       = NULL;
         pGameSurf->pStaticNormal    = NULL;
         pGameSurf->pStaticTexCoords = NULL;
+        pGameSurf->pPacked          = NULL;
         pGameSurf->pTriangles       = (skelIndex_t *)gs_ptr;
         gs_ptr += nTriBytes;
         gs_ptr            = (byte *)PADP(gs_ptr, sizeof(void *));
@@ -1005,6 +1006,9 @@ void TIKI_FreeSkelCache(skelcache_t *cache)
         if (pSurf->pStaticXyz) {
             TIKI_Free(pSurf->pStaticXyz);
         }
+        if (pSurf->pPacked) {
+            TIKI_Free(pSurf->pPacked);
+        }
     }
 
     if (cache->skel->pLOD) {
@@ -20,422 +20,539 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 ===========================================================================
 */
 
+//
+// Added in OPM
+//  Portable thread pool replacing the old WIN32/OSF/IRIX implementations.
+//  The worker threads are created once and reused by every RunThreadsOn call.
+//  RunThreadsOnIndividual splits the work into one contiguous range per
+//  thread, a thread that runs out of work steals the back half of another
+//  thread's range. Ranges are updated with compare-and-swap so handing out
+//  work never takes a lock.
+//
+
 #include "cmdlib.h"
 #include "threads.h"
 
-#define	MAX_THREADS	64
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+#endif
 
-int		dispatch;
-int		workcount;
-int		oldf;
-qboolean		pacifier;
+#define	MAX_THREADS			64
+#define	THREAD_STACK_SIZE	0x400000	// vis recursion keeps big stacks
 
-qboolean	threaded;
+int		numthreads = -1;
 
 /*
-=============
-GetThreadWork
+===================================================================
 
-=============
+ATOMICS
+
+===================================================================
 */
-int	GetThreadWork (void)
-{
-	int	r;
-	int	f;
 
-	ThreadLock ();
+typedef unsigned long long	workrange_t;
 
-	if (dispatch == workcount)
-	{
-		ThreadUnlock ();
-		return -1;
-	}
+#ifdef _MSC_VER
 
-	f = 10*dispatch / workcount;
-	if (f != oldf)
-	{
-		oldf = f;
-		if (pacifier)
-			_printf ("%i...", f);
-	}
+static workrange_t AtomicLoad64 (volatile workrange_t *p)
+{
+	return (workrange_t)InterlockedCompareExchange64 ((volatile LONG64 *)p, 0, 0);
+}
 
-	r = dispatch;
-	dispatch++;
-	ThreadUnlock ();
+static void AtomicStore64 (volatile workrange_t *p, workrange_t value)
+{
+	InterlockedExchange64 ((volatile LONG64 *)p, (LONG64)value);
+}
 
-	return r;
+static qboolean AtomicCAS64 (volatile workrange_t *p, workrange_t expected, workrange_t desired)
+{
+	return (workrange_t)InterlockedCompareExchange64 ((volatile LONG64 *)p, (LONG64)desired, (LONG64)expected) == expected;
 }
 
+static int AtomicIncrement (volatile int *p)
+{
+	return InterlockedIncrement ((volatile LONG *)p);
+}
 
-void (*workfunction) (int);
+#else
 
-void ThreadWorkerFunction (int threadnum)
+static workrange_t AtomicLoad64 (volatile workrange_t *p)
 {
-	int		work;
+	return __atomic_load_n (p, __ATOMIC_ACQUIRE);
+}
 
-	while (1)
-	{
-		work = GetThreadWork ();
-		if (work == -1)
-			break;
-//_printf ("thread %i, work %i\n", threadnum, work);
-		workfunction(work);
-	}
+static void AtomicStore64 (volatile workrange_t *p, workrange_t value)
+{
+	__atomic_store_n (p, value, __ATOMIC_RELEASE);
 }
 
-void RunThreadsOnIndividual (int workcnt, qboolean showpacifier, void(*func)(int))
+static qboolean AtomicCAS64 (volatile workrange_t *p, workrange_t expected, workrange_t desired)
 {
-	if (numthreads == -1)
-		ThreadSetDefault ();
-	workfunction = func;
-	RunThreadsOn (workcnt, showpacifier, ThreadWorkerFunction);
+	return __atomic_compare_exchange_n (p, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
 }
 
+static int AtomicIncrement (volatile int *p)
+{
+	return __atomic_add_fetch (p, 1, __ATOMIC_ACQ_REL);
+}
+
+#endif
 
 /*
 ===================================================================
 
-WIN32
+WORK RANGES
 
 ===================================================================
 */
-#ifdef WIN32
-
-#define	USED
-
-#include <windows.h>
-
-int		numthreads = -1;
-CRITICAL_SECTION		crit;
-static int enter;
 
-void ThreadSetDefault (void)
+//
+// Low 32 bits: next item, high 32 bits: end of the range.
+// Padded so that two threads never share a cache line.
+//
+typedef struct
 {
-	SYSTEM_INFO info;
+	volatile workrange_t	range;
+	char					pad[64 - sizeof(workrange_t)];
+} threadrange_t;
 
-	if (numthreads == -1)	// not set manually
-	{
-		GetSystemInfo (&info);
-		numthreads = info.dwNumberOfProcessors;
-		if (numthreads < 1 || numthreads > 32)
-			numthreads = 1;
-	}
+static threadrange_t	ranges[MAX_THREADS];
+static int				numranges;
 
-	qprintf ("%i threads\n", numthreads);
-}
+static volatile int		dispatch;
+static volatile int		workdone;
+static int				workcount;
+static qboolean			pacifier;
+static qboolean			threaded;
 
+#define	RANGE_NEXT(r)	((int)((r) & 0xffffffff))
+#define	RANGE_END(r)	((int)((r) >> 32))
 
-void ThreadLock (void)
+static workrange_t MakeRange (int next, int end)
 {
-	if (!threaded)
-		return;
-	EnterCriticalSection (&crit);
-	if (enter)
-		Error ("Recursive ThreadLock\n");
-	enter = 1;
+	return ((workrange_t)(unsigned int)end << 32) | (unsigned int)next;
 }
 
-void ThreadUnlock (void)
+/*
+=============
+TakeWork
+
+Pops the next item from the front of the thread's own range
+=============
+*/
+static int TakeWork (threadrange_t *own)
 {
-	if (!threaded)
-		return;
-	if (!enter)
-		Error ("ThreadUnlock without lock\n");
-	enter = 0;
-	LeaveCriticalSection (&crit);
+	workrange_t	r;
+	int			next, end;
+
+	while (1)
+	{
+		r = AtomicLoad64 (&own->range);
+		next = RANGE_NEXT(r);
+		end = RANGE_END(r);
+		if (next >= end)
+			return -1;
+		if (AtomicCAS64 (&own->range, r, MakeRange (next + 1, end)))
+			return next;
+	}
 }
 
 /*
 =============
-RunThreadsOn
+StealWork
+
+Moves the back half of another thread's range into the (empty) range
+of the calling thread. The front item always stays with the owner, so
+a range only becomes empty through its owner and can never come back
+to a value another thread has already read.
 =============
 */
-void RunThreadsOn (int workcnt, qboolean showpacifier, void(*func)(int))
+static qboolean StealWork (int threadnum)
 {
-	int		threadid[MAX_THREADS];
-	HANDLE	threadhandle[MAX_THREADS];
-	int		i;
-	int		start, end;
+	threadrange_t	*victim;
+	workrange_t		r;
+	int				i;
+	int				next, end, split;
 
-	start = I_FloatTime ();
-	dispatch = 0;
-	workcount = workcnt;
-	oldf = -1;
-	pacifier = showpacifier;
-	threaded = qtrue;
-
-	//
-	// run threads in parallel
-	//
-	InitializeCriticalSection (&crit);
-
-	if (numthreads == 1)
-	{	// use same thread
-		func (0);
-	}
-	else
+	for (i = 1; i < numranges; i++)
 	{
-		for (i=0 ; i<numthreads ; i++)
+		victim = &ranges[(threadnum + i) % numranges];
+
+		while (1)
 		{
-			threadhandle[i] = CreateThread(
-			   NULL,	// LPSECURITY_ATTRIBUTES lpsa,
-			   0,		// DWORD cbStack,
-			   (LPTHREAD_START_ROUTINE)func,	// LPTHREAD_START_ROUTINE lpStartAddr,
-			   (LPVOID)i,	// LPVOID lpvThreadParm,
-			   0,			//   DWORD fdwCreate,
-			   &threadid[i]);
+			r = AtomicLoad64 (&victim->range);
+			next = RANGE_NEXT(r);
+			end = RANGE_END(r);
+			if (end - next < 2)
+				break;
+
+			split = next + (end - next + 1) / 2;
+			if (AtomicCAS64 (&victim->range, r, MakeRange (next, split)))
+			{
+				AtomicStore64 (&ranges[threadnum].range, MakeRange (split, end));
+				return qtrue;
+			}
 		}
-
-		for (i=0 ; i<numthreads ; i++)
-			WaitForSingleObject (threadhandle[i], INFINITE);
 	}
-	DeleteCriticalSection (&crit);
 
-	threaded = qfalse;
-	end = I_FloatTime ();
-	if (pacifier)
-		_printf (" (%i)\n", end-start);
+	return qfalse;
 }
 
+/*
+=============
+WorkFinished
 
-#endif
+Prints the pacifier when the finished item crosses a tenth of the work
+=============
+*/
+static void WorkFinished (void)
+{
+	int	done;
+	int	f;
 
-/*
-===================================================================
+	if (!pacifier)
+		return;
 
-OSF1
+	done = AtomicIncrement (&workdone);
+	f = 10 * (done - 1) / workcount;
+	if (done == 1 || f != 10 * (done - 2) / workcount)
+		_printf ("%i...", f);
+}
 
-===================================================================
+/*
+=============
+GetThreadWork
+
+Shared counter for functions run with RunThreadsOn directly
+=============
 */
+int	GetThreadWork (void)
+{
+	int	r;
 
-#ifdef __osf__
-#define	USED
+	if (dispatch >= workcount)
+		return -1;
 
-int		numthreads = 4;
+	r = AtomicIncrement (&dispatch) - 1;
+	if (r >= workcount)
+		return -1;
 
-void ThreadSetDefault (void)
-{
-	if (numthreads == -1)	// not set manually
-	{
-		numthreads = 4;
-	}
+	WorkFinished ();
+	return r;
 }
 
 
-#include <pthread.h>
-
-pthread_mutex_t	*my_mutex;
+void (*workfunction) (int);
 
-void ThreadLock (void)
+void ThreadWorkerFunction (int threadnum)
 {
-	if (my_mutex)
-		pthread_mutex_lock (my_mutex);
-}
+	int		work;
 
-void ThreadUnlock (void)
-{
-	if (my_mutex)
-		pthread_mutex_unlock (my_mutex);
+	while (1)
+	{
+		work = TakeWork (&ranges[threadnum]);
+		if (work == -1)
+		{
+			if (!StealWork (threadnum))
+				break;
+			continue;
+		}
+//_printf ("thread %i, work %i\n", threadnum, work);
+		workfunction(work);
+		WorkFinished ();
+	}
 }
 
-
 /*
 =============
-RunThreadsOn
+RunThreadsOnIndividual
+
+Each item must only write its own results, the output then doesn't
+depend on the number of threads or on which thread ran the item
 =============
 */
-void RunThreadsOn (int workcnt, qboolean showpacifier, void(*func)(int))
+void RunThreadsOnIndividual (int workcnt, qboolean showpacifier, void(*func)(int))
 {
 	int		i;
-	pthread_t	work_threads[MAX_THREADS];
-	pthread_addr_t	status;
-	pthread_attr_t	attrib;
-	pthread_mutexattr_t	mattrib;
-	int		start, end;
-
-	start = I_FloatTime ();
-	dispatch = 0;
-	workcount = workcnt;
-	oldf = -1;
-	pacifier = showpacifier;
-	threaded = qtrue;
 
-	if (pacifier)
-		setbuf (stdout, NULL);
+	if (numthreads == -1)
+		ThreadSetDefault ();
 
-	if (!my_mutex)
-	{
-		my_mutex = malloc (sizeof(*my_mutex));
-		if (pthread_mutexattr_create (&mattrib) == -1)
-			Error ("pthread_mutex_attr_create failed");
-		if (pthread_mutexattr_setkind_np (&mattrib, MUTEX_FAST_NP) == -1)
-			Error ("pthread_mutexattr_setkind_np failed");
-		if (pthread_mutex_init (my_mutex, mattrib) == -1)
-			Error ("pthread_mutex_init failed");
-	}
+	numranges = numthreads;
+	if (numranges > workcnt)
+		numranges = workcnt > 0 ? workcnt : 1;
 
-	if (pthread_attr_create (&attrib) == -1)
-		Error ("pthread_attr_create failed");
-	if (pthread_attr_setstacksize (&attrib, 0x100000) == -1)
-		Error ("pthread_attr_setstacksize failed");
-	
-	for (i=0 ; i<numthreads ; i++)
-	{
-  		if (pthread_create(&work_threads[i], attrib
-		, (pthread_startroutine_t)func, (pthread_addr_t)i) == -1)
-			Error ("pthread_create failed");
-	}
-		
-	for (i=0 ; i<numthreads ; i++)
+	for (i = 0; i < numranges; i++)
 	{
-		if (pthread_join (work_threads[i], &status) == -1)
-			Error ("pthread_join failed");
+		AtomicStore64 (&ranges[i].range, MakeRange (
+			(int)((long long)workcnt * i / numranges),
+			(int)((long long)workcnt * (i + 1) / numranges)));
 	}
 
-	threaded = qfalse;
-
-	end = I_FloatTime ();
-	if (pacifier)
-		_printf (" (%i)\n", end-start);
+	workfunction = func;
+	RunThreadsOn (workcnt, showpacifier, ThreadWorkerFunction);
 }
 
-
-#endif
-
 /*
 ===================================================================
 
-IRIX
+THREAD POOL
 
 ===================================================================
 */
 
-#ifdef _MIPS_ISA 
-#define	USED
+static void		(*poolfunction) (int);
+static int		poolthreads;		// helper threads, thread 0 is the caller
+static int		pooljobs;			// threads that should run the current job
+static int		poolgeneration;
+static int		poolbusy;
+static int		threadgeneration[MAX_THREADS];	// generation a helper was created in
 
-#include <task.h>
-#include <abi_mutex.h>
-#include <sys/types.h>
-#include <sys/prctl.h>
+#ifdef WIN32
 
+static CRITICAL_SECTION		poolcrit;
+static CONDITION_VARIABLE	poolstart;
+static CONDITION_VARIABLE	pooldone;
+static CRITICAL_SECTION		crit;
+static int					enter;
 
-int		numthreads = -1;
-abilock_t		lck;
+#define	PoolLock()		EnterCriticalSection (&poolcrit)
+#define	PoolUnlock()	LeaveCriticalSection (&poolcrit)
+#define	PoolWait(c)		SleepConditionVariableCS (&(c), &poolcrit, INFINITE)
+#define	PoolWakeAll(c)	WakeAllConditionVariable (&(c))
+#define	PoolWake(c)		WakeConditionVariable (&(c))
 
-void ThreadSetDefault (void)
+#else
+
+static pthread_mutex_t		poolmutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t		poolstart = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t		pooldone = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t		my_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+#define	PoolLock()		pthread_mutex_lock (&poolmutex)
+#define	PoolUnlock()	pthread_mutex_unlock (&poolmutex)
+#define	PoolWait(c)		pthread_cond_wait (&(c), &poolmutex)
+#define	PoolWakeAll(c)	pthread_cond_broadcast (&(c))
+#define	PoolWake(c)		pthread_cond_signal (&(c))
+
+#endif
+
+/*
+=============
+PoolThread
+
+Waits for a new job generation and runs it
+=============
+*/
+static void PoolThread (int threadnum)
 {
-	if (numthreads == -1)
-		numthreads = prctl(PR_MAXPPROCS);
-	_printf ("%i threads\n", numthreads);
-	usconfig (CONF_INITUSERS, numthreads);
+	int		generation;
+
+	PoolLock ();
+	generation = threadgeneration[threadnum];
+	PoolUnlock ();
+
+	while (1)
+	{
+		PoolLock ();
+		while (poolgeneration == generation || threadnum >= pooljobs)
+		{
+			generation = poolgeneration;
+			PoolWait (poolstart);
+		}
+		generation = poolgeneration;
+		PoolUnlock ();
+
+		poolfunction (threadnum);
+
+		PoolLock ();
+		if (--poolbusy == 0)
+			PoolWake (pooldone);
+		PoolUnlock ();
+	}
 }
 
+#ifdef WIN32
 
-void ThreadLock (void)
+static DWORD WINAPI PoolThreadEntry (LPVOID param)
 {
-	spin_lock (&lck);
+	PoolThread ((int)(INT_PTR)param);
+	return 0;
 }
 
-void ThreadUnlock (void)
+#else
+
+static void *PoolThreadEntry (void *param)
 {
-	release_lock (&lck);
+	PoolThread ((int)(intptr_t)param);
+	return NULL;
 }
 
+#endif
 
 /*
 =============
-RunThreadsOn
+StartPoolThreads
+
+Creates the helper threads the first time they are needed
 =============
 */
-void RunThreadsOn (int workcnt, qboolean showpacifier, void(*func)(int))
+static void StartPoolThreads (int count)
 {
 	int		i;
-	int		pid[MAX_THREADS];
-	int		start, end;
+#ifdef WIN32
+	HANDLE	handle;
 
-	start = I_FloatTime ();
-	dispatch = 0;
-	workcount = workcnt;
-	oldf = -1;
-	pacifier = showpacifier;
-	threaded = qtrue;
+	if (!poolthreads)
+	{
+		InitializeCriticalSection (&poolcrit);
+		InitializeConditionVariable (&poolstart);
+		InitializeConditionVariable (&pooldone);
+		InitializeCriticalSection (&crit);
+	}
 
-	if (pacifier)
-		setbuf (stdout, NULL);
+	for (i = poolthreads + 1; i < count; i++)
+	{
+		threadgeneration[i] = poolgeneration;
+		handle = CreateThread (NULL, THREAD_STACK_SIZE, PoolThreadEntry, (LPVOID)(INT_PTR)i,
+			STACK_SIZE_PARAM_IS_A_RESERVATION, NULL);
+		if (!handle)
+			Error ("CreateThread failed");
+		CloseHandle (handle);
+	}
+#else
+	pthread_t		thread;
+	pthread_attr_t	attrib;
 
-	init_lock (&lck);
+	if (pthread_attr_init (&attrib))
+		Error ("pthread_attr_init failed");
+	if (pthread_attr_setstacksize (&attrib, THREAD_STACK_SIZE))
+		Error ("pthread_attr_setstacksize failed");
+	pthread_attr_setdetachstate (&attrib, PTHREAD_CREATE_DETACHED);
 
-	for (i=0 ; i<numthreads-1 ; i++)
+	for (i = poolthreads + 1; i < count; i++)
 	{
-		pid[i] = sprocsp ( (void (*)(void *, size_t))func, PR_SALL, (void *)i
-			, NULL, 0x200000);		// 2 meg stacks
-		if (pid[i] == -1)
-		{
-			perror ("sproc");
-			Error ("sproc failed");
-		}
+		threadgeneration[i] = poolgeneration;
+		if (pthread_create (&thread, &attrib, PoolThreadEntry, (void *)(intptr_t)i))
+			Error ("pthread_create failed");
 	}
-		
-	func(i);
-			
-	for (i=0 ; i<numthreads-1 ; i++)
-		wait (NULL);
 
-	threaded = qfalse;
+	pthread_attr_destroy (&attrib);
+#endif
 
-	end = I_FloatTime ();
-	if (pacifier)
-		_printf (" (%i)\n", end-start);
+	if (count - 1 > poolthreads)
+		poolthreads = count - 1;
 }
 
+void ThreadSetDefault (void)
+{
+	if (numthreads == -1)	// not set manually
+	{
+#ifdef WIN32
+		SYSTEM_INFO info;
 
+		GetSystemInfo (&info);
+		numthreads = info.dwNumberOfProcessors;
+#else
+		numthreads = (int)sysconf (_SC_NPROCESSORS_ONLN);
 #endif
+	}
 
-/*
-=======================================================================
-
-  SINGLE THREAD
-
-=======================================================================
-*/
-
-#ifndef USED
-
-int		numthreads = 1;
+	if (numthreads < 1)
+		numthreads = 1;
+	if (numthreads > MAX_THREADS)
+		numthreads = MAX_THREADS;
 
-void ThreadSetDefault (void)
-{
-	numthreads = 1;
+	qprintf ("%i threads\n", numthreads);
 }
 
+
 void ThreadLock (void)
 {
+	if (!threaded)
+		return;
+#ifdef WIN32
+	EnterCriticalSection (&crit);
+	if (enter)
+		Error ("Recursive ThreadLock\n");
+	enter = 1;
+#else
+	pthread_mutex_lock (&my_mutex);
+#endif
 }
 
 void ThreadUnlock (void)
 {
+	if (!threaded)
+		return;
+#ifdef WIN32
+	if (!enter)
+		Error ("ThreadUnlock without lock\n");
+	enter = 0;
+	LeaveCriticalSection (&crit);
+#else
+	pthread_mutex_unlock (&my_mutex);
+#endif
 }
 
 /*
 =============
 RunThreadsOn
+
+Runs func on every thread, the calling thread is thread 0
 =============
 */
 void RunThreadsOn (int workcnt, qboolean showpacifier, void(*func)(int))
 {
-	int		i;
+	int		count;
 	int		start, end;
 
+	if (numthreads == -1)
+		ThreadSetDefault ();
+
+	start = I_FloatTime ();
 	dispatch = 0;
+	workdone = 0;
 	workcount = workcnt;
-	oldf = -1;
 	pacifier = showpacifier;
-	start = I_FloatTime (); 
-	func(0);
+
+	count = numthreads;
+	if (func == ThreadWorkerFunction)
+		count = numranges;	// no point waking threads without a range
+	if (count > 1 && workcnt > 1)
+	{
+		StartPoolThreads (count);
+
+		threaded = qtrue;
+
+		PoolLock ();
+		poolfunction = func;
+		pooljobs = count;
+		poolbusy = count - 1;
+		poolgeneration++;
+		PoolWakeAll (poolstart);
+		PoolUnlock ();
+
+		func (0);
+
+		PoolLock ();
+		while (poolbusy)
+			PoolWait (pooldone);
+		PoolUnlock ();
+
+		threaded = qfalse;
+	}
+	else
+	{
+		// use same thread
+		func (0);
+	}
 
 	end = I_FloatTime ();
 	if (pacifier)
 		_printf (" (%i)\n", end-start);
 }
-
-#endif